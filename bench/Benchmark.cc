@@ -0,0 +1,97 @@
+
+# include "Benchmark.hh"
+# include <new>
+# include <atomic>
+# include <chrono>
+# include <cstdlib>
+
+namespace {
+
+  /// @brief - The number of calls to the global allocation
+  /// function.
+  std::atomic<std::uint64_t> g_allocations(0u);
+
+}
+
+// Replace the global allocation functions so that the heap
+// allocations performed by the benchmarks can be counted. The
+// array and non-throwing versions call these ones.
+void*
+operator new(std::size_t size) {
+  g_allocations.fetch_add(1u, std::memory_order_relaxed);
+
+  void* p = std::malloc(size == 0u ? 1u : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return p;
+}
+
+void
+operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t /*size*/) noexcept {
+  std::free(p);
+}
+
+namespace cellify {
+  namespace bench {
+
+    std::uint64_t
+    allocations() noexcept {
+      return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    Result
+    run(const std::string& name, Process process, Setup setup) {
+      using Clock = std::chrono::steady_clock;
+
+      if (setup) {
+        setup();
+      }
+
+      std::uint64_t allocs = allocations();
+      Clock::time_point start = Clock::now();
+      unsigned ops = process();
+      Clock::time_point end = Clock::now();
+      allocs = allocations() - allocs;
+
+      std::chrono::duration<double, std::milli> d = end - start;
+
+      return Result{name, ops, d.count(), allocs};
+    }
+
+    void
+    printHeader(std::ostream& out) {
+      out << "benchmark,operations,elapsed_ms,ns_per_op,ops_per_sec,allocs_per_op" << std::endl;
+    }
+
+    void
+    print(std::ostream& out, const Result& res) {
+      double nsPerOp = 0.0;
+      double opsPerSec = 0.0;
+      double allocsPerOp = 0.0;
+
+      if (res.operations > 0u) {
+        nsPerOp = 1000000.0 * res.elapsed / res.operations;
+        allocsPerOp = 1.0 * res.allocations / res.operations;
+      }
+      if (res.elapsed > 0.0) {
+        opsPerSec = 1000.0 * res.operations / res.elapsed;
+      }
+
+      out << res.name << ","
+          << res.operations << ","
+          << res.elapsed << ","
+          << nsPerOp << ","
+          << opsPerSec << ","
+          << allocsPerOp
+          << std::endl;
+    }
+
+  }
+}
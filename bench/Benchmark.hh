@@ -0,0 +1,80 @@
+#ifndef    BENCHMARK_HH
+# define   BENCHMARK_HH
+
+# include <string>
+# include <cstdint>
+# include <functional>
+# include <iostream>
+
+namespace cellify {
+  namespace bench {
+
+    /// @brief - The process to measure: it returns the number
+    /// of operations that were performed during the run so
+    /// that a throughput can be computed.
+    using Process = std::function<unsigned()>;
+
+    /// @brief - A preparation step run before a benchmark and
+    /// excluded from the measure.
+    using Setup = std::function<void()>;
+
+    /// @brief - The result of a single benchmark.
+    struct Result {
+      // The name of the benchmark.
+      std::string name;
+
+      // The number of operations performed.
+      unsigned operations;
+
+      // The duration of the run in milliseconds.
+      double elapsed;
+
+      // The number of heap allocations performed during the
+      // run.
+      std::uint64_t allocations;
+    };
+
+    /**
+     * @brief - The number of heap allocations performed by the
+     *          process so far, by any thread. The benchmarks are
+     *          linked with an allocator which counts them.
+     * @return - the number of allocations.
+     */
+    std::uint64_t
+    allocations() noexcept;
+
+    /**
+     * @brief - Run the input process and measure the time it
+     *          takes to complete.
+     * @param name - the name of the benchmark.
+     * @param process - the process to measure.
+     * @param setup - an optional preparation step, which is not
+     *                included in the measure.
+     * @return - the result of the benchmark.
+     */
+    Result
+    run(const std::string& name, Process process, Setup setup = nullptr);
+
+    /**
+     * @brief - Print the header of the results in a machine
+     *          readable (CSV) format.
+     * @param out - the stream to print to.
+     */
+    void
+    printHeader(std::ostream& out);
+
+    /**
+     * @brief - Print the result as a line of CSV to the input
+     *          stream: it includes the throughput in number of
+     *          operations per second and the number of heap
+     *          allocations per operation.
+     * @param out - the stream to print to.
+     * @param res - the result to print.
+     */
+    void
+    print(std::ostream& out, const Result& res);
+
+  }
+}
+
+#endif    /* BENCHMARK_HH */
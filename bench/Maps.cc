@@ -0,0 +1,105 @@
+
+# include "Maps.hh"
+
+namespace cellify {
+  namespace bench {
+
+    Map::Map(int half):
+      m_half(half),
+      m_obstacles((2 * half + 1) * (2 * half + 1), false)
+    {}
+
+    utils::Point2i
+    Map::start() const noexcept {
+      return utils::Point2i(-m_half, -m_half);
+    }
+
+    utils::Point2i
+    Map::end() const noexcept {
+      return utils::Point2i(m_half, m_half);
+    }
+
+    void
+    Map::block(int x, int y) noexcept {
+      if (x < -m_half || x > m_half || y < -m_half || y > m_half) {
+        return;
+      }
+
+      m_obstacles[(y + m_half) * (2 * m_half + 1) + x + m_half] = true;
+    }
+
+    bool
+    Map::obstructed(const utils::Point2i& p,
+                    bool /*includeNonSolid*/) const noexcept
+    {
+      int x = p.x();
+      int y = p.y();
+
+      if (x < -m_half || x > m_half || y < -m_half || y > m_half) {
+        return true;
+      }
+
+      return m_obstacles[(y + m_half) * (2 * m_half + 1) + x + m_half];
+    }
+
+    std::vector<int>
+    Map::visible(const utils::Point2i& /*p*/,
+                 float /*d*/) const noexcept
+    {
+      return std::vector<int>();
+    }
+
+    unsigned
+    Map::visible(const VisibilityQuery& /*query*/,
+                 std::vector<int>& out) const noexcept
+    {
+      out.clear();
+      return 0u;
+    }
+
+    const void*
+    Map::get(unsigned /*id*/) const noexcept {
+      return nullptr;
+    }
+
+    Map
+    newOpenMap(int half) {
+      return Map(half);
+    }
+
+    Map
+    newMazeMap(int half) {
+      Map m(half);
+
+      // Walls every other column, leaving a gap at the top
+      // or at the bottom alternatively.
+      bool top = true;
+      for (int x = -half + 1 ; x < half ; x += 2) {
+        int yMin = (top ? -half : -half + 1);
+        int yMax = (top ? half - 1 : half);
+
+        for (int y = yMin ; y <= yMax ; ++y) {
+          m.block(x, y);
+        }
+
+        top = !top;
+      }
+
+      return m;
+    }
+
+    Map
+    newUnreachableMap(int half) {
+      Map m(half);
+
+      // Enclose the top right corner.
+      for (int c = half - 2 ; c <= half ; ++c) {
+        m.block(half - 2, c);
+        m.block(c, half - 2);
+      }
+
+      return m;
+    }
+
+  }
+}
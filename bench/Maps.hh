@@ -0,0 +1,135 @@
+#ifndef    MAPS_HH
+# define   MAPS_HH
+
+# include <vector>
+# include <maths_utils/Point2.hh>
+# include "Locator.hh"
+
+namespace cellify {
+  namespace bench {
+
+    /// @brief - A square map of obstacles used to measure the
+    /// path finding independently of the grid: obstruction is
+    /// answered in constant time. Cells outside of the map are
+    /// considered obstructed.
+    class Map: public Locator {
+      public:
+
+        /**
+         * @brief - Create an empty map spanning the range
+         *          `[-half; half]` along both axes.
+         * @param half - the half size of the map.
+         */
+        explicit
+        Map(int half);
+
+        /**
+         * @brief - Returns the start of the paths to compute.
+         * @return - the bottom left corner of the map.
+         */
+        utils::Point2i
+        start() const noexcept;
+
+        /**
+         * @brief - Returns the end of the paths to compute.
+         * @return - the top right corner of the map.
+         */
+        utils::Point2i
+        end() const noexcept;
+
+        /**
+         * @brief - Mark the input cell as an obstacle.
+         * @param x - the abscissa of the cell.
+         * @param y - the ordinate of the cell.
+         */
+        void
+        block(int x, int y) noexcept;
+
+        /**
+         * @brief - Implementation of the interface method.
+         * @param p - the coordinates to check for obstruction.
+         * @param includeNonSolid - unused.
+         * @return - `true` if the location is an obstacle or
+         *           is outside of the map.
+         */
+        bool
+        obstructed(const utils::Point2i& p,
+                   bool includeNonSolid = false) const noexcept override;
+
+        /**
+         * @brief - Implementation of the interface method: the
+         *          map does not contain any item.
+         * @param p - the position to consider.
+         * @param d - the radius around the position.
+         * @return - an empty list.
+         */
+        std::vector<int>
+        visible(const utils::Point2i& p,
+                float d) const noexcept override;
+
+        /**
+         * @brief - Implementation of the interface method: the
+         *          map does not contain any item.
+         * @param query - the description of the items to find.
+         * @param out - output list, cleared.
+         * @return - always `0`.
+         */
+        unsigned
+        visible(const VisibilityQuery& query,
+                std::vector<int>& out) const noexcept override;
+
+        /**
+         * @brief - Implementation of the interface method.
+         * @param id - the index of the element to fetch.
+         * @return - always null.
+         */
+        const void*
+        get(unsigned id) const noexcept override;
+
+      private:
+
+        /**
+         * @brief - The half size of the map.
+         */
+        int m_half;
+
+        /**
+         * @brief - Whether each cell is an obstacle, stored in
+         *          rows.
+         */
+        std::vector<bool> m_obstacles;
+    };
+
+    /**
+     * @brief - Generate a map without any obstacle.
+     * @param half - the half size of the map.
+     * @return - the generated map.
+     */
+    Map
+    newOpenMap(int half);
+
+    /**
+     * @brief - Generate a map with vertical walls alternatively
+     *          opened at the top and at the bottom: the path
+     *          from the start to the end goes through all the
+     *          corridors.
+     * @param half - the half size of the map.
+     * @return - the generated map.
+     */
+    Map
+    newMazeMap(int half);
+
+    /**
+     * @brief - Generate a map where the end is enclosed in a
+     *          ring of obstacles: the path finding explores the
+     *          whole map before failing.
+     * @param half - the half size of the map.
+     * @return - the generated map.
+     */
+    Map
+    newUnreachableMap(int half);
+
+  }
+}
+
+#endif    /* MAPS_HH */
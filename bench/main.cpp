@@ -0,0 +1,514 @@
+
+/**
+ * @brief - Benchmarks of the simulation, run without any
+ *          rendering. Results are printed as CSV on the
+ *          standard output so that they can be compared
+ *          between commits. An optional `--filter=text`
+ *          argument restricts the benchmarks to the ones
+ *          whose name contains the text.
+ */
+
+# include <cmath>
+# include <cstdio>
+# include <algorithm>
+# include <core_utils/CoreException.hh>
+# include <core_utils/RNG.hh>
+# include "World.hh"
+# include "Ant.hh"
+# include "Pheromon.hh"
+# include "AStar.hh"
+# include "Logging.hh"
+# include "Benchmark.hh"
+# include "Maps.hh"
+# include "Scenario.hh"
+# include "TopViewFrame.hh"
+
+/// @brief - The seed used for all the random processes of
+/// the benchmarks so that runs are reproducible.
+# define BENCH_SEED 2023
+
+/// @brief - The number of ticks simulated by the benchmark
+/// measuring the cost of logging.
+# define WORLD_TICKS 2000u
+
+/// @brief - The duration of a single tick in seconds.
+# define TICK_DURATION 0.1f
+
+/// @brief - The number of elements registered in the grid
+/// for the queries benchmarks.
+# define GRID_ELEMENTS 10000u
+
+/// @brief - The number of queries performed on the grid.
+# define GRID_QUERIES 2000u
+
+/// @brief - The radius of the visibility queries.
+# define VISIBILITY_RADIUS 5.0f
+
+/// @brief - The number of pheromons spawned and merged.
+# define MERGED_PHEROMONS 1000u
+
+/// @brief - The half size of the maps for path finding.
+# define MAP_HALF_SIZE 32
+
+/// @brief - The number of paths computed on each map.
+# define PATHS_COUNT 20u
+
+/// @brief - The number of steps of a single ant.
+# define ANT_STEPS 10000u
+
+/// @brief - The number of elements of the world saved and
+/// restored by the snapshot benchmarks.
+# define SNAPSHOT_ELEMENTS 1000000u
+
+/// @brief - The file used by the snapshot benchmarks.
+# define SNAPSHOT_FILE "bench.snap"
+
+/// @brief - The file used by the checkpoint benchmark.
+# define CHECKPOINT_FILE "bench.ckpt"
+
+/// @brief - The file used by the trajectory benchmark.
+# define TRAJECTORY_FILE "bench.traj"
+
+/// @brief - The total number of element updates of the
+/// macro benchmarks: the number of ticks is derived from
+/// it so that each size takes a comparable time.
+# define WORLD_UPDATES 100000u
+
+/// @brief - The number of tiles converted to pixels by the
+/// coordinate frame benchmarks.
+# define FRAME_TILES 100000u
+
+/// @brief - The number of elements of the world stepped by
+/// the steady state benchmark.
+# define STEADY_ELEMENTS 10000u
+
+/// @brief - The number of ticks simulated before measuring
+/// the steady state of the world, so that the buffers reused
+/// from one tick to the next reach their final size.
+# define STEADY_WARMUP 20u
+
+/// @brief - The number of ticks measured by the steady state
+/// benchmark.
+# define STEADY_TICKS 20u
+
+/// @brief - The number of heap allocations per tick recorded
+/// for the steady state benchmark: they come from the pheromons
+/// spawned by the ants. The benchmarks fail if a tick allocates
+/// more than this.
+# define STEADY_ALLOCATIONS 66.0
+
+namespace {
+
+  /// @brief - A benchmark to run.
+  struct Case {
+    // The name of the benchmark.
+    std::string name;
+
+    // The process to measure.
+    cellify::bench::Process process;
+
+    // The preparation of the benchmark, if any.
+    cellify::bench::Setup setup;
+
+    // The maximum number of heap allocations per operation, or
+    // a negative value if they are not checked.
+    double maxAllocations = -1.0;
+  };
+
+  /**
+   * @brief - Describe a scenario with roughly the input number
+   *          of elements: one percent of ants, five percent of
+   *          walls and the rest as pheromons. Elements are put
+   *          on an area with about four cells per element.
+   * @param count - the number of elements to generate.
+   * @return - the description of the scenario.
+   */
+  cellify::ScenarioDesc
+  scenarioOfSize(unsigned count) {
+    int half = static_cast<int>(std::sqrt(1.0f * count));
+    cellify::ScenarioDesc sd = cellify::newScenarioDesc(BENCH_SEED, half);
+
+    sd.colonies = std::max(1u, count / 10000u);
+    sd.obstacles = 0.0125f;
+    sd.ants = count / 100u;
+    sd.pheromons = count - sd.ants - count / 20u;
+
+    return sd;
+  }
+
+  /**
+   * @brief - The parameters of the simulation matching the
+   *          scenario with the input number of elements: one
+   *          food deposit every thousand elements.
+   * @param count - the number of elements to generate.
+   * @return - the parameters of the simulation.
+   */
+  cellify::SimulationParams
+  paramsOfSize(unsigned count) {
+    cellify::SimulationParams params = cellify::newSimulationParams();
+    params.foodDepositsCount = std::max(4u, count / 1000u);
+
+    return params;
+  }
+
+  unsigned
+  stepWorld() {
+    cellify::World w;
+    w.resume();
+
+    for (unsigned id = 0u ; id < WORLD_TICKS ; ++id) {
+      w.step(TICK_DURATION);
+    }
+
+    return WORLD_TICKS;
+  }
+
+  unsigned
+  gridAt() {
+    utils::RNG rng(BENCH_SEED);
+    cellify::Scenario sc(scenarioOfSize(GRID_ELEMENTS), paramsOfSize(GRID_ELEMENTS));
+    cellify::Grid g(sc.generate());
+
+    int half = static_cast<int>(std::sqrt(1.0f * GRID_ELEMENTS));
+
+    for (unsigned id = 0u ; id < GRID_QUERIES ; ++id) {
+      g.at(rng.rndInt(-half, half), rng.rndInt(-half, half), true);
+    }
+
+    return GRID_QUERIES;
+  }
+
+  unsigned
+  gridVisible() {
+    utils::RNG rng(BENCH_SEED);
+    cellify::Scenario sc(scenarioOfSize(GRID_ELEMENTS), paramsOfSize(GRID_ELEMENTS));
+    cellify::Grid g(sc.generate());
+
+    int half = static_cast<int>(std::sqrt(1.0f * GRID_ELEMENTS));
+
+    for (unsigned id = 0u ; id < GRID_QUERIES ; ++id) {
+      utils::Point2i p(rng.rndInt(-half, half), rng.rndInt(-half, half));
+      g.visible(p, VISIBILITY_RADIUS);
+    }
+
+    return GRID_QUERIES;
+  }
+
+  unsigned
+  gridSpawnMerge() {
+    utils::RNG rng(BENCH_SEED);
+    cellify::Grid g(rng);
+
+    // Spawn pheromons twice at the same positions with the
+    // same scent: the second batch is merged.
+    std::vector<utils::Point2i> positions;
+    for (unsigned id = 0u ; id < MERGED_PHEROMONS ; ++id) {
+      positions.push_back(utils::Point2i(rng.rndInt(-50, 50), rng.rndInt(-50, 50)));
+    }
+
+    for (unsigned pass = 0u ; pass < 2u ; ++pass) {
+      for (unsigned id = 0u ; id < positions.size() ; ++id) {
+        g.spawn(cellify::newElement(
+          positions[id],
+          std::make_shared<cellify::Pheromon>(cellify::Scent::Food, 0.0f, 1.0f, 0.01f)
+        ));
+      }
+    }
+
+    return 2u * MERGED_PHEROMONS;
+  }
+
+  unsigned
+  findPaths(const cellify::bench::Map& map) {
+    cellify::Path path;
+
+    for (unsigned id = 0u ; id < PATHS_COUNT ; ++id) {
+      cellify::AStar astar(map.start(), map.end(), map);
+      astar.findPath(path);
+    }
+
+    return PATHS_COUNT;
+  }
+
+  unsigned
+  stepElement() {
+    utils::RNG rng(BENCH_SEED);
+
+    cellify::SimulationParams params = cellify::newSimulationParams();
+    cellify::Grid g(rng, params);
+
+    // The ant needs to be registered in the grid so that it
+    // can interact with the food and the colony.
+    cellify::ElementShPtr ant = cellify::newElement(
+      utils::Point2i(1, 1),
+      std::make_shared<cellify::Ant>(utils::Uuid::create())
+    );
+    g.spawn(ant);
+
+    cellify::TimeStamp moment = cellify::zero();
+    cellify::Elements spawned;
+    cellify::Influences actions;
+
+    for (unsigned id = 0u ; id < ANT_STEPS ; ++id) {
+      moment += 1000.0f * TICK_DURATION;
+
+      spawned.clear();
+      actions.clear();
+
+      cellify::StepInfo si{
+        rng,
+        params,
+        moment,
+        TICK_DURATION,
+        g,
+        spawned,
+        actions
+      };
+
+      ant->step(si);
+    }
+
+    return ANT_STEPS;
+  }
+
+  cellify::bench::Process
+  stepPopulatedWorld(unsigned count, unsigned history = 0u, bool trajectory = false) {
+    return [count, history, trajectory]() {
+      cellify::World w(scenarioOfSize(count), paramsOfSize(count));
+      w.setHistory(cellify::newHistoryDesc(history));
+      if (trajectory) {
+        w.exportTrajectory(std::make_shared<cellify::Trajectory>(TRAJECTORY_FILE));
+      }
+      w.resume();
+
+      unsigned ticks = std::max(1u, WORLD_UPDATES / count);
+      for (unsigned id = 0u ; id < ticks ; ++id) {
+        w.step(TICK_DURATION);
+      }
+
+      return ticks;
+    };
+  }
+
+  /// @brief - The world stepped by the steady state benchmark.
+  cellify::WorldShPtr g_steadyWorld = nullptr;
+
+  void
+  prepareSteadyWorld() {
+    g_steadyWorld = std::make_shared<cellify::World>(scenarioOfSize(STEADY_ELEMENTS), paramsOfSize(STEADY_ELEMENTS));
+    g_steadyWorld->resume();
+
+    for (unsigned id = 0u ; id < STEADY_WARMUP ; ++id) {
+      g_steadyWorld->step(TICK_DURATION);
+    }
+  }
+
+  unsigned
+  stepSteadyWorld() {
+    for (unsigned id = 0u ; id < STEADY_TICKS ; ++id) {
+      g_steadyWorld->step(TICK_DURATION);
+    }
+
+    return STEADY_TICKS;
+  }
+
+  /// @brief - The world saved by the snapshot benchmarks.
+  cellify::WorldShPtr g_snapshotWorld = nullptr;
+
+  /// @brief - The world restored by the snapshot benchmarks:
+  /// it is kept alive so that its destruction is not part of
+  /// the measure.
+  cellify::WorldShPtr g_restoredWorld = nullptr;
+
+  void
+  prepareSnapshot() {
+    if (g_snapshotWorld == nullptr) {
+      g_snapshotWorld = std::make_shared<cellify::World>(scenarioOfSize(SNAPSHOT_ELEMENTS), paramsOfSize(SNAPSHOT_ELEMENTS));
+    }
+  }
+
+  unsigned
+  saveSnapshot() {
+    g_snapshotWorld->save(SNAPSHOT_FILE);
+    return g_snapshotWorld->grid().size();
+  }
+
+  unsigned
+  loadSnapshot() {
+    cellify::Snapshot s(SNAPSHOT_FILE);
+    s.load();
+
+    g_restoredWorld = std::make_shared<cellify::World>(s);
+
+    return g_restoredWorld->grid().size();
+  }
+
+  unsigned
+  checkpointSnapshot() {
+    // Only the pause of the world is measured: the file
+    // is written in the background.
+    g_snapshotWorld->checkpoint(CHECKPOINT_FILE);
+    return g_snapshotWorld->grid().size();
+  }
+
+  /// @brief - The coordinate frame used by the conversion
+  /// benchmarks, similar to the one of the app.
+  std::shared_ptr<pge::TopViewFrame> g_frame = nullptr;
+
+  /// @brief - The tiles converted by the benchmarks and the
+  /// resulting pixels.
+  std::vector<float> g_tilesX, g_tilesY, g_pixelsX, g_pixelsY;
+
+  void
+  prepareTiles() {
+    if (g_frame != nullptr) {
+      return;
+    }
+
+    g_frame = std::make_shared<pge::TopViewFrame>(
+      pge::Viewport(olc::vf2d(-17.0f, -13.0f), olc::vf2d(36.0f, 27.0f)),
+      pge::Viewport(olc::vf2d(0.0f, 0.0f), olc::vf2d(800.0f, 600.0f)),
+      olc::vi2d(64, 64)
+    );
+
+    utils::RNG rng(BENCH_SEED);
+    for (unsigned id = 0u ; id < FRAME_TILES ; ++id) {
+      g_tilesX.push_back(rng.rndFloat(-20.0f, 20.0f));
+      g_tilesY.push_back(rng.rndFloat(-15.0f, 15.0f));
+    }
+
+    g_pixelsX.resize(FRAME_TILES);
+    g_pixelsY.resize(FRAME_TILES);
+  }
+
+  unsigned
+  convertTiles() {
+    const pge::CoordinateFrame& cf = *g_frame;
+
+    for (unsigned id = 0u ; id < FRAME_TILES ; ++id) {
+      olc::vf2d p = cf.tileCoordsToPixels(g_tilesX[id], g_tilesY[id], pge::RelativePosition::Center, 1.0f);
+      g_pixelsX[id] = p.x;
+      g_pixelsY[id] = p.y;
+    }
+
+    return FRAME_TILES;
+  }
+
+  unsigned
+  convertTilesBatch() {
+    const pge::CoordinateFrame& cf = *g_frame;
+
+    cf.tilesCoordsToPixels(
+      g_tilesX.data(),
+      g_tilesY.data(),
+      FRAME_TILES,
+      g_pixelsX.data(),
+      g_pixelsY.data(),
+      pge::RelativePosition::Center,
+      1.0f
+    );
+
+    return FRAME_TILES;
+  }
+
+  unsigned
+  withLogging(cellify::log::Level level, cellify::bench::Process process) {
+    cellify::log::Level prev = cellify::log::level();
+    cellify::log::setLevel(level);
+
+    unsigned ops = process();
+
+    cellify::log::setLevel(prev);
+
+    return ops;
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  std::string filter;
+  for (int id = 1 ; id < argc ; ++id) {
+    std::string arg(argv[id]);
+    if (arg.rfind("--filter=", 0) == 0) {
+      filter = arg.substr(9);
+    }
+  }
+
+  // Note that no logger is provided: messages which are
+  // enabled are still built but not printed. This allows
+  // to measure the cost of formatting them. All but the
+  // logging benchmarks run with warnings only.
+  cellify::log::setLevel(cellify::log::Level::Warning);
+
+  cellify::bench::Map open = cellify::bench::newOpenMap(MAP_HALF_SIZE);
+  cellify::bench::Map maze = cellify::bench::newMazeMap(MAP_HALF_SIZE);
+  cellify::bench::Map unreachable = cellify::bench::newUnreachableMap(MAP_HALF_SIZE);
+
+  std::vector<Case> cases = {
+    {"grid_at", gridAt, nullptr},
+    {"grid_visible", gridVisible, nullptr},
+    {"grid_spawn/merge", gridSpawnMerge, nullptr},
+    {"astar/open", [&open]() { return findPaths(open); }, nullptr},
+    {"astar/maze", [&maze]() { return findPaths(maze); }, nullptr},
+    {"astar/unreachable", [&unreachable]() { return findPaths(unreachable); }, nullptr},
+    {"element_step/ant", stepElement, nullptr},
+    {"world_step/1k", stepPopulatedWorld(1000u), nullptr},
+    {"world_step/10k", stepPopulatedWorld(10000u), nullptr},
+    {"world_step/100k", stepPopulatedWorld(100000u), nullptr},
+    {"world_step/10k_history", stepPopulatedWorld(10000u, 1u), nullptr},
+    {"world_step/10k_trajectory", stepPopulatedWorld(10000u, 0u, true), nullptr},
+    {"world_step/10k_steady", stepSteadyWorld, prepareSteadyWorld, STEADY_ALLOCATIONS},
+    {"snapshot/save_1m", saveSnapshot, prepareSnapshot},
+    {"snapshot/load_1m", loadSnapshot, []() { prepareSnapshot(); saveSnapshot(); }},
+    {"snapshot/checkpoint_1m", checkpointSnapshot, prepareSnapshot},
+    {"frame/tiles_100k", convertTiles, prepareTiles},
+    {"frame/tiles_100k_batch", convertTilesBatch, prepareTiles},
+    {"world_step/logging_on", []() { return withLogging(cellify::log::Level::Verbose, stepWorld); }, nullptr},
+    {"world_step/logging_off", []() { return withLogging(cellify::log::Level::Warning, stepWorld); }, nullptr},
+  };
+
+  bool failed = false;
+
+  try {
+    cellify::bench::printHeader(std::cout);
+
+    for (unsigned id = 0u ; id < cases.size() ; ++id) {
+      if (!filter.empty() && cases[id].name.find(filter) == std::string::npos) {
+        continue;
+      }
+
+      cellify::bench::Result res = cellify::bench::run(cases[id].name, cases[id].process, cases[id].setup);
+      cellify::bench::print(std::cout, res);
+
+      // Allocations are deterministic so any increase over
+      // the recorded baseline is a regression.
+      double allocs = (res.operations > 0u ? 1.0 * res.allocations / res.operations : 0.0);
+      if (cases[id].maxAllocations >= 0.0 && allocs > cases[id].maxAllocations) {
+        std::cerr << "Benchmark " << res.name << " performs " << allocs << " allocation(s) per operation, "
+                  << "more than the baseline of " << cases[id].maxAllocations << std::endl;
+        failed = true;
+      }
+    }
+
+    g_steadyWorld.reset();
+    g_snapshotWorld.reset();
+    g_restoredWorld.reset();
+    std::remove(SNAPSHOT_FILE);
+    std::remove(CHECKPOINT_FILE);
+
+    std::cerr << "Minimum compiled log level: "
+              << cellify::log::levelToString(static_cast<cellify::log::Level>(CELLIFY_MIN_LOG_LEVEL))
+              << std::endl;
+  }
+  catch (const utils::CoreException& e) {
+    std::cerr << "Caught internal exception while running benchmarks: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Caught exception while running benchmarks: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return (failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
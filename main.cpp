@@ -11,16 +11,396 @@
 # include "AppDesc.hh"
 # include "TopViewFrame.hh"
 # include "App.hh"
+# include "Logging.hh"
+# include "HeadlessRunner.hh"
+# include "BatchRunner.hh"
+# include "Tracer.hh"
+# include "FrameCapture.hh"
+
+/// @brief - The number of ticks between two checkpoints when
+/// only the checkpoint file is provided.
+# define DEFAULT_CHECKPOINT_INTERVAL 1000u
+
+namespace {
+
+  /**
+   * @brief - Split a `name=value` argument in its two parts.
+   * @param arg - the argument.
+   * @param name - output value holding the name.
+   * @return - the value.
+   */
+  std::string
+  splitAssignment(const std::string& arg, std::string& name) {
+    std::size_t pos = arg.find('=');
+    if (pos == std::string::npos) {
+      throw std::invalid_argument("Expected name=value but got \"" + arg + "\"");
+    }
+
+    name = arg.substr(0, pos);
+    return arg.substr(pos + 1);
+  }
+
+  utils::log::Severity
+  toSeverity(const cellify::log::Level& level) noexcept {
+    switch (level) {
+      case cellify::log::Level::Verbose:
+        return utils::log::Severity::VERBOSE;
+      case cellify::log::Level::Info:
+        return utils::log::Severity::INFO;
+      case cellify::log::Level::Notice:
+        return utils::log::Severity::NOTICE;
+      case cellify::log::Level::Warning:
+        return utils::log::Severity::WARNING;
+      case cellify::log::Level::Debug:
+      default:
+        return utils::log::Severity::DEBUG;
+    }
+  }
+
+  /// @brief - The options that can be provided on the command
+  /// line to the application.
+  struct Options {
+    // Whether the simulation should run without any window.
+    bool headless;
+
+    // The description of the headless run if needed.
+    cellify::HeadlessDesc desc;
+
+    // The file to which trace events should be written, or
+    // empty if the tracing is disabled.
+    std::string trace;
+
+    // Whether the world should be generated from a scenario
+    // rather than using the default layout.
+    bool generate;
+
+    // The description of the scenario to generate if needed.
+    cellify::ScenarioDesc scenario;
+
+    // The snapshot from which the world should be restored, or
+    // empty to create a new world.
+    std::string load;
+
+    // The snapshot to which the world should be saved at the
+    // end of a headless run, or empty.
+    std::string save;
+
+    // The periodic checkpoints of the world.
+    cellify::CheckpointDesc checkpoints;
+
+    // The journal in which inputs should be recorded, or
+    // empty if they are not recorded.
+    std::string record;
+
+    // The journal to replay, or empty.
+    std::string replay;
+
+    // The history of the world kept in memory.
+    cellify::HistoryDesc history;
+
+    // The file to which the trajectory of the ants should be
+    // exported, or empty.
+    std::string trajectory;
+
+    // The frames captured during a headless run.
+    pge::CaptureDesc capture;
+
+    // The parameters of the simulation.
+    cellify::SimulationParams params;
+
+    // The file to which the results of a batch of runs should
+    // be written, or empty to run a single simulation.
+    std::string batch;
+
+    // The parameters varying between the runs of a batch.
+    cellify::Sweep sweep;
+
+    // The number of runs of each combination of a batch.
+    unsigned repeats;
+
+    // The number of runs of a batch executed in parallel, or
+    // `0` to use one per core.
+    unsigned jobs;
+  };
+
+  Options
+  parseOptions(int argc, char** argv) {
+    // The parameters set on the command line: the ones which
+    // only describe the default layout are checked once all
+    // the options are known.
+    std::vector<std::string> params;
+
+    Options out{false, cellify::newHeadlessDesc(), "", false, cellify::newScenarioDesc(), "", "", cellify::newCheckpointDesc(), "", "", cellify::newHistoryDesc(), "", pge::newCaptureDesc(), cellify::newSimulationParams(), "", cellify::Sweep(), 1u, 0u};
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg(argv[id]);
+
+      if (arg == "--headless") {
+        out.headless = true;
+      }
+      else if (arg.rfind("--ticks=", 0) == 0) {
+        out.desc.ticks = std::stoul(arg.substr(8));
+      }
+      else if (arg.rfind("--step=", 0) == 0) {
+        out.desc.tDelta = std::stof(arg.substr(7));
+      }
+      else if (arg.rfind("--trace=", 0) == 0) {
+        out.trace = arg.substr(8);
+      }
+      else if (arg.rfind("--load=", 0) == 0) {
+        out.load = arg.substr(7);
+      }
+      else if (arg.rfind("--save=", 0) == 0) {
+        out.save = arg.substr(7);
+      }
+      else if (arg.rfind("--checkpoint=", 0) == 0) {
+        out.checkpoints.file = arg.substr(13);
+      }
+      else if (arg.rfind("--checkpoint-every=", 0) == 0) {
+        out.checkpoints.interval = std::stoul(arg.substr(19));
+      }
+      else if (arg.rfind("--record=", 0) == 0) {
+        out.record = arg.substr(9);
+      }
+      else if (arg.rfind("--replay=", 0) == 0) {
+        out.replay = arg.substr(9);
+      }
+      else if (arg.rfind("--history=", 0) == 0) {
+        out.history.interval = std::stoul(arg.substr(10));
+      }
+      else if (arg.rfind("--history-budget=", 0) == 0) {
+        out.history.budget = std::stoul(arg.substr(17)) * 1024u * 1024u;
+      }
+      else if (arg.rfind("--trajectory=", 0) == 0) {
+        out.trajectory = arg.substr(13);
+      }
+      else if (arg.rfind("--capture=", 0) == 0) {
+        out.capture.prefix = arg.substr(10);
+      }
+      else if (arg.rfind("--capture-every=", 0) == 0) {
+        out.capture.interval = std::stoul(arg.substr(16));
+      }
+      else if (arg.rfind("--capture-size=", 0) == 0) {
+        std::string dims = arg.substr(15);
+        std::size_t pos = dims.find('x');
+        if (pos == std::string::npos) {
+          throw std::invalid_argument("Expected WxH but got \"" + dims + "\"");
+        }
+
+        out.capture.width = std::stoul(dims.substr(0, pos));
+        out.capture.height = std::stoul(dims.substr(pos + 1));
+      }
+      else if (arg.rfind("--capture-tile=", 0) == 0) {
+        out.capture.tileSize = std::stof(arg.substr(15));
+      }
+      else if (arg.rfind("--param=", 0) == 0) {
+        std::string name;
+        std::string value = splitAssignment(arg.substr(8), name);
+
+        if (!cellify::setParam(out.params, name, std::stof(value))) {
+          throw std::invalid_argument("Unknown parameter \"" + name + "\"");
+        }
+
+        params.push_back(name);
+      }
+      else if (arg.rfind("--sweep=", 0) == 0) {
+        cellify::SweepAxis axis{"", std::vector<float>()};
+        std::string values = splitAssignment(arg.substr(8), axis.name);
+
+        std::size_t start = 0u;
+        while (start <= values.size()) {
+          std::size_t end = values.find(',', start);
+          if (end == std::string::npos) {
+            end = values.size();
+          }
+
+          axis.values.push_back(std::stof(values.substr(start, end - start)));
+          start = end + 1u;
+        }
+
+        out.sweep.push_back(axis);
+      }
+      else if (arg.rfind("--batch=", 0) == 0) {
+        out.batch = arg.substr(8);
+      }
+      else if (arg.rfind("--repeats=", 0) == 0) {
+        out.repeats = std::stoul(arg.substr(10));
+      }
+      else if (arg.rfind("--jobs=", 0) == 0) {
+        out.jobs = std::stoul(arg.substr(7));
+      }
+      else if (arg.rfind("--seed=", 0) == 0) {
+        out.generate = true;
+        out.scenario.seed = std::stoi(arg.substr(7));
+      }
+      else if (arg.rfind("--size=", 0) == 0) {
+        out.generate = true;
+        out.scenario.half = std::stoi(arg.substr(7));
+      }
+      else if (arg.rfind("--colonies=", 0) == 0) {
+        out.generate = true;
+        out.scenario.colonies = std::stoul(arg.substr(11));
+      }
+      else if (arg.rfind("--deposits=", 0) == 0) {
+        out.generate = true;
+        out.params.foodDepositsCount = std::stoul(arg.substr(11));
+      }
+      else if (arg.rfind("--obstacles=", 0) == 0) {
+        out.generate = true;
+        out.scenario.obstacles = std::stof(arg.substr(12));
+      }
+      else if (arg.rfind("--ants=", 0) == 0) {
+        out.generate = true;
+        out.scenario.ants = std::stoul(arg.substr(7));
+      }
+      else if (arg.rfind("--pheromons=", 0) == 0) {
+        out.generate = true;
+        out.scenario.pheromons = std::stoul(arg.substr(12));
+      }
+    }
+
+    // Generated worlds don't use the default layout.
+    if (out.generate || !out.batch.empty()) {
+      for (unsigned id = 0u ; id < params.size() ; ++id) {
+        if (cellify::layoutParam(params[id])) {
+          throw std::invalid_argument("Parameter \"" + params[id] + "\" only applies to the default layout");
+        }
+      }
+    }
+
+    // Checkpoints are only taken when a file is provided.
+    if (out.checkpoints.file.empty()) {
+      out.checkpoints.interval = 0u;
+    }
+    else if (out.checkpoints.interval == 0u) {
+      out.checkpoints.interval = DEFAULT_CHECKPOINT_INTERVAL;
+    }
+
+    return out;
+  }
+
+}
 
 int
-main(int /*argc*/, char** /*argv*/) {
-  // Create the logger.
+main(int argc, char** argv) {
+  // Create the logger: the level is aligned with the
+  // minimum level compiled in the simulation so that
+  // release builds don't produce debug messages.
+  cellify::log::Level level = cellify::log::defaultLevel();
+  cellify::log::setLevel(level);
+
   utils::log::StdLogger raw;
-  raw.setLevel(utils::log::Severity::DEBUG);
+  raw.setLevel(toSeverity(level));
   utils::log::PrefixedLogger logger("pge", "main");
   utils::log::Locator::provide(&raw);
 
   try {
+    Options opts = parseOptions(argc, argv);
+
+    if (!opts.trace.empty()) {
+      pge::trace::start(opts.trace);
+    }
+
+    // Replays always run without any window, from the
+    // snapshot attached to the journal.
+    if (!opts.replay.empty()) {
+      logger.notice("Replaying session");
+
+      cellify::Journal journal(opts.replay);
+      cellify::Snapshot s(journal.snapshot());
+      s.load();
+
+      cellify::HeadlessRunner runner(opts.desc, std::make_shared<cellify::World>(s, opts.params));
+
+      // A replay which does not reproduce the session should
+      // be reported as a failure, e.g. to scripts.
+      try {
+        runner.replay(journal);
+      }
+      catch (const utils::CoreException& e) {
+        logger.error("Replay diverged from the recorded session", e.what());
+        pge::trace::stop();
+
+        return EXIT_FAILURE;
+      }
+
+      runner.report();
+
+      pge::trace::stop();
+
+      return EXIT_SUCCESS;
+    }
+
+    // Batches always run without any window, each run uses
+    // a world generated from the scenario.
+    if (!opts.batch.empty()) {
+      logger.notice("Starting batch of simulations");
+
+      cellify::BatchDesc bd = cellify::newBatchDesc(opts.desc, opts.scenario, opts.params, opts.repeats, opts.jobs);
+      bd.sweep = opts.sweep;
+
+      cellify::BatchRunner runner(bd);
+      runner.run();
+      runner.write(opts.batch);
+
+      pge::trace::stop();
+
+      return EXIT_SUCCESS;
+    }
+
+    cellify::WorldShPtr world = nullptr;
+    if (!opts.load.empty()) {
+      cellify::Snapshot s(opts.load);
+      s.load();
+      world = std::make_shared<cellify::World>(s, opts.params);
+    }
+    else if (opts.generate) {
+      world = std::make_shared<cellify::World>(opts.scenario, opts.params);
+    }
+    else {
+      world = std::make_shared<cellify::World>(opts.params);
+    }
+
+    world->setCheckpoints(opts.checkpoints);
+    world->setHistory(opts.history);
+
+    if (!opts.record.empty()) {
+      world->record(std::make_shared<cellify::Journal>(opts.record));
+    }
+    if (!opts.trajectory.empty()) {
+      world->exportTrajectory(std::make_shared<cellify::Trajectory>(opts.trajectory));
+    }
+
+    if (opts.headless) {
+      logger.notice("Starting headless simulation");
+
+      cellify::HeadlessRunner runner(opts.desc, world);
+
+      std::shared_ptr<pge::FrameCapture> capture = nullptr;
+      if (!opts.capture.prefix.empty()) {
+        capture = std::make_shared<pge::FrameCapture>(opts.capture);
+        capture->open();
+
+        runner.observe([capture](const cellify::World& w) { capture->push(w); });
+      }
+
+      runner.run();
+
+      if (capture != nullptr) {
+        capture->close();
+      }
+
+      runner.report();
+
+      if (!opts.save.empty()) {
+        runner.save(opts.save);
+      }
+
+      pge::trace::stop();
+
+      return EXIT_SUCCESS;
+    }
+
     logger.notice("Starting application");
 
     pge::Viewport tViewport = pge::Viewport(olc::vf2d(-17.0f, -13.0f), olc::vf2d(36.0f, 27.0f));
@@ -32,19 +412,30 @@ main(int /*argc*/, char** /*argv*/) {
       olc::vi2d(64, 64)
     );
     pge::AppDesc ad = pge::newDesc(olc::vi2d(800, 600), cf, "cellify");
-    pge::App demo(ad);
+    pge::App demo(ad, world);
 
     demo.Start();
   }
   catch (const utils::CoreException& e) {
     logger.error("Caught internal exception while setting up application", e.what());
+    pge::trace::stop();
+
+    return EXIT_FAILURE;
   }
   catch (const std::exception& e) {
     logger.error("Caught internal exception while setting up application", e.what());
+    pge::trace::stop();
+
+    return EXIT_FAILURE;
   }
   catch (...) {
     logger.error("Unexpected error while setting up application");
+    pge::trace::stop();
+
+    return EXIT_FAILURE;
   }
 
+  pge::trace::stop();
+
   return EXIT_SUCCESS;
 }
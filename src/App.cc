@@ -1,50 +1,105 @@
 
 # include "App.hh"
-# include "Ant.hh"
-# include "Pheromon.hh"
+# include <algorithm>
+# include "Tracer.hh"
+
+/// @brief - The size of a cell in pixels below which only the
+/// grid lines every 5 cells are drawn.
+# define GRID_MINOR_LINES_THRESHOLD 4.0f
+
+/// @brief - The size of a cell in pixels below which only the
+/// grid lines every 10 cells are drawn.
+# define GRID_BOLD_LINES_THRESHOLD 1.0f
+
+/// @brief - The size of a cell in pixels below which the world
+/// is drawn from the density of its elements.
+# define WORLD_DENSITY_THRESHOLD 2.0f
+
+/// @brief - The size of a cell in pixels from which the moving
+/// elements are drawn individually at interpolated positions.
+# define INTERPOLATION_THRESHOLD 8.0f
+
+/// @brief - The minimum size in pixels of a bin of density.
+# define DENSITY_BIN_MIN_PIXELS 2.0f
+
+/// @brief - The ratio of the cells of a bin occupied by a type
+/// of element from which the bin is drawn fully opaque.
+# define DENSITY_SATURATION 0.25f
+
+/// @brief - The opacity of the sparsest bins, so that isolated
+/// elements stay visible.
+# define DENSITY_MINIMUM_ALPHA 64
 
 namespace {
 
-  olc::Pixel
-  colorFromTile(const cellify::Tile& t,
-                const char* data) noexcept
+  int
+  floorDiv(int v, int d) noexcept {
+    int q = v / d;
+    return (v % d != 0 && v < 0 ? q - 1 : q);
+  }
+
+  /**
+   * @brief - Compute the range of square blocks of cells which
+   *          overlap a viewport, for blocks aligned on the origin
+   *          of the world. The viewport is expanded by a cell to
+   *          account for the items straddling its border.
+   * @param tvp - the viewport in cells.
+   * @param size - the dimensions of a block in cells.
+   * @param bMin - output argument receiving the first visible
+   *               block along each axis.
+   * @param bMax - output argument receiving the last visible
+   *               block along each axis.
+   */
+  void
+  visibleBlocks(const pge::Viewport& tvp,
+                int size,
+                olc::vi2d& bMin,
+                olc::vi2d& bMax) noexcept
   {
-    switch (t) {
-      case cellify::Tile::Colony:
-        return olc::RED;
-      case cellify::Tile::Ant: {
-        const cellify::Behavior* b = reinterpret_cast<const cellify::Behavior*>(data);
-
-        if (*b == cellify::Behavior::Return) {
-          return olc::ORANGE;
-        }
-        if (*b == cellify::Behavior::Food) {
-          return olc::YELLOW;
-        }
-        return olc::BLUE;
-      }
-      case cellify::Tile::Food:
-        return olc::GREEN;
-      case cellify::Tile::Pheromon: {
-        const cellify::Scent* s = reinterpret_cast<const cellify::Scent*>(data);
+    int xMin = static_cast<int>(std::floor(tvp.topLeft().x)) - 1;
+    int yMin = static_cast<int>(std::floor(tvp.topLeft().y)) - 1;
+    int xMax = static_cast<int>(std::ceil(tvp.topLeft().x + tvp.dims().x)) + 1;
+    int yMax = static_cast<int>(std::ceil(tvp.topLeft().y + tvp.dims().y)) + 1;
 
-        if (*s == cellify::Scent::Food) {
-          return olc::Pixel(192, 255, 2);
-        }
-        return olc::Pixel(137, 209, 254);
-      }
-      case cellify::Tile::Obstacle:
-        return olc::DARK_GREY;
-      default:
-        // Error case.
-        return olc::RED;
-    }
+    bMin = olc::vi2d(floorDiv(xMin, size), floorDiv(yMin, size));
+    bMax = olc::vi2d(floorDiv(xMax, size), floorDiv(yMax, size));
   }
+
+  /**
+   * @brief - Find the blocks of a row within a range of columns
+   *          in a list of blocks sorted rows first.
+   * @param blocks - the blocks sorted rows first.
+   * @param y - the row of blocks.
+   * @param xMin - the first column of the range.
+   * @param xMax - the last column of the range.
+   * @param start - output argument receiving the index of the
+   *                first block of the range.
+   * @param end - output argument receiving the index past the
+   *              last block of the range.
+   */
+  template <typename Block>
+  void
+  blocksInRow(const std::vector<Block>& blocks,
+              int y,
+              int xMin,
+              int xMax,
+              unsigned& start,
+              unsigned& end) noexcept
+  {
+    auto before = [](const Block& b, const olc::vi2d& p) {
+      return b.y < p.y || (b.y == p.y && b.x < p.x);
+    };
+
+    start = std::lower_bound(blocks.cbegin(), blocks.cend(), olc::vi2d(xMin, y), before) - blocks.cbegin();
+    end = std::lower_bound(blocks.cbegin() + start, blocks.cend(), olc::vi2d(xMax + 1, y), before) - blocks.cbegin();
+  }
+
 }
 
 namespace pge {
 
-  App::App(const AppDesc& desc):
+  App::App(const AppDesc& desc,
+           cellify::WorldShPtr world):
     PGEApp(desc),
 
     m_game(nullptr),
@@ -52,9 +107,24 @@ namespace pge {
     m_menus(),
 
     m_packs(std::make_shared<TexturePack>()),
+    m_heatmaps(),
+    m_densities(),
+
+    m_batch(),
+
+    m_world(world)
+  {
+    if (m_world == nullptr) {
+      m_world = std::make_shared<cellify::World>();
+    }
 
-    m_world(std::make_shared<cellify::World>())
-  {}
+    // Each layer is drawn as a single texture rather than a
+    // rect per element, both at the cell and density levels.
+    for (unsigned id = 0u ; id < static_cast<unsigned>(RenderLayer::Count) ; ++id) {
+      m_heatmaps.push_back(std::make_shared<Heatmap>("layer"));
+      m_densities.push_back(std::make_shared<Heatmap>("density"));
+    }
+  }
 
   bool
   App::onFrame(float fElapsed) {
@@ -84,14 +154,18 @@ namespace pge {
     std::vector<ActionShPtr> actions;
     bool relevant = false;
 
-    for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
-      menu::InputHandle ih = m_menus[id]->processUserInput(c, actions);
-      relevant = (relevant || ih.relevant);
-    }
+    {
+      TRACE_SCOPE("menus", "ui");
+
+      for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
+        menu::InputHandle ih = m_menus[id]->processUserInput(c, actions);
+        relevant = (relevant || ih.relevant);
+      }
 
-    if (m_state != nullptr) {
-      menu::InputHandle ih = m_state->processUserInput(c, actions);
-      relevant = (relevant || ih.relevant);
+      if (m_state != nullptr) {
+        menu::InputHandle ih = m_state->processUserInput(c, actions);
+        relevant = (relevant || ih.relevant);
+      }
     }
 
     for (unsigned id = 0u ; id < actions.size() ; ++id) {
@@ -109,6 +183,14 @@ namespace pge {
     if (c.keys[controls::keys::P]) {
       m_game->togglePause();
     }
+
+    // Scrub through the history of the world.
+    if (c.keys[controls::keys::Left]) {
+      m_game->scrub(-1);
+    }
+    if (c.keys[controls::keys::Right]) {
+      m_game->scrub(1);
+    }
   }
 
   void
@@ -243,57 +325,230 @@ namespace pge {
     DrawString(olc::vi2d(0, h / 2 + 1 * dOffset), "World cell coords : " + toString(mtp), olc::CYAN);
     DrawString(olc::vi2d(0, h / 2 + 2 * dOffset), "Intra cell        : " + toString(it), olc::CYAN);
 
+    // Draw the rolling statistics of the phases of the
+    // simulation and the work performed in each tick.
+    const RenderSnapshot& s = m_game->snapshot();
+    int line = 4;
+
+    for (unsigned id = 0u ; id < static_cast<unsigned>(cellify::Phase::Count) ; ++id) {
+      cellify::Phase ph = static_cast<cellify::Phase>(id);
+
+      std::string name = cellify::phaseToString(ph);
+      name.resize(18, ' ');
+
+      DrawString(
+        olc::vi2d(0, h / 2 + line * dOffset),
+        name + ": " + cellify::percentilesToString(s.phases[id], 3) + " ms",
+        olc::YELLOW
+      );
+      ++line;
+    }
+
+    for (unsigned id = 0u ; id < static_cast<unsigned>(cellify::Counter::Count) ; ++id) {
+      cellify::Counter c = static_cast<cellify::Counter>(id);
+
+      std::string name = cellify::counterToString(c);
+      name.resize(18, ' ');
+
+      DrawString(
+        olc::vi2d(0, h / 2 + line * dOffset),
+        name + ": " + cellify::percentilesToString(s.counters[id], 0),
+        olc::YELLOW
+      );
+      ++line;
+    }
+
     SetPixelMode(olc::Pixel::NORMAL);
   }
 
   void
   App::drawWorld(const RenderDesc& res) noexcept {
-    // We want to draw first the pheromons and then the
-    // solid elements, and finally the ants.
-    drawWorldLayer(res, std::unordered_set<cellify::Tile>{cellify::Tile::Pheromon});
-    drawWorldLayer(res, std::unordered_set<cellify::Tile>{cellify::Tile::Food, cellify::Tile::Colony, cellify::Tile::Obstacle});
-    drawWorldLayer(res, std::unordered_set<cellify::Tile>{cellify::Tile::Ant});
+    // The snapshot published by the simulation is already
+    // split by layer: we draw first the pheromons and then
+    // the solid elements, and finally the ants. Each layer
+    // is painted in a heatmap unless its elements are drawn
+    // individually.
+    const RenderSnapshot& s = m_game->snapshot();
+    if (s.chunks.empty()) {
+      return;
+    }
+
+    // When zoomed out many elements map to the same pixel:
+    // the density of each layer is drawn instead.
+    float ts = std::min(res.cf.tileSize().x, res.cf.tileSize().y);
+    if (ts < WORLD_DENSITY_THRESHOLD && !s.density.empty()) {
+      drawDensity(res, s);
+      return;
+    }
+
+    // Only the chunks overlapping the viewport are drawn so
+    // that the cost does not depend on the size of the world.
+    // The rows are restricted to the ones holding chunks.
+    olc::vi2d cMin, cMax;
+    visibleBlocks(res.cf.cellsViewport(), static_cast<int>(s.chunkSize), cMin, cMax);
+
+    cMin.y = std::max(cMin.y, s.chunks.front().y);
+    cMax.y = std::min(cMax.y, s.chunks.back().y);
+    if (cMin.y > cMax.y) {
+      return;
+    }
+
+    for (unsigned id = 0u ; id < s.layers.size() ; ++id) {
+      // Ants move by whole cells: when zoomed in enough for it
+      // to be visible they are drawn individually between their
+      // previous and current cells. Few cells are visible then
+      // so this does not cost much.
+      if (id == static_cast<unsigned>(RenderLayer::Ants) && ts >= INTERPOLATION_THRESHOLD) {
+        drawWorldLayer(res, s, s.layers[id], cMin, cMax);
+        continue;
+      }
+
+      drawHeatmap(res, s.chunks, s.layers[id], cMin, cMax, *m_heatmaps[id]);
+    }
   }
 
   void
   App::drawWorldLayer(const RenderDesc& res,
-                      const std::unordered_set<cellify::Tile>& layer) noexcept
+                      const RenderSnapshot& s,
+                      const RenderBuckets& layer,
+                      const olc::vi2d& cMin,
+                      const olc::vi2d& cMax) noexcept
   {
-    SpriteDesc sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    sd.radius = 1.0f;
+    // Extrapolate the time elapsed in the world since the
+    // snapshot was published.
+    std::chrono::duration<float, std::milli> d = std::chrono::steady_clock::now() - s.published;
+    float elapsed = s.rate * d.count();
+
+    m_batch.xs.clear();
+    m_batch.ys.clear();
+    m_batch.colors.clear();
+
+    for (int cy = cMin.y ; cy <= cMax.y ; ++cy) {
+      unsigned start, end;
+      blocksInRow(s.chunks, cy, cMin.x, cMax.x, start, end);
+
+      for (unsigned id = layer.offsets[start] ; id < layer.offsets[end] ; ++id) {
+        const RenderItem& item = layer.items[id];
+
+        // The element reaches its current cell right when it
+        // is about to move again.
+        float perc = 1.0f;
+        if (s.moveDuration > 0.0f) {
+          perc = std::min(std::max((item.since + elapsed) / s.moveDuration, 0.0f), 1.0f);
+        }
+
+        m_batch.xs.push_back(item.xFrom + perc * (item.x - item.xFrom));
+        m_batch.ys.push_back(item.yFrom + perc * (item.y - item.yFrom));
+        m_batch.colors.push_back(item.color);
+      }
+    }
 
-    const cellify::Grid& g = m_world->grid();
+    // Convert all the positions at once.
+    unsigned count = m_batch.xs.size();
+    m_batch.px.resize(count);
+    m_batch.py.resize(count);
+
+    res.cf.tilesCoordsToPixels(
+      m_batch.xs.data(),
+      m_batch.ys.data(),
+      count,
+      m_batch.px.data(),
+      m_batch.py.data(),
+      RelativePosition::Center,
+      1.0f
+    );
 
-    const Viewport& tvp = res.cf.cellsViewport();
+    olc::vf2d ts = res.cf.tileSize();
+    for (unsigned id = 0u ; id < count ; ++id) {
+      FillRectDecal(olc::vf2d(m_batch.px[id], m_batch.py[id]), ts, m_batch.colors[id]);
+    }
+  }
 
-    // Traverse the list of elements of the world. We
-    // want to draw first the pheromons and then the
-    // solid elements, and finally the ants.
-    for (unsigned id = 0u ; id < g.size() ; ++id) {
-      const cellify::Element& e = g.at(id);
+  void
+  App::drawHeatmap(const RenderDesc& res,
+                   const std::vector<ChunkCoord>& chunks,
+                   const RenderBuckets& layer,
+                   const olc::vi2d& cMin,
+                   const olc::vi2d& cMax,
+                   Heatmap& heatmap)
+  {
+    heatmap.prepare(res.cf.cellsViewport());
 
-      // Ignore items outside of the view frustum.
-      if (!tvp.visible(e.pos(), 0.0f)) {
-        continue;
-      }
+    for (int cy = cMin.y ; cy <= cMax.y ; ++cy) {
+      unsigned start, end;
+      blocksInRow(chunks, cy, cMin.x, cMax.x, start, end);
 
-      // Ignore items that are not in the current layer.
-      if (layer.count(e.type()) == 0) {
-        continue;
+      // Cells outside of the viewport are ignored by the
+      // heatmap.
+      for (unsigned id = layer.offsets[start] ; id < layer.offsets[end] ; ++id) {
+        const RenderItem& item = layer.items[id];
+        heatmap.paint(static_cast<int>(item.x), static_cast<int>(item.y), item.color);
       }
+    }
+
+    heatmap.draw(this, res.cf);
+  }
+
+  void
+  App::drawDensity(const RenderDesc& res,
+                   const RenderSnapshot& s)
+  {
+    // Pick the finest level whose bins are large enough on
+    // screen: the number of bins drawn is then bounded by
+    // the size of the screen.
+    float ts = std::min(res.cf.tileSize().x, res.cf.tileSize().y);
+
+    unsigned lvl = 0u;
+    while (lvl + 1u < s.density.size() && s.density[lvl].bin * ts < DENSITY_BIN_MIN_PIXELS) {
+      ++lvl;
+    }
+
+    const DensityLevel& d = s.density[lvl];
+    const Viewport& tvp = res.cf.cellsViewport();
+    int bin = static_cast<int>(d.bin);
+
+    if (d.bins.empty()) {
+      return;
+    }
+
+    // Only the rows holding bins are visited.
+    olc::vi2d bMin, bMax;
+    visibleBlocks(tvp, bin, bMin, bMax);
+
+    bMin.y = std::max(bMin.y, d.bins.front().y);
+    bMax.y = std::min(bMax.y, d.bins.back().y);
+    if (bMin.y > bMax.y) {
+      return;
+    }
+
+    float saturation = DENSITY_SATURATION * bin * bin;
+
+    for (unsigned l = 0u ; l < static_cast<unsigned>(RenderLayer::Count) ; ++l) {
+      Heatmap& h = *m_densities[l];
+      h.prepare(tvp, bin, olc::vi2d(0, 0));
+
+      olc::Pixel c = layerColor(static_cast<RenderLayer>(l));
 
-      sd.x = 1.0f * e.pos().x();
-      sd.y = 1.0f * e.pos().y();
+      for (int by = bMin.y ; by <= bMax.y ; ++by) {
+        unsigned start, end;
+        blocksInRow(d.bins, by, bMin.x, bMax.x, start, end);
 
-      sd.sprite.tint = colorFromTile(e.type(), e.data());
+        for (unsigned id = start ; id < end ; ++id) {
+          const DensityBin& b = d.bins[id];
 
-      // Make pheromons not fully opaque.
-      if (e.type() == cellify::Tile::Pheromon) {
-        sd.sprite.tint.a = alpha::AlmostOpaque;
+          unsigned n = b.counts[l];
+          if (n == 0u) {
+            continue;
+          }
+
+          float perc = std::min(n / saturation, 1.0f);
+          c.a = static_cast<uint8_t>(DENSITY_MINIMUM_ALPHA + perc * (alpha::Opaque - DENSITY_MINIMUM_ALPHA));
+
+          h.paint(b.x * bin, b.y * bin, c);
+        }
       }
 
-      drawRect(sd, res.cf);
+      h.draw(this, res.cf);
     }
   }
 
@@ -360,6 +615,17 @@ namespace pge {
     olc::Pixel bold = olc::DARK_RED;
     olc::Pixel impo = olc::WHITE;
 
+    // When zoomed out the lines would cover most of the
+    // screen: only the emphasized ones are kept.
+    float ts = std::min(res.cf.tileSize().x, res.cf.tileSize().y);
+    int step = 1;
+    if (ts < GRID_MINOR_LINES_THRESHOLD) {
+      step = 5;
+    }
+    if (ts < GRID_BOLD_LINES_THRESHOLD) {
+      step = 10;
+    }
+
     auto colorize = [&norm, &bold, &impo](int v) {
       if (v % 10 == 0) {
         return impo;
@@ -371,11 +637,18 @@ namespace pge {
       return norm;
     };
 
-    for (int y = min.y ; y < max.y ; ++y) {
-      for (int x = min.x ; x < max.x ; ++x) {
-        render(x, y, false, colorize(x));
-      }
+    // Each line spans the whole viewport so it is drawn a
+    // single time. The first line is aligned on the step so
+    // that the emphasized lines stay in place.
+    auto first = [step](int v) {
+      int r = v % step;
+      return (r == 0 ? v : v + (r > 0 ? step - r : -r));
+    };
 
+    for (int x = first(min.x) ; x < max.x ; x += step) {
+      render(x, min.y, false, colorize(x));
+    }
+    for (int y = first(min.y) ; y < max.y ; y += step) {
       render(min.x, y, true, colorize(y));
     }
   }
@@ -1,9 +1,10 @@
 #ifndef    APP_HH
 # define   APP_HH
 
-# include <unordered_set>
+# include <vector>
 # include "PGEApp.hh"
 # include "TexturePack.hh"
+# include "Heatmap.hh"
 # include "Menu.hh"
 # include "Game.hh"
 # include "GameState.hh"
@@ -19,8 +20,11 @@ namespace pge {
        * @param desc - contains all the needed information to
        *               create the canvas needed by the app and
        *               set up base properties.
+       * @param world - the world to display. In case it is null
+       *                a default world is created.
        */
-      App(const AppDesc& desc);
+      App(const AppDesc& desc,
+          cellify::WorldShPtr world = nullptr);
 
       /**
        * @brief - Desctruction of the object.
@@ -116,7 +120,22 @@ namespace pge {
 
       void
       drawWorldLayer(const RenderDesc& res,
-                     const std::unordered_set<cellify::Tile>& layer) noexcept;
+                     const RenderSnapshot& s,
+                     const RenderBuckets& layer,
+                     const olc::vi2d& cMin,
+                     const olc::vi2d& cMax) noexcept;
+
+      void
+      drawHeatmap(const RenderDesc& res,
+                  const std::vector<ChunkCoord>& chunks,
+                  const RenderBuckets& layer,
+                  const olc::vi2d& cMin,
+                  const olc::vi2d& cMax,
+                  Heatmap& heatmap);
+
+      void
+      drawDensity(const RenderDesc& res,
+                  const RenderSnapshot& s);
 
       void
       drawOverlays(const RenderDesc& res) noexcept;
@@ -150,6 +169,40 @@ namespace pge {
        */
       TexturePackShPtr m_packs;
 
+      /**
+       * @brief - The heatmap used to draw each layer of the world.
+       */
+      std::vector<HeatmapShPtr> m_heatmaps;
+
+      /**
+       * @brief - The heatmap used to draw the density of each layer
+       *          of the world when zoomed out.
+       */
+      std::vector<HeatmapShPtr> m_densities;
+
+      /// @brief - The elements of a layer drawn individually,
+      /// gathered so that their positions are converted to
+      /// pixels in a single batch.
+      struct Batch {
+        // The position of the elements in cells.
+        std::vector<float> xs;
+        std::vector<float> ys;
+
+        // The position of the elements in pixels.
+        std::vector<float> px;
+        std::vector<float> py;
+
+        // The color of the elements.
+        std::vector<olc::Pixel> colors;
+      };
+
+      /**
+       * @brief - The buffers used to draw the elements of a layer
+       *          individually: they are kept between frames so as
+       *          not to allocate them again.
+       */
+      Batch m_batch;
+
       /**
        * @brief - The world managed by the app.
        */
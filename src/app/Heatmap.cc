@@ -0,0 +1,119 @@
+
+# include "Heatmap.hh"
+# include <cmath>
+# include <algorithm>
+
+namespace {
+
+  int
+  floorDiv(int v, int d) noexcept {
+    int q = v / d;
+    return (v % d != 0 && v < 0 ? q - 1 : q);
+  }
+
+}
+
+namespace pge {
+
+  Heatmap::Heatmap(const std::string& name):
+    utils::CoreObject(name),
+
+    m_origin(),
+    m_texel(1),
+    m_dims(),
+
+    m_texture(),
+    m_dirty(),
+    m_changed(false)
+  {
+    setService("heatmap");
+  }
+
+  void
+  Heatmap::prepare(const Viewport& cells,
+                   int texel,
+                   const olc::vi2d& anchor)
+  {
+    // Cells are drawn from their center: the partially visible
+    // ones on the border are covered as well.
+    olc::vi2d tl(
+      static_cast<int>(std::floor(cells.topLeft().x)),
+      static_cast<int>(std::floor(cells.topLeft().y))
+    );
+    olc::vi2d br(
+      static_cast<int>(std::ceil(cells.topLeft().x + cells.dims().x)),
+      static_cast<int>(std::ceil(cells.topLeft().y + cells.dims().y))
+    );
+
+    olc::vi2d origin(
+      anchor.x + floorDiv(tl.x - anchor.x, texel) * texel,
+      anchor.y + floorDiv(tl.y - anchor.y, texel) * texel
+    );
+    olc::vi2d dims(
+      floorDiv(br.x - origin.x, texel) + 1,
+      floorDiv(br.y - origin.y, texel) + 1
+    );
+
+    m_texel = texel;
+    m_origin = origin;
+
+    if (dims != m_dims) {
+      m_dims = dims;
+      m_texture.Create(m_dims.x, m_dims.y);
+      m_dirty.clear();
+
+      // Sprites are created opaque black.
+      olc::Pixel* data = m_texture.Sprite()->GetData();
+      std::fill(data, data + m_dims.x * m_dims.y, olc::BLANK);
+      m_changed = true;
+
+      verbose("Created heatmap with dimensions " + std::to_string(m_dims.x) + "x" + std::to_string(m_dims.y));
+      return;
+    }
+
+    olc::Pixel* data = m_texture.Sprite()->GetData();
+    for (unsigned id = 0u ; id < m_dirty.size() ; ++id) {
+      data[m_dirty[id]] = olc::BLANK;
+    }
+
+    m_changed = m_changed || !m_dirty.empty();
+    m_dirty.clear();
+  }
+
+  void
+  Heatmap::paint(int x, int y, const olc::Pixel& color) noexcept {
+    x = floorDiv(x - m_origin.x, m_texel);
+    y = floorDiv(y - m_origin.y, m_texel);
+
+    if (x < 0 || x >= m_dims.x || y < 0 || y >= m_dims.y) {
+      return;
+    }
+
+    unsigned id = y * m_dims.x + x;
+    m_texture.Sprite()->GetData()[id] = color;
+    m_dirty.push_back(id);
+
+    m_changed = true;
+  }
+
+  void
+  Heatmap::draw(olc::PixelGameEngine* pge, const CoordinateFrame& cf) {
+    if (m_texture.Decal() == nullptr) {
+      return;
+    }
+
+    if (m_changed) {
+      m_texture.Decal()->Update();
+      m_changed = false;
+    }
+
+    // Nothing to display.
+    if (m_dirty.empty()) {
+      return;
+    }
+
+    olc::vf2d p = cf.tileCoordsToPixels(m_origin.x, m_origin.y, RelativePosition::Center, 1.0f);
+    pge->DrawDecal(p, m_texture.Decal(), 1.0f * m_texel * cf.tileSize());
+  }
+
+}
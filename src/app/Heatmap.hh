@@ -0,0 +1,103 @@
+#ifndef    HEATMAP_HH
+# define   HEATMAP_HH
+
+# include <memory>
+# include <vector>
+# include <core_utils/CoreObject.hh>
+# include "olcEngine.hh"
+# include "CoordinateFrame.hh"
+
+namespace pge {
+
+  /// @brief - A texture covering the viewport with one texel
+  /// per cell or per square bin of cells, drawn as a single
+  /// decal. It allows to display
+  /// dense layers of cells without issuing a draw call for
+  /// each of them. Only the texels painted during the last
+  /// frame are cleared so that updating the texture costs as
+  /// much as the number of cells painted.
+  class Heatmap: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new empty heatmap. The texture is only
+       *          created when the heatmap is first prepared, as
+       *          the engine needs to be initialized.
+       * @param name - the name of the heatmap.
+       */
+      Heatmap(const std::string& name);
+
+      /**
+       * @brief - Clear the texels painted during the last frame and
+       *          make the texture cover the input viewport. The
+       *          texture is only reallocated when its dimensions
+       *          change.
+       * @param cells - the viewport to cover in cells.
+       * @param texel - the dimensions of a texel in cells.
+       * @param anchor - a cell at the top left corner of a texel:
+       *                 the texels are aligned on it.
+       */
+      void
+      prepare(const Viewport& cells,
+              int texel = 1,
+              const olc::vi2d& anchor = olc::vi2d());
+
+      /**
+       * @brief - Paint the texel containing a cell. Cells outside
+       *          of the viewport are ignored.
+       * @param x - the abscissa of the cell.
+       * @param y - the ordinate of the cell.
+       * @param color - the color of the texel.
+       */
+      void
+      paint(int x, int y, const olc::Pixel& color) noexcept;
+
+      /**
+       * @brief - Upload the texture if it changed since the last
+       *          frame and draw it as a single decal.
+       * @param pge - the engine to use to perform the rendering.
+       * @param cf - the coordinate frame to use to convert cells
+       *             to pixels.
+       */
+      void
+      draw(olc::PixelGameEngine* pge, const CoordinateFrame& cf);
+
+    private:
+
+      /**
+       * @brief - The cell at the top left corner of the texture.
+       */
+      olc::vi2d m_origin;
+
+      /**
+       * @brief - The dimensions of a texel in cells.
+       */
+      int m_texel;
+
+      /**
+       * @brief - The dimensions of the texture in texels.
+       */
+      olc::vi2d m_dims;
+
+      /**
+       * @brief - The texture and the decal used to draw it.
+       */
+      olc::Renderable m_texture;
+
+      /**
+       * @brief - The index of the texels painted since the last
+       *          call to `prepare`.
+       */
+      std::vector<unsigned> m_dirty;
+
+      /**
+       * @brief - Whether the texture changed since it was last
+       *          uploaded.
+       */
+      bool m_changed;
+  };
+
+  using HeatmapShPtr = std::shared_ptr<Heatmap>;
+}
+
+#endif    /* HEATMAP_HH */
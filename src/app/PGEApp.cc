@@ -1,5 +1,6 @@
 
 # include "PGEApp.hh"
+# include "Tracer.hh"
 
 namespace pge {
 
@@ -70,14 +71,23 @@ namespace pge {
 
   bool
   PGEApp::OnUserUpdate(float fElapsedTime) {
+    TRACE_SCOPE("frame", "app");
+
     // Handle inputs.
     InputChanges ic = handleInputs();
 
     // Handle user inputs.
-    onInputs(m_controls, *m_frame);
+    {
+      TRACE_SCOPE("inputs", "app");
+      onInputs(m_controls, *m_frame);
+    }
 
     // Handle game logic.
-    bool quit = onFrame(fElapsedTime);
+    bool quit = false;
+    {
+      TRACE_SCOPE("logic", "app");
+      quit = onFrame(fElapsedTime);
+    }
 
     // Handle rendering: for each function
     // we will assign the draw target first
@@ -95,13 +105,20 @@ namespace pge {
     // the layer at least once to `activate`
     // them: otherwise the window usually
     // stays black.
-    SetDrawTarget(m_mDecalLayer);
-    drawDecal(res);
+    {
+      TRACE_SCOPE("decal", "render");
+      SetDrawTarget(m_mDecalLayer);
+      drawDecal(res);
+    }
 
-    SetDrawTarget(m_mLayer);
-    draw(res);
+    {
+      TRACE_SCOPE("draw", "render");
+      SetDrawTarget(m_mLayer);
+      draw(res);
+    }
 
     if (hasUI()) {
+      TRACE_SCOPE("ui", "render");
       SetDrawTarget(m_uiLayer);
       drawUI(res);
     }
@@ -123,6 +140,7 @@ namespace pge {
     // as the `0`-th layer would never be
     // updated.
     if (hasDebug()) {
+      TRACE_SCOPE("debug", "render");
       SetDrawTarget(m_dLayer);
       drawDebug(res);
     }
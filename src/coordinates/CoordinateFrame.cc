@@ -25,6 +25,26 @@ namespace pge {
     updateTileScale();
   }
 
+  void
+  CoordinateFrame::tilesCoordsToPixels(const float* xs,
+                                       const float* ys,
+                                       unsigned count,
+                                       float* px,
+                                       float* py,
+                                       const RelativePosition& loc,
+                                       float radius) const noexcept
+  {
+    for (unsigned id = 0u ; id < count ; ++id) {
+      olc::vf2d p = tileCoordsToPixels(xs[id], ys[id], loc, radius);
+
+      px[id] = p.x;
+      py[id] = p.y;
+    }
+  }
+
+  void
+  CoordinateFrame::onViewportsChanged() noexcept {}
+
   void
   CoordinateFrame::updateTileScale() {
     m_tScaled = m_pViewport.dims() / m_cViewport.dims();
@@ -104,6 +104,39 @@ namespace pge {
                          const RelativePosition& loc = RelativePosition::BottomRight,
                          float radius = 1.0f) const noexcept = 0;
 
+      /**
+       * @brief - Convert a batch of tile coordinates to pixels
+       *          coordinates, as would `tileCoordsToPixels` for
+       *          each of them. It allows to prepare the drawing
+       *          of many tiles at once.
+       *          The default implementation converts each tile
+       *          with `tileCoordsToPixels`: inheriting classes
+       *          should provide a faster version if possible.
+       * @param xs - the coordinates of the cells along the `x`
+       *             axis.
+       * @param ys - the coordinates of the cells along the `y`
+       *             axis.
+       * @param count - the number of cells to convert.
+       * @param px - output array receiving the abscissa of the
+       *             cells in pixels. It should be able to hold
+       *             `count` values.
+       * @param py - output array receiving the ordinate of the
+       *             cells in pixels. It should be able to hold
+       *             `count` values.
+       * @param loc - defines the relative position of the tiles
+       *              compared to the positions provided as input.
+       * @param radius - the radius of the elements for which the
+       *                 pixels positions are computed.
+       */
+      virtual void
+      tilesCoordsToPixels(const float* xs,
+                          const float* ys,
+                          unsigned count,
+                          float* px,
+                          float* py,
+                          const RelativePosition& loc = RelativePosition::BottomRight,
+                          float radius = 1.0f) const noexcept;
+
       /**
        * @brief - Convert from pixels coordinates to tile coords.
        *          Some extra logic is added in order to account
@@ -193,6 +226,16 @@ namespace pge {
 
     protected:
 
+      /**
+       * @brief - Called whenever the viewports are modified by a
+       *          zoom or a translation, so that inheriting classes
+       *          can cache values computed from them. It is not
+       *          called by the constructor of this class.
+       *          The default implementation does nothing.
+       */
+      virtual void
+      onViewportsChanged() noexcept;
+
       /**
        * @brief - Define the viewport for this coordinate frame.
        *          It represent the area that is visible for now
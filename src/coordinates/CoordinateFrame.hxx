@@ -45,6 +45,8 @@ namespace pge {
     // the final position of the viewport.
     olc::vf2d translation = pos - m_translationOrigin;
     m_pViewport.topLeft() = m_cachedPOrigin + translation;
+
+    onViewportsChanged();
   }
 
   inline
@@ -69,6 +71,7 @@ namespace pge {
     m_cViewport.dims() *= factor;
 
     updateTileScale();
+    onViewportsChanged();
   }
 
 }
@@ -6,8 +6,12 @@ namespace pge {
   TopViewFrame::TopViewFrame(const Viewport& cvp,
                              const Viewport& pvp,
                              const olc::vi2d& tileSize):
-    CoordinateFrame(cvp, pvp, tileSize)
-  {}
+    CoordinateFrame(cvp, pvp, tileSize),
+
+    m_origin()
+  {
+    onViewportsChanged();
+  }
 
   Viewport
   TopViewFrame::cellsViewport() const noexcept {
@@ -37,38 +41,36 @@ namespace pge {
                                    const RelativePosition& loc,
                                    float radius) const noexcept
   {
-    // Offset the input coordinates based on the
-    // current position of the cell's viewport.
-    x -= m_cViewport.topLeft().x;
-    y -= m_cViewport.topLeft().y;
-
     // Convert to top view coordinates: we just
-    // need to scale by the tile size.
-    olc::vf2d tp(
-      m_pViewport.topLeft().x + x * m_tScaled.x,
-      m_pViewport.topLeft().y + y * m_tScaled.y
-    );
+    // need to scale by the tile size from the
+    // position of the origin.
+    olc::vf2d o = m_origin + offset(loc, radius);
 
-    // Account for the relative position of the
-    // tile compared to the input position.
-    switch (loc) {
-      case RelativePosition::CenterTop:
-        // Offset by a full tile in height and
-        // half a tile in width.
-        tp.x -= radius * tileSize().x / 2.0f;
-        tp.y -= radius * tileSize().y;
-        break;
-      case RelativePosition::Center:
-        tp.x -= radius * tileSize().x / 2.0f;
-        tp.y -= radius * tileSize().y / 2.0f;
-      case RelativePosition::BottomRight:
-        // This is the default case.
-      default:
-        // Nothing to do.
-        break;
-    }
+    return olc::vf2d(o.x + x * m_tScaled.x, o.y + y * m_tScaled.y);
+  }
 
-    return tp;
+  void
+  TopViewFrame::tilesCoordsToPixels(const float* xs,
+                                    const float* ys,
+                                    unsigned count,
+                                    float* px,
+                                    float* py,
+                                    const RelativePosition& loc,
+                                    float radius) const noexcept
+  {
+    // Hoist the transform out of the loop so that
+    // the conversion of each tile is independent
+    // from the others.
+    olc::vf2d o = m_origin + offset(loc, radius);
+    const float ox = o.x, oy = o.y;
+    const float sx = m_tScaled.x, sy = m_tScaled.y;
+
+    for (unsigned id = 0u ; id < count ; ++id) {
+      px[id] = ox + xs[id] * sx;
+    }
+    for (unsigned id = 0u ; id < count ; ++id) {
+      py[id] = oy + ys[id] * sy;
+    }
   }
 
   olc::vi2d
@@ -112,4 +114,28 @@ namespace pge {
     return rt;
   }
 
+  void
+  TopViewFrame::onViewportsChanged() noexcept {
+    m_origin = m_pViewport.topLeft() - m_cViewport.topLeft() * m_tScaled;
+  }
+
+  olc::vf2d
+  TopViewFrame::offset(const RelativePosition& loc, float radius) const noexcept {
+    // Account for the relative position of the
+    // tile compared to the input position.
+    switch (loc) {
+      case RelativePosition::CenterTop:
+        // Offset by a full tile in height and
+        // half a tile in width.
+        return olc::vf2d(-radius * m_tScaled.x / 2.0f, -radius * m_tScaled.y);
+      case RelativePosition::Center:
+        return olc::vf2d(-radius * m_tScaled.x / 2.0f, -radius * m_tScaled.y / 2.0f);
+      case RelativePosition::BottomRight:
+        // This is the default case.
+      default:
+        // Nothing to do.
+        return olc::vf2d(0.0f, 0.0f);
+    }
+  }
+
 }
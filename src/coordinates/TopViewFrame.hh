@@ -53,6 +53,34 @@ namespace pge {
                          const RelativePosition& loc = RelativePosition::BottomRight,
                          float radius = 1.0f) const noexcept override;
 
+      /**
+       * @brief - Implementation of the interface method to convert
+       *          a batch of tiles. The projection is an affine
+       *          transform cached when the viewports change: each
+       *          tile only costs a multiply and an add per axis,
+       *          which the compiler can vectorize.
+       * @param xs - the coordinates of the cells along the `x`
+       *             axis.
+       * @param ys - the coordinates of the cells along the `y`
+       *             axis.
+       * @param count - the number of cells to convert.
+       * @param px - output array receiving the abscissa of the
+       *             cells in pixels.
+       * @param py - output array receiving the ordinate of the
+       *             cells in pixels.
+       * @param loc - the relative position of the tiles when
+       *              compared to the provided locations.
+       * @param radius - the radius of the elements.
+       */
+      void
+      tilesCoordsToPixels(const float* xs,
+                          const float* ys,
+                          unsigned count,
+                          float* px,
+                          float* py,
+                          const RelativePosition& loc = RelativePosition::BottomRight,
+                          float radius = 1.0f) const noexcept override;
+
       /**
        * @brief - Implementation of the interface method to
        *          perform the reverse operation.
@@ -67,6 +95,36 @@ namespace pge {
       olc::vi2d
       pixelCoordsToTiles(const olc::vi2d& pixels,
                          olc::vf2d* intraTile = nullptr) const noexcept override;
+
+    protected:
+
+      /**
+       * @brief - Implementation of the interface method to update
+       *          the position of the origin cell.
+       */
+      void
+      onViewportsChanged() noexcept override;
+
+    private:
+
+      /**
+       * @brief - The offset to apply to the position of a tile in
+       *          pixels to account for its relative position.
+       * @param loc - the relative position of the tile.
+       * @param radius - the radius of the element.
+       * @return - the offset in pixels.
+       */
+      olc::vf2d
+      offset(const RelativePosition& loc, float radius) const noexcept;
+
+    private:
+
+      /**
+       * @brief - The position in pixels of the cell `(0, 0)`: the
+       *          position of a cell is obtained by adding its
+       *          coordinates scaled by the size of a tile.
+       */
+      olc::vf2d m_origin;
   };
 
 }
@@ -0,0 +1,339 @@
+
+# include "FrameCapture.hh"
+# include <cmath>
+# include <cstdio>
+# include <fstream>
+# include <algorithm>
+
+/// @brief - The margin in cells kept around the elements of the
+/// world when fitting it in the frames.
+# define CAPTURE_FIT_MARGIN 5
+
+/// @brief - The size of a cell in pixels below which only the
+/// grid lines every 5 cells are drawn.
+# define CAPTURE_MINOR_LINES_THRESHOLD 4.0f
+
+/// @brief - The size of a cell in pixels below which only the
+/// grid lines every 10 cells are drawn.
+# define CAPTURE_BOLD_LINES_THRESHOLD 1.0f
+
+namespace {
+
+  uint8_t
+  blend(uint8_t src, uint8_t dst, uint8_t alpha) noexcept {
+    return static_cast<uint8_t>((src * alpha + dst * (255 - alpha)) / 255);
+  }
+
+}
+
+namespace pge {
+
+  CaptureDesc
+  newCaptureDesc(const std::string& prefix,
+                 unsigned interval,
+                 unsigned width,
+                 unsigned height) noexcept
+  {
+    return CaptureDesc{prefix, interval, width, height, 0.0f};
+  }
+
+  FrameCapture::FrameCapture(const CaptureDesc& desc):
+    utils::CoreObject("capture"),
+
+    m_desc(desc),
+    m_frame(nullptr),
+    m_layers(),
+    m_drawn(0u),
+
+    m_locker(),
+    m_notifier(),
+    m_pending(),
+    m_free(),
+    m_active(false),
+    m_written(0u),
+    m_encoder()
+  {
+    setService("capture");
+
+    if (m_desc.interval == 0u) {
+      m_desc.interval = 1u;
+    }
+    if (m_desc.width == 0u || m_desc.height == 0u) {
+      error(
+        "Failed to create frame capture",
+        "Invalid dimensions " + std::to_string(m_desc.width) + "x" + std::to_string(m_desc.height)
+      );
+    }
+  }
+
+  FrameCapture::~FrameCapture() {
+    close();
+  }
+
+  void
+  FrameCapture::open() {
+    if (m_encoder.joinable()) {
+      return;
+    }
+
+    m_active = true;
+    m_encoder = std::thread(&FrameCapture::encode, this);
+
+    info(
+      "Capturing " + std::to_string(m_desc.width) + "x" + std::to_string(m_desc.height) +
+      " frame(s) every " + std::to_string(m_desc.interval) + " tick(s) to \"" + m_desc.prefix + "\""
+    );
+  }
+
+  void
+  FrameCapture::close() {
+    if (!m_encoder.joinable()) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      m_active = false;
+    }
+    m_notifier.notify_all();
+
+    m_encoder.join();
+
+    info("Wrote " + std::to_string(m_written.load()) + " frame(s) out of " + std::to_string(m_drawn));
+  }
+
+  void
+  FrameCapture::push(const cellify::World& world) {
+    if (!m_encoder.joinable() || world.profiler().ticks() % m_desc.interval != 0u) {
+      return;
+    }
+
+    if (m_frame == nullptr) {
+      setup(world);
+    }
+
+    // Reuse the memory of a frame already written if any. The
+    // simulation waits when the encoder is late so that the
+    // memory used by the capture stays bounded.
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> guard(m_locker);
+      m_notifier.wait(guard, [this]() { return m_pending.size() < FRAME_CAPTURE_QUEUE_CAPACITY; });
+
+      if (!m_free.empty()) {
+        frame = std::move(m_free.back());
+        m_free.pop_back();
+      }
+    }
+
+    frame.index = m_drawn;
+    frame.pixels.assign(m_desc.width * m_desc.height, olc::BLACK);
+    render(world, frame);
+    ++m_drawn;
+
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      m_pending.push_back(std::move(frame));
+    }
+    m_notifier.notify_all();
+  }
+
+  unsigned
+  FrameCapture::frames() const noexcept {
+    return m_written.load();
+  }
+
+  void
+  FrameCapture::setup(const cellify::World& world) {
+    const cellify::Grid& g = world.grid();
+
+    // Center the view on the elements of the world.
+    olc::vf2d min(0.0f, 0.0f), max(0.0f, 0.0f);
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const utils::Point2i& p = g.at(id).pos();
+
+      min.x = (id == 0u ? p.x() : std::min(min.x, 1.0f * p.x()));
+      min.y = (id == 0u ? p.y() : std::min(min.y, 1.0f * p.y()));
+      max.x = (id == 0u ? p.x() : std::max(max.x, 1.0f * p.x()));
+      max.y = (id == 0u ? p.y() : std::max(max.y, 1.0f * p.y()));
+    }
+
+    olc::vf2d pixels(1.0f * m_desc.width, 1.0f * m_desc.height);
+
+    float ts = m_desc.tileSize;
+    if (ts <= 0.0f) {
+      olc::vf2d extent = max - min + olc::vf2d(1.0f + 2.0f * CAPTURE_FIT_MARGIN, 1.0f + 2.0f * CAPTURE_FIT_MARGIN);
+      ts = std::min(pixels.x / extent.x, pixels.y / extent.y);
+    }
+
+    olc::vf2d cells = pixels / ts;
+    olc::vf2d center = (min + max) / 2.0f;
+
+    m_frame = std::make_shared<TopViewFrame>(
+      Viewport(center - cells / 2.0f, cells),
+      Viewport(olc::vf2d(0.0f, 0.0f), pixels),
+      olc::vi2d(1, 1)
+    );
+
+    verbose("Capturing frames with cells of " + std::to_string(ts) + " pixel(s)");
+  }
+
+  void
+  FrameCapture::render(const cellify::World& world, Frame& frame) {
+    const cellify::Grid& g = world.grid();
+    const CoordinateFrame& cf = *m_frame;
+    olc::vf2d ts = cf.tileSize();
+
+    // Draw the layers from the bottom to the top, as the app.
+    for (unsigned id = 0u ; id < m_layers.size() ; ++id) {
+      m_layers[id].clear();
+    }
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      m_layers[static_cast<unsigned>(layerFromElement(g.at(id)))].push_back(id);
+    }
+
+    for (unsigned l = 0u ; l < m_layers.size() ; ++l) {
+      for (unsigned id = 0u ; id < m_layers[l].size() ; ++id) {
+        const cellify::Element& e = g.at(m_layers[l][id]);
+
+        olc::vf2d p = cf.tileCoordsToPixels(e.pos().x(), e.pos().y(), RelativePosition::Center, 1.0f);
+        fill(frame, p, ts, colorFromElement(e));
+      }
+    }
+
+    // Overlay the grid with the same level of detail as the app.
+    float minTs = std::min(ts.x, ts.y);
+    int step = 1;
+    if (minTs < CAPTURE_MINOR_LINES_THRESHOLD) {
+      step = 5;
+    }
+    if (minTs < CAPTURE_BOLD_LINES_THRESHOLD) {
+      step = 10;
+    }
+
+    auto colorize = [](int v) {
+      if (v % 10 == 0) {
+        return olc::WHITE;
+      }
+      if (v % 5 == 0) {
+        return olc::DARK_RED;
+      }
+
+      return olc::VERY_DARK_GREY;
+    };
+
+    const Viewport cvp = cf.cellsViewport();
+    int xMin = static_cast<int>(std::floor(cvp.topLeft().x));
+    int yMin = static_cast<int>(std::floor(cvp.topLeft().y));
+    int xMax = static_cast<int>(std::ceil(cvp.topLeft().x + cvp.dims().x));
+    int yMax = static_cast<int>(std::ceil(cvp.topLeft().y + cvp.dims().y));
+
+    olc::vf2d pixels(1.0f * m_desc.width, 1.0f * m_desc.height);
+
+    for (int x = xMin ; x <= xMax ; ++x) {
+      if (x % step == 0) {
+        olc::vf2d p = cf.tileCoordsToPixels(x, yMin, RelativePosition::Center, 1.0f);
+        fill(frame, olc::vf2d(p.x, 0.0f), olc::vf2d(1.0f, pixels.y), colorize(x));
+      }
+    }
+    for (int y = yMin ; y <= yMax ; ++y) {
+      if (y % step == 0) {
+        olc::vf2d p = cf.tileCoordsToPixels(xMin, y, RelativePosition::Center, 1.0f);
+        fill(frame, olc::vf2d(0.0f, p.y), olc::vf2d(pixels.x, 1.0f), colorize(y));
+      }
+    }
+  }
+
+  void
+  FrameCapture::fill(Frame& frame,
+                     const olc::vf2d& p,
+                     const olc::vf2d& size,
+                     const olc::Pixel& color) const noexcept
+  {
+    // Cells entirely outside of the frame are skipped before
+    // being clamped: otherwise they would be drawn on its edges.
+    if (p.x + size.x <= 0.0f || p.y + size.y <= 0.0f || p.x >= m_desc.width || p.y >= m_desc.height) {
+      return;
+    }
+
+    int xMin = std::max(static_cast<int>(std::round(p.x)), 0);
+    int yMin = std::max(static_cast<int>(std::round(p.y)), 0);
+    int xMax = std::min(static_cast<int>(std::round(p.x + size.x)), static_cast<int>(m_desc.width));
+    int yMax = std::min(static_cast<int>(std::round(p.y + size.y)), static_cast<int>(m_desc.height));
+
+    // Small cells are still drawn on a single pixel.
+    xMax = std::max(xMax, std::min(xMin + 1, static_cast<int>(m_desc.width)));
+    yMax = std::max(yMax, std::min(yMin + 1, static_cast<int>(m_desc.height)));
+
+    for (int y = yMin ; y < yMax ; ++y) {
+      olc::Pixel* row = frame.pixels.data() + y * m_desc.width;
+
+      for (int x = xMin ; x < xMax ; ++x) {
+        olc::Pixel& d = row[x];
+
+        d.r = blend(color.r, d.r, color.a);
+        d.g = blend(color.g, d.g, color.a);
+        d.b = blend(color.b, d.b, color.a);
+      }
+    }
+  }
+
+  void
+  FrameCapture::encode() {
+    while (true) {
+      Frame frame;
+      {
+        std::unique_lock<std::mutex> guard(m_locker);
+        m_notifier.wait(guard, [this]() { return !m_pending.empty() || !m_active; });
+
+        // Pending frames are written before stopping.
+        if (m_pending.empty()) {
+          return;
+        }
+
+        frame = std::move(m_pending.front());
+        m_pending.pop_front();
+      }
+
+      bool written = write(frame);
+
+      {
+        std::lock_guard<std::mutex> guard(m_locker);
+        m_written.fetch_add(written ? 1u : 0u);
+        m_free.push_back(std::move(frame));
+      }
+      m_notifier.notify_all();
+    }
+  }
+
+  bool
+  FrameCapture::write(const Frame& frame) const {
+    char index[16];
+    std::snprintf(index, sizeof(index), "%06u", frame.index);
+    std::string file = m_desc.prefix + "_" + index + ".ppm";
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+      warn("Failed to write frame " + std::to_string(frame.index) + " to \"" + file + "\"");
+      return false;
+    }
+
+    out << "P6\n" << m_desc.width << " " << m_desc.height << "\n255\n";
+
+    std::vector<char> row(3u * m_desc.width);
+    for (unsigned y = 0u ; y < m_desc.height ; ++y) {
+      const olc::Pixel* src = frame.pixels.data() + y * m_desc.width;
+
+      for (unsigned x = 0u ; x < m_desc.width ; ++x) {
+        row[3u * x] = static_cast<char>(src[x].r);
+        row[3u * x + 1u] = static_cast<char>(src[x].g);
+        row[3u * x + 2u] = static_cast<char>(src[x].b);
+      }
+
+      out.write(row.data(), row.size());
+    }
+
+    return out.good();
+  }
+
+}
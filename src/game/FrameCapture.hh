@@ -0,0 +1,246 @@
+#ifndef    FRAME_CAPTURE_HH
+# define   FRAME_CAPTURE_HH
+
+# include <array>
+# include <atomic>
+# include <deque>
+# include <mutex>
+# include <string>
+# include <vector>
+# include <memory>
+# include <thread>
+# include <condition_variable>
+# include <core_utils/CoreObject.hh>
+# include "olcEngine.hh"
+# include "TopViewFrame.hh"
+# include "Simulation.hh"
+# include "World.hh"
+
+namespace pge {
+
+  /// @brief - The number of frames which can wait for the
+  /// encoder thread before the capture blocks the simulation.
+  constexpr unsigned FRAME_CAPTURE_QUEUE_CAPACITY = 4u;
+
+  /// @brief - Convenience structure describing how to capture
+  /// the frames of a run without any window.
+  struct CaptureDesc {
+    // The prefix of the files to which frames are written: the
+    // index of the frame and the extension are appended to it.
+    std::string prefix;
+
+    // The number of ticks between two frames.
+    unsigned interval;
+
+    // The dimensions of the frames in pixels.
+    unsigned width;
+    unsigned height;
+
+    // The dimensions of a cell in pixels, or `0` to fit the
+    // world in the frame.
+    float tileSize;
+  };
+
+  /**
+   * @brief - Creates a default description of a capture.
+   * @param prefix - the prefix of the files of the frames.
+   * @param interval - the number of ticks between two frames.
+   * @param width - the width of the frames in pixels.
+   * @param height - the height of the frames in pixels.
+   * @return - the description of the capture.
+   */
+  CaptureDesc
+  newCaptureDesc(const std::string& prefix = "",
+                 unsigned interval = 10u,
+                 unsigned width = 800u,
+                 unsigned height = 600u) noexcept;
+
+  /// @brief - Draws the world into images without any window,
+  /// typically to produce videos of headless runs. Frames are
+  /// drawn in memory with the same coordinate frame as the app
+  /// and written as binary PPM files by an encoder thread, so
+  /// that the simulation only pays for the drawing.
+  class FrameCapture: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a capture described by the input data.
+       *          Nothing is written until `open` is called.
+       * @param desc - the description of the capture.
+       */
+      FrameCapture(const CaptureDesc& desc);
+
+      /**
+       * @brief - Write the pending frames and stop the encoder.
+       */
+      ~FrameCapture();
+
+      /**
+       * @brief - Deleted copy constructor: the object owns the
+       *          encoder thread.
+       */
+      FrameCapture(const FrameCapture&) = delete;
+
+      /**
+       * @brief - Deleted assignment operator.
+       */
+      FrameCapture&
+      operator=(const FrameCapture&) = delete;
+
+      /**
+       * @brief - Start the encoder thread.
+       */
+      void
+      open();
+
+      /**
+       * @brief - Write the pending frames and stop the encoder
+       *          thread.
+       */
+      void
+      close();
+
+      /**
+       * @brief - Draw the world in a new frame if the number of
+       *          ticks since the last one reached the interval.
+       *          Blocks in case too many frames wait for the
+       *          encoder.
+       * @param world - the world to draw.
+       */
+      void
+      push(const cellify::World& world);
+
+      /**
+       * @brief - The number of frames written so far.
+       * @return - the number of frames written.
+       */
+      unsigned
+      frames() const noexcept;
+
+    private:
+
+      /// @brief - An image waiting to be written.
+      struct Frame {
+        // The index of the frame in the sequence.
+        unsigned index;
+
+        // The pixels of the frame, rows first.
+        std::vector<olc::Pixel> pixels;
+      };
+
+      /**
+       * @brief - Create the coordinate frame used to draw the
+       *          world, centered on its elements. It is called for
+       *          the first frame only: the framing stays the same
+       *          for the whole sequence and elements moving out of
+       *          it are not drawn.
+       * @param world - the world to draw.
+       */
+      void
+      setup(const cellify::World& world);
+
+      /**
+       * @brief - Draw the world in the input frame.
+       * @param world - the world to draw.
+       * @param frame - the frame to draw in.
+       */
+      void
+      render(const cellify::World& world, Frame& frame);
+
+      /**
+       * @brief - Blend a rectangle of pixels in the frame.
+       * @param frame - the frame to draw in.
+       * @param p - the top left corner of the rectangle.
+       * @param size - the dimensions of the rectangle.
+       * @param color - the color of the rectangle.
+       */
+      void
+      fill(Frame& frame,
+           const olc::vf2d& p,
+           const olc::vf2d& size,
+           const olc::Pixel& color) const noexcept;
+
+      /**
+       * @brief - The loop of the encoder thread: write the frames
+       *          until the capture is closed.
+       */
+      void
+      encode();
+
+      /**
+       * @brief - Write a frame to its file.
+       * @param frame - the frame to write.
+       * @return - `true` if the frame was written.
+       */
+      bool
+      write(const Frame& frame) const;
+
+    private:
+
+      /**
+       * @brief - The description of the capture.
+       */
+      CaptureDesc m_desc;
+
+      /**
+       * @brief - The coordinate frame used to draw the world. It
+       *          is created for the first frame and kept for the
+       *          following ones so that the view does not move.
+       */
+      CoordinateFrameShPtr m_frame;
+
+      /**
+       * @brief - The elements of each layer of the world, reused
+       *          from a frame to the next.
+       */
+      std::array<std::vector<unsigned>, static_cast<unsigned>(RenderLayer::Count)> m_layers;
+
+      /**
+       * @brief - The number of frames drawn so far.
+       */
+      unsigned m_drawn;
+
+      /**
+       * @brief - Protects the queues of frames and the status of
+       *          the encoder.
+       */
+      std::mutex m_locker;
+
+      /**
+       * @brief - Notified when a frame is queued or released, or
+       *          when the capture is closed.
+       */
+      std::condition_variable m_notifier;
+
+      /**
+       * @brief - The frames waiting to be written.
+       */
+      std::deque<Frame> m_pending;
+
+      /**
+       * @brief - The frames already written, whose memory can be
+       *          reused.
+       */
+      std::vector<Frame> m_free;
+
+      /**
+       * @brief - Whether the encoder thread should keep running.
+       */
+      bool m_active;
+
+      /**
+       * @brief - The number of frames written so far. It is
+       *          updated by the encoder thread.
+       */
+      std::atomic<unsigned> m_written;
+
+      /**
+       * @brief - The encoder thread.
+       */
+      std::thread m_encoder;
+  };
+
+  using FrameCaptureShPtr = std::shared_ptr<FrameCapture>;
+}
+
+#endif    /* FRAME_CAPTURE_HH */
@@ -1,6 +1,7 @@
 
 # include "Game.hh"
 # include <cxxabi.h>
+# include <algorithm>
 # include "Menu.hh"
 
 /// @brief - The height of the status menu in pixels.
@@ -9,7 +10,8 @@
 /// @brief - The height of the building menu in pixels.
 # define BUILDING_MENU_HEIGHT 50
 
-/// @brief - The maximum speed for the simulation.
+/// @brief - The maximum regular speed for the simulation:
+/// speeding up past it switches to the fast-forward mode.
 # define MAX_SIMULATION_SPEED 8.0f
 
 namespace {
@@ -52,10 +54,12 @@ namespace pge {
         true,  // disabled
         false, // terminated
         1.0f,  // speed
+        false, // fastForward
+        0u,    // checkpoints
       }
     ),
 
-    m_world(world),
+    m_sim(std::make_shared<Simulation>(world)),
 
     m_menus(),
 
@@ -63,9 +67,13 @@ namespace pge {
     m_itemToAdd(cellify::Tile::Obstacle)
   {
     setService("game");
+
+    m_sim->start();
   }
 
-  Game::~Game() {}
+  Game::~Game() {
+    m_sim->stop();
+  }
 
   std::vector<MenuShPtr>
   Game::generateMenus(float width,
@@ -133,27 +141,82 @@ namespace pge {
     p.x() = static_cast<int>(std::floor(x + 0.5f));
     p.y() = static_cast<int>(std::floor(y + 0.5f));
 
-    if (!m_world->spawn(p, m_itemToAdd)) {
-      warn("Failed to spawn " + cellify::tileToString(m_itemToAdd) + " at " + p.toString());
-    }
+    // The spawn is executed by the simulation thread.
+    cellify::Tile tile = m_itemToAdd;
+    m_sim->post(
+      [this, p, tile](cellify::World& w) {
+        if (!w.spawn(p, tile)) {
+          warn("Failed to spawn " + cellify::tileToString(tile) + " at " + p.toString());
+        }
+      }
+    );
   }
 
   bool
-  Game::step(float tDelta) {
-    // When the game is paused it is not over yet.
-    if (m_state.paused) {
+  Game::step(float /*tDelta*/) {
+    // Nothing changed since the last frame.
+    if (!m_sim->acquire()) {
       return true;
     }
 
-    // Step the world with a speed adapted to the
-    // current selected speed for the game.
-    m_world->step(m_state.speed * tDelta);
+    // Report the pause caused by a checkpoint of the
+    // world if one was taken since the last snapshot.
+    const RenderSnapshot& s = m_sim->snapshot();
+
+    // The simulation falls back on its own from the fast
+    // forward mode when it cannot keep up.
+    if (m_state.fastForward && !m_sim->fastForward()) {
+      m_state.fastForward = false;
+      m_state.speed = 1.0f;
+    }
+
+    if (s.checkpoints != m_state.checkpoints) {
+      m_state.checkpoints = s.checkpoints;
+      info("Checkpoint paused the simulation for " + std::to_string(s.lastPause) + "ms");
+    }
 
     updateUI();
 
     return true;
   }
 
+  const RenderSnapshot&
+  Game::snapshot() const noexcept {
+    return m_sim->snapshot();
+  }
+
+  void
+  Game::scrub(int offset) {
+    // The simulation should not move while scrubbing.
+    if (!m_state.paused) {
+      return;
+    }
+
+    // The history belongs to the world so it is only read
+    // by the simulation thread.
+    m_sim->post(
+      [this, offset](cellify::World& w) {
+        const cellify::History& h = w.history();
+        if (h.size() == 0u) {
+          return;
+        }
+
+        int cur = static_cast<int>(h.cursor());
+        int id = std::max(0, std::min(cur + offset, static_cast<int>(h.size()) - 1));
+        if (id == cur) {
+          return;
+        }
+
+        w.rewind(id);
+
+        info(
+          "Rewound to restore point " + std::to_string(id + 1) + "/" + std::to_string(h.size()) +
+          " at " + std::to_string(h.moment(id) / 1000.0f) + "s"
+        );
+      }
+    );
+  }
+
   void
   Game::togglePause() {
     if (m_state.paused) {
@@ -187,10 +250,25 @@ namespace pge {
 
     float s = m_state.speed;
 
-    m_state.speed *= 2.0f;
-    if (m_state.speed > MAX_SIMULATION_SPEED) {
+    if (m_state.fastForward) {
+      m_state.fastForward = false;
       m_state.speed = 1.0f;
     }
+    else {
+      m_state.speed *= 2.0f;
+      if (m_state.speed > MAX_SIMULATION_SPEED) {
+        m_state.fastForward = true;
+        m_state.speed = s;
+      }
+    }
+
+    m_sim->setSpeed(m_state.speed);
+    m_sim->setFastForward(m_state.fastForward);
+
+    if (m_state.fastForward) {
+      info("Simulation switched to fast-forward");
+      return;
+    }
 
     info(
       "Simulation speed updated from " + std::to_string(s) +
@@ -207,11 +285,23 @@ namespace pge {
 
   void
   Game::updateUI() {
-    // Update the speed of the simulation.
-    int sp = static_cast<int>(std::round(m_state.speed));
-    m_menus.speed->setText("Speed: x" + std::to_string(sp));
+    const RenderSnapshot& s = m_sim->snapshot();
+
+    // Update the speed of the simulation: the measured one
+    // is displayed as the requested one might not be reached.
+    std::string sp;
+    if (m_state.fastForward) {
+      sp = "Max: x" + std::to_string(static_cast<int>(std::round(s.speed)));
+    }
+    else {
+      sp = "Speed: x" + std::to_string(static_cast<int>(std::round(m_state.speed)));
+    }
+    if (!m_state.paused) {
+      sp += " (" + std::to_string(static_cast<int>(std::round(s.ticksPerSecond))) + " t/s)";
+    }
+    m_menus.speed->setText(sp);
 
-    unsigned c = m_world->count(cellify::Tile::Ant);
+    unsigned c = s.agents;
     std::string str = std::to_string(c) + " agent";
     if (c != 1u) {
       str += "s";
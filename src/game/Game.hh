@@ -5,6 +5,7 @@
 # include <memory>
 # include <core_utils/CoreObject.hh>
 # include "World.hh"
+# include "Simulation.hh"
 
 namespace pge {
 
@@ -17,7 +18,9 @@ namespace pge {
     public:
 
       /**
-       * @brief - Create a new game with default parameters.
+       * @brief - Create a new game with default parameters. The
+       *          world is simulated on a dedicated thread from
+       *          now on: it should not be accessed directly.
        * @param world - the world attached to this game.
        */
       Game(cellify::WorldShPtr world);
@@ -72,8 +75,9 @@ namespace pge {
       terminated() const noexcept;
 
       /**
-       * @brief - Forward the call to step one step ahead
-       *          in time to the internal world.
+       * @brief - Fetch the latest state of the world published
+       *          by the simulation thread and update the UI. The
+       *          world itself advances on its own thread.
        * @param tDelta - the duration of the last frame in
        *                 seconds.
        * @param bool - `true` in case the game continues,
@@ -83,6 +87,15 @@ namespace pge {
       bool
       step(float tDelta);
 
+      /**
+       * @brief - Returns the latest state of the world fetched
+       *          by `step`. It stays valid until the next call
+       *          to `step`.
+       * @return - the snapshot of the world.
+       */
+      const RenderSnapshot&
+      snapshot() const noexcept;
+
       /**
        * @brief - Performs the needed operation to handle
        *          the pause and resume operation for this
@@ -111,13 +124,24 @@ namespace pge {
       resume();
 
       /**
-       * @brief - Used to change the speed of the simulation
-       *          or reduce it in case it is already at its
-       *          maximum value.
+       * @brief - Used to change the speed of the simulation.
+       *          Past the maximum regular speed the simulation
+       *          switches to fast-forward, and then back to its
+       *          initial speed.
        */
       void
       speedUpSimulation() noexcept;
 
+      /**
+       * @brief - Move through the history of the world while the
+       *          game is paused. Nothing happens if the world has
+       *          no history.
+       * @param offset - the number of restore points to move by,
+       *                 negative values moving back in time.
+       */
+      void
+      scrub(int offset);
+
       /**
        * @brief - Specify a new item to be added when the user
        *          clicks somewhere on the grid.
@@ -171,6 +195,13 @@ namespace pge {
 
         // The current speed of the simulation.
         float speed;
+
+        // Whether the simulation runs as fast as possible.
+        bool fastForward;
+
+        // The number of checkpoints of the world already
+        // reported.
+        unsigned checkpoints;
       };
 
       /// @brief - Convenience structure allowing to regroup
@@ -195,9 +226,9 @@ namespace pge {
       State m_state;
 
       /**
-       * @brief - The world attached to the game.
+       * @brief - The simulation of the world attached to the game.
        */
-      cellify::WorldShPtr m_world;
+      SimulationShPtr m_sim;
 
       /**
        * @brief - The menus displaying information about the
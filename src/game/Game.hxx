@@ -26,7 +26,13 @@ namespace pge {
       return;
     }
 
-    m_world->pause();
+    // The world stops being stepped before it is paused.
+    m_sim->setRunning(false);
+    m_sim->post(
+      [](cellify::World& w) {
+        w.pause();
+      }
+    );
 
     info("Game is now paused");
     m_state.paused = true;
@@ -40,7 +46,12 @@ namespace pge {
       return;
     }
 
-    m_world->resume();
+    m_sim->post(
+      [](cellify::World& w) {
+        w.resume();
+      }
+    );
+    m_sim->setRunning(true);
 
     info("Game is now resumed");
     m_state.paused = false;
@@ -0,0 +1,621 @@
+
+# include "Simulation.hh"
+# include <chrono>
+# include <algorithm>
+# include <core_utils/CoreException.hh>
+# include "ColorUtils.hh"
+# include "Ant.hh"
+# include "Pheromon.hh"
+
+/// @brief - The minimum duration of a tick of the simulation
+/// thread in milliseconds: the thread sleeps for the rest of
+/// it when the world is faster to simulate.
+# define SIMULATION_TICK_INTERVAL 16
+
+/// @brief - The interval between two snapshots published in
+/// fast-forward mode in milliseconds.
+# define FAST_FORWARD_PUBLISH_INTERVAL 100
+
+/// @brief - The duration over which the speed of the simulation
+/// is measured in milliseconds.
+# define SPEED_MEASURE_INTERVAL 500
+
+/// @brief - The dimensions in cells of the chunks used to
+/// bucket the elements of the snapshots.
+# define RENDER_CHUNK_SIZE 16
+
+/// @brief - The amount of a pheromon from which it is drawn
+/// fully opaque.
+# define PHEROMON_SATURATION_AMOUNT 5.0f
+
+/// @brief - The opacity of a pheromon close to evaporating,
+/// so that it stays visible.
+# define PHEROMON_MINIMUM_ALPHA 32
+
+/// @brief - The dimensions in cells of the finest bins used
+/// to compute the density of the elements.
+# define DENSITY_BIN_SIZE 4
+
+/// @brief - The maximum number of levels of density.
+# define DENSITY_LEVELS_COUNT 8
+
+/// @brief - The number of finest bins of density along each
+/// axis of a chunk.
+# define DENSITY_BINS_PER_CHUNK (RENDER_CHUNK_SIZE / DENSITY_BIN_SIZE)
+
+static_assert(RENDER_CHUNK_SIZE % DENSITY_BIN_SIZE == 0, "Density bins should tile the chunks");
+
+namespace {
+
+  int
+  floorDiv(int v, int d) noexcept {
+    int q = v / d;
+    return (v % d != 0 && v < 0 ? q - 1 : q);
+  }
+
+}
+
+namespace pge {
+
+  olc::Pixel
+  layerColor(const RenderLayer& layer) noexcept {
+    switch (layer) {
+      case RenderLayer::HomePheromons:
+        return olc::Pixel(137, 209, 254);
+      case RenderLayer::FoodPheromons:
+        return olc::Pixel(192, 255, 2);
+      case RenderLayer::Obstacles:
+        return olc::DARK_GREY;
+      case RenderLayer::Deposits:
+        return olc::GREEN;
+      case RenderLayer::Colonies:
+        return olc::RED;
+      case RenderLayer::Ants:
+        return olc::BLUE;
+      default:
+        // Error case.
+        return olc::RED;
+    }
+  }
+
+  RenderLayer
+  layerFromElement(const cellify::Element& e) noexcept {
+    switch (e.type()) {
+      case cellify::Tile::Pheromon: {
+        const cellify::Scent* s = reinterpret_cast<const cellify::Scent*>(e.data());
+        if (*s == cellify::Scent::Food) {
+          return RenderLayer::FoodPheromons;
+        }
+        return RenderLayer::HomePheromons;
+      }
+      case cellify::Tile::Ant:
+        return RenderLayer::Ants;
+      case cellify::Tile::Colony:
+        return RenderLayer::Colonies;
+      case cellify::Tile::Food:
+        return RenderLayer::Deposits;
+      case cellify::Tile::Obstacle:
+      default:
+        return RenderLayer::Obstacles;
+    }
+  }
+
+  olc::Pixel
+  colorFromElement(const cellify::Element& e) noexcept {
+    olc::Pixel c = layerColor(layerFromElement(e));
+
+    switch (e.type()) {
+      case cellify::Tile::Ant: {
+        const cellify::Behavior* b = reinterpret_cast<const cellify::Behavior*>(e.data());
+
+        if (*b == cellify::Behavior::Return) {
+          return olc::ORANGE;
+        }
+        if (*b == cellify::Behavior::Food) {
+          return olc::YELLOW;
+        }
+        return c;
+      }
+      case cellify::Tile::Pheromon: {
+        // The opacity grows with the amount of pheromon
+        // until it saturates.
+        cellify::PheromonShPtr p = std::dynamic_pointer_cast<cellify::Pheromon>(e.brain());
+        float amount = (p ? p->amount() : PHEROMON_SATURATION_AMOUNT);
+        float perc = std::min(std::max(amount / PHEROMON_SATURATION_AMOUNT, 0.0f), 1.0f);
+
+        c.a = static_cast<uint8_t>(PHEROMON_MINIMUM_ALPHA + perc * (alpha::AlmostOpaque - PHEROMON_MINIMUM_ALPHA));
+
+        return c;
+      }
+      default:
+        return c;
+    }
+  }
+
+  Simulation::Simulation(cellify::WorldShPtr world):
+    utils::CoreObject("simulation"),
+
+    m_world(world),
+
+    m_locker(),
+    m_commands(),
+
+    m_running(false),
+    m_speed(1.0f),
+    m_fastForward(false),
+
+    m_window(std::chrono::steady_clock::now()),
+    m_simulated(0.0f),
+    m_ticks(0u),
+    m_achievedSpeed(0.0f),
+    m_ticksPerSecond(0.0f),
+
+    m_active(false),
+    m_thread(),
+
+    m_snapshots(),
+
+    m_chunkIds(),
+    m_chunkCoords(),
+    m_chunkOrder(),
+    m_chunkRanks(),
+    m_chunkOf(),
+    m_binCounts()
+  {
+    setService("game");
+  }
+
+  Simulation::~Simulation() {
+    stop();
+  }
+
+  void
+  Simulation::start() {
+    if (m_active.load()) {
+      return;
+    }
+
+    m_active.store(true);
+    m_thread = std::thread(&Simulation::simulate, this);
+
+    info("Started simulation thread");
+  }
+
+  void
+  Simulation::stop() {
+    if (!m_active.load()) {
+      return;
+    }
+
+    m_active.store(false);
+    m_thread.join();
+
+    info("Stopped simulation thread");
+  }
+
+  void
+  Simulation::post(const Command& cmd) {
+    std::lock_guard<std::mutex> guard(m_locker);
+    m_commands.push_back(cmd);
+  }
+
+  void
+  Simulation::setRunning(bool running) noexcept {
+    m_running.store(running);
+  }
+
+  void
+  Simulation::setSpeed(float speed) noexcept {
+    m_speed.store(speed);
+  }
+
+  void
+  Simulation::setFastForward(bool fastForward) noexcept {
+    m_fastForward.store(fastForward);
+  }
+
+  bool
+  Simulation::fastForward() const noexcept {
+    return m_fastForward.load();
+  }
+
+  bool
+  Simulation::acquire() noexcept {
+    return m_snapshots.acquire();
+  }
+
+  const RenderSnapshot&
+  Simulation::snapshot() const noexcept {
+    return m_snapshots.front();
+  }
+
+  void
+  Simulation::simulate() {
+    using Clock = std::chrono::steady_clock;
+
+    publish();
+
+    Clock::time_point last = Clock::now();
+    Clock::time_point published = last;
+    bool pending = false;
+    bool mode = false;
+
+    while (m_active.load()) {
+      Clock::time_point start = Clock::now();
+
+      pending = execute() || pending;
+
+      // The duration of a tick is the wall clock time since
+      // the previous one, just like a frame. In fast-forward
+      // mode each tick simulates a fixed duration instead, as
+      // small as a regular tick so that the behavior of the
+      // elements is not altered.
+      std::chrono::duration<float> elapsed = start - last;
+      last = start;
+
+      bool running = m_running.load();
+      bool ff = m_fastForward.load();
+
+      if (running) {
+        float tDelta = (ff ? SIMULATION_TICK_INTERVAL / 1000.0f : m_speed.load() * elapsed.count());
+        // A failing tick is reported but does not stop the
+        // thread: nothing would catch the error otherwise.
+        try {
+          m_world->step(tDelta);
+
+          m_simulated += tDelta;
+          ++m_ticks;
+        }
+        catch (const utils::CoreException& e) {
+          warn(std::string("Failed to simulate tick: ") + e.what());
+        }
+
+        pending = true;
+      }
+
+      // The measures restart when the mode changes so that
+      // the fallback only considers the fast-forward ticks.
+      pending = measure(start, running && ff == mode) || pending;
+      mode = ff;
+
+      // Building a snapshot costs about as much as a tick so
+      // they are published less often when fast-forwarding.
+      bool throttled = (ff && start - published < std::chrono::milliseconds(FAST_FORWARD_PUBLISH_INTERVAL));
+      if (pending && !throttled) {
+        publish();
+
+        published = start;
+        pending = false;
+      }
+
+      if (!ff || !running) {
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(SIMULATION_TICK_INTERVAL));
+      }
+    }
+
+    // Commands posted before the simulation was stopped are
+    // still applied.
+    execute();
+  }
+
+  bool
+  Simulation::execute() {
+    std::vector<Command> commands;
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      commands.swap(m_commands);
+    }
+
+    for (unsigned id = 0u ; id < commands.size() ; ++id) {
+      try {
+        commands[id](*m_world);
+      }
+      catch (const utils::CoreException& e) {
+        warn(std::string("Failed to execute command: ") + e.what());
+      }
+    }
+
+    return !commands.empty();
+  }
+
+  void
+  Simulation::publish() {
+    RenderSnapshot& s = m_snapshots.back();
+
+    const cellify::Grid& g = m_world->grid();
+    cellify::TimeStamp moment = m_world->moment();
+    bool paused = m_world->paused();
+
+    // Only the chunks holding elements are listed: they are
+    // gathered here as the ants move during a tick. Elements
+    // close to each other are usually in the same chunk, so
+    // the chunk of the previous element is checked first.
+    s.agents = g.count(cellify::Tile::Ant);
+    s.chunkSize = RENDER_CHUNK_SIZE;
+
+    m_chunkIds.clear();
+    m_chunkCoords.clear();
+    m_chunkOf.resize(g.size());
+
+    std::uint64_t last = 0u;
+    unsigned lastId = 0u;
+
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const cellify::Element& e = g.at(id);
+      const utils::Point2i& p = e.pos();
+
+      ChunkCoord c{floorDiv(p.x(), RENDER_CHUNK_SIZE), floorDiv(p.y(), RENDER_CHUNK_SIZE)};
+      std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.y)) << 32u) | static_cast<std::uint32_t>(c.x);
+
+      if (id == 0u || key != last) {
+        std::pair<std::unordered_map<std::uint64_t, unsigned>::iterator, bool> it = m_chunkIds.emplace(key, m_chunkCoords.size());
+        if (it.second) {
+          m_chunkCoords.push_back(c);
+        }
+
+        last = key;
+        lastId = it.first->second;
+      }
+
+      m_chunkOf[id] = lastId;
+    }
+
+    // Sort the chunks rows first so that the visible ones can
+    // be found by rows when drawing.
+    unsigned chunks = m_chunkCoords.size();
+
+    m_chunkOrder.resize(chunks);
+    for (unsigned id = 0u ; id < chunks ; ++id) {
+      m_chunkOrder[id] = id;
+    }
+    std::sort(
+      m_chunkOrder.begin(),
+      m_chunkOrder.end(),
+      [this](unsigned lhs, unsigned rhs) {
+        const ChunkCoord& l = m_chunkCoords[lhs];
+        const ChunkCoord& r = m_chunkCoords[rhs];
+        return l.y < r.y || (l.y == r.y && l.x < r.x);
+      }
+    );
+
+    s.chunks.resize(chunks);
+    m_chunkRanks.resize(chunks);
+    for (unsigned id = 0u ; id < chunks ; ++id) {
+      s.chunks[id] = m_chunkCoords[m_chunkOrder[id]];
+      m_chunkRanks[m_chunkOrder[id]] = id;
+    }
+
+    // Bucket the elements with a counting sort: the offsets
+    // first hold the size of each chunk and are then turned
+    // into the position of the next item of the chunk. The
+    // vectors keep their capacity from a snapshot to the next
+    // so that no memory is allocated once the world is stable.
+    for (unsigned id = 0u ; id < s.layers.size() ; ++id) {
+      s.layers[id].offsets.assign(chunks + 1u, 0u);
+    }
+
+    // The finest bins of density are counted for each chunk
+    // holding elements: their number follows the number of
+    // elements rather than the extent of the world.
+    const unsigned layers = static_cast<unsigned>(RenderLayer::Count);
+    const unsigned perChunk = DENSITY_BINS_PER_CHUNK * DENSITY_BINS_PER_CHUNK * layers;
+
+    m_binCounts.assign(chunks * perChunk, 0u);
+
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const cellify::Element& e = g.at(id);
+      unsigned l = static_cast<unsigned>(layerFromElement(e));
+
+      m_chunkOf[id] = m_chunkRanks[m_chunkOf[id]];
+
+      RenderBuckets& b = s.layers[l];
+      ++b.offsets[m_chunkOf[id] + 1u];
+
+      const ChunkCoord& c = s.chunks[m_chunkOf[id]];
+      int bx = floorDiv(e.pos().x(), DENSITY_BIN_SIZE) - c.x * DENSITY_BINS_PER_CHUNK;
+      int by = floorDiv(e.pos().y(), DENSITY_BIN_SIZE) - c.y * DENSITY_BINS_PER_CHUNK;
+      ++m_binCounts[m_chunkOf[id] * perChunk + (by * DENSITY_BINS_PER_CHUNK + bx) * layers + l];
+    }
+
+    for (unsigned id = 0u ; id < s.layers.size() ; ++id) {
+      RenderBuckets& b = s.layers[id];
+
+      for (unsigned c = 1u ; c <= chunks ; ++c) {
+        b.offsets[c] += b.offsets[c - 1u];
+      }
+
+      b.items.resize(b.offsets[chunks]);
+    }
+
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const cellify::Element& e = g.at(id);
+
+      RenderBuckets& b = s.layers[static_cast<unsigned>(layerFromElement(e))];
+      unsigned& next = b.offsets[m_chunkOf[id]];
+
+      // The time since the last move is frozen while the
+      // world is paused.
+      float since = (paused ? e.elapsedSinceLast() : moment - e.last());
+
+      b.items[next] = RenderItem{
+        1.0f * e.pos().x(),                 // x
+        1.0f * e.pos().y(),                 // y
+        1.0f * e.previous().x(),            // xFrom
+        1.0f * e.previous().y(),            // yFrom
+        since,                              // since
+        e.type(),                           // tile
+        colorFromElement(e)                 // color
+      };
+      ++next;
+    }
+
+    // Each offset now points to the start of the next chunk:
+    // shift them back to the start of their own chunk.
+    for (unsigned id = 0u ; id < s.layers.size() ; ++id) {
+      RenderBuckets& b = s.layers[id];
+
+      for (unsigned c = chunks ; c > 0u ; --c) {
+        b.offsets[c] = b.offsets[c - 1u];
+      }
+      b.offsets[0] = 0u;
+    }
+
+    // The finest bins are listed rows first: the chunks of a
+    // row are visited once for each row of bins they hold.
+    DensityLevel& fine = s.density.empty() ? s.density.emplace_back() : s.density[0];
+    fine.bin = DENSITY_BIN_SIZE;
+    fine.bins.clear();
+
+    unsigned start = 0u;
+    while (start < chunks) {
+      unsigned end = start;
+      while (end < chunks && s.chunks[end].y == s.chunks[start].y) {
+        ++end;
+      }
+
+      for (int by = 0 ; by < DENSITY_BINS_PER_CHUNK ; ++by) {
+        for (unsigned c = start ; c < end ; ++c) {
+          for (int bx = 0 ; bx < DENSITY_BINS_PER_CHUNK ; ++bx) {
+            const unsigned* counts = m_binCounts.data() + c * perChunk + (by * DENSITY_BINS_PER_CHUNK + bx) * layers;
+
+            DensityBin bin{s.chunks[c].x * DENSITY_BINS_PER_CHUNK + bx, s.chunks[c].y * DENSITY_BINS_PER_CHUNK + by, {}};
+            bool empty = true;
+            for (unsigned l = 0u ; l < layers ; ++l) {
+              bin.counts[l] = counts[l];
+              empty = empty && counts[l] == 0u;
+            }
+
+            if (!empty) {
+              fine.bins.push_back(bin);
+            }
+          }
+        }
+      }
+
+      start = end;
+    }
+
+    // The coarser levels of density are built from the finer
+    // ones: each row of bins merges two rows of the previous
+    // level, which are both sorted.
+    unsigned levels = 1u;
+    while (levels < DENSITY_LEVELS_COUNT && s.density[levels - 1u].bins.size() > 1u) {
+      if (s.density.size() <= levels) {
+        s.density.emplace_back();
+      }
+
+      const DensityLevel& prev = s.density[levels - 1u];
+      DensityLevel& cur = s.density[levels];
+
+      cur.bin = 2u * prev.bin;
+      cur.bins.clear();
+
+      unsigned count = prev.bins.size();
+      unsigned first = 0u;
+
+      while (first < count) {
+        int row = floorDiv(prev.bins[first].y, 2);
+
+        unsigned mid = first;
+        while (mid < count && prev.bins[mid].y == prev.bins[first].y) {
+          ++mid;
+        }
+        unsigned last = mid;
+        while (last < count && floorDiv(prev.bins[last].y, 2) == row) {
+          ++last;
+        }
+
+        unsigned i = first, j = mid;
+        while (i < mid || j < last) {
+          bool top = (j >= last || (i < mid && prev.bins[i].x <= prev.bins[j].x));
+          const DensityBin& b = (top ? prev.bins[i++] : prev.bins[j++]);
+
+          int x = floorDiv(b.x, 2);
+          if (cur.bins.empty() || cur.bins.back().y != row || cur.bins.back().x != x) {
+            cur.bins.push_back(DensityBin{x, row, b.counts});
+            continue;
+          }
+
+          for (unsigned l = 0u ; l < layers ; ++l) {
+            cur.bins.back().counts[l] += b.counts[l];
+          }
+        }
+
+        first = last;
+      }
+
+      ++levels;
+    }
+    s.density.resize(levels);
+
+    const cellify::TickProfiler& p = m_world->profiler();
+    s.tick = p.ticks();
+
+    // Allows the renderer to extrapolate the time elapsed in
+    // the world since the snapshot. The fast-forward does not
+    // move at a steady pace so it is not extrapolated.
+    bool steady = m_running.load() && !paused && !m_fastForward.load();
+
+    s.published = std::chrono::steady_clock::now();
+    s.rate = (steady ? m_speed.load() : 0.0f);
+    s.moveDuration = m_world->params().idleTime;
+
+    for (unsigned id = 0u ; id < s.phases.size() ; ++id) {
+      s.phases[id] = p.percentiles(static_cast<cellify::Phase>(id));
+    }
+    for (unsigned id = 0u ; id < s.counters.size() ; ++id) {
+      s.counters[id] = p.percentiles(static_cast<cellify::Counter>(id));
+    }
+
+    const cellify::Checkpointer& c = m_world->checkpointer();
+    s.checkpoints = c.started();
+    s.lastPause = c.lastPause();
+
+    s.fastForward = m_fastForward.load();
+    s.speed = m_achievedSpeed;
+    s.ticksPerSecond = m_ticksPerSecond;
+
+    m_snapshots.publish();
+  }
+
+  bool
+  Simulation::measure(const std::chrono::steady_clock::time_point& now, bool steady) {
+    // Only the time during which the world is stepped is
+    // accounted for.
+    if (!steady) {
+      m_window = now;
+      m_simulated = 0.0f;
+      m_ticks = 0u;
+
+      return false;
+    }
+
+    std::chrono::duration<float> window = now - m_window;
+    if (window < std::chrono::milliseconds(SPEED_MEASURE_INTERVAL)) {
+      return false;
+    }
+
+    m_achievedSpeed = m_simulated / window.count();
+    m_ticksPerSecond = m_ticks / window.count();
+
+    m_window = now;
+    m_simulated = 0.0f;
+    m_ticks = 0u;
+
+    // The fast-forward is only useful when it is faster than
+    // real time: otherwise each tick exceeds the time that it
+    // simulates and the regular mode is a better fit.
+    if (m_fastForward.load() && m_achievedSpeed < 1.0f) {
+      m_fastForward.store(false);
+      m_speed.store(1.0f);
+
+      warn(
+        "Fast-forward only reached x" + std::to_string(m_achievedSpeed) +
+        " (" + std::to_string(m_ticksPerSecond) + " tick(s)/s), falling back to regular speed"
+      );
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,448 @@
+#ifndef    SIMULATION_HH
+# define   SIMULATION_HH
+
+# include <array>
+# include <mutex>
+# include <chrono>
+# include <atomic>
+# include <thread>
+# include <vector>
+# include <memory>
+# include <functional>
+# include <unordered_map>
+# include <core_utils/CoreObject.hh>
+# include "olcEngine.hh"
+# include "World.hh"
+# include "TripleBuffer.hh"
+
+namespace pge {
+
+  /// @brief - The layers in which the elements of the world
+  /// are drawn, from the bottom to the top. Each scent has its
+  /// own layer so that it can be drawn as a heatmap, and each
+  /// type of element has its own color when zoomed out.
+  enum class RenderLayer {
+    HomePheromons,
+    FoodPheromons,
+    Obstacles,
+    Deposits,
+    Colonies,
+    Ants,
+    Count
+  };
+
+  /**
+   * @brief - The base color of the elements of a layer.
+   * @param layer - the layer.
+   * @return - the color of the layer.
+   */
+  olc::Pixel
+  layerColor(const RenderLayer& layer) noexcept;
+
+  /**
+   * @brief - The layer in which an element of the world is drawn.
+   * @param e - the element.
+   * @return - the layer of the element.
+   */
+  RenderLayer
+  layerFromElement(const cellify::Element& e) noexcept;
+
+  /**
+   * @brief - The color used to draw an element of the world. The
+   *          opacity of the pheromons reflects their amount.
+   * @param e - the element.
+   * @return - the color of the element.
+   */
+  olc::Pixel
+  colorFromElement(const cellify::Element& e) noexcept;
+
+  /// @brief - The visual representation of an element of the
+  /// world.
+  struct RenderItem {
+    // The position of the element in cells.
+    float x;
+    float y;
+
+    // The position of the element before its last move.
+    float xFrom;
+    float yFrom;
+
+    // The time elapsed in the world since the last move of
+    // the element in milliseconds.
+    float since;
+
+    // The type of the element.
+    cellify::Tile tile;
+
+    // The color used to display the element. The opacity of
+    // the pheromons reflects their amount.
+    olc::Pixel color;
+  };
+
+  /// @brief - The coordinates of a square chunk of cells. The
+  /// chunks are aligned on the origin of the world: a chunk
+  /// covers the cells from `x * size` to `(x + 1) * size - 1`
+  /// along the horizontal axis and similarly vertically.
+  struct ChunkCoord {
+    int x;
+    int y;
+  };
+
+  /// @brief - The elements of a layer of the world bucketed by
+  /// square chunks of cells, so that drawing only considers the
+  /// chunks overlapping the viewport.
+  struct RenderBuckets {
+    // The items of the layer sorted in the order of the chunks
+    // of the snapshot.
+    std::vector<RenderItem> items;
+
+    // The index in `items` of the first item of each chunk of
+    // the snapshot, followed by the number of items.
+    std::vector<unsigned> offsets;
+  };
+
+  /// @brief - The number of elements of each layer in a square
+  /// bin of cells. Bins are aligned on the origin of the world
+  /// like the chunks.
+  struct DensityBin {
+    // The coordinates of the bin, in bins.
+    int x;
+    int y;
+
+    // The number of elements in the bin for each layer.
+    std::array<unsigned, static_cast<unsigned>(RenderLayer::Count)> counts;
+  };
+
+  /// @brief - The number of elements of each layer in square
+  /// bins of cells, used to draw the world when many elements
+  /// map to the same pixel.
+  struct DensityLevel {
+    // The dimensions of a bin in cells.
+    unsigned bin;
+
+    // The bins holding at least an element, sorted rows first.
+    std::vector<DensityBin> bins;
+  };
+
+  /// @brief - An immutable copy of everything needed to draw the
+  /// world and its statistics at a given tick, produced by the
+  /// simulation thread.
+  struct RenderSnapshot {
+    // The elements of the world, split by layer.
+    std::array<RenderBuckets, static_cast<unsigned>(RenderLayer::Count)> layers;
+
+    // The dimensions of a chunk in cells.
+    unsigned chunkSize;
+
+    // The chunks holding at least an element, sorted rows
+    // first. Empty chunks are not listed so that the size of
+    // the snapshot doesn't depend on the extent of the world.
+    std::vector<ChunkCoord> chunks;
+
+    // The density of the elements from the finest bins to the
+    // coarsest, each level having bins twice as large as the
+    // previous one. Like the chunks, only the bins holding
+    // elements are listed.
+    std::vector<DensityLevel> density;
+
+    // The number of ticks simulated by the world.
+    unsigned tick;
+
+    // The wall clock time at which the snapshot was published.
+    std::chrono::steady_clock::time_point published;
+
+    // The number of milliseconds elapsing in the world for each
+    // millisecond of wall clock time, `0` when it is paused.
+    float rate;
+
+    // The duration of a move of an element in milliseconds.
+    float moveDuration;
+
+    // The number of ants in the world.
+    unsigned agents;
+
+    // The number of checkpoints started by the world.
+    unsigned checkpoints;
+
+    // The pause caused by the last checkpoint in milliseconds.
+    float lastPause;
+
+    // Whether the simulation runs in fast-forward mode.
+    bool fastForward;
+
+    // The ratio between the simulated time and the wall clock
+    // time, measured over the last second or so.
+    float speed;
+
+    // The number of ticks simulated per second of wall clock
+    // time, measured over the last second or so.
+    float ticksPerSecond;
+
+    // The rolling statistics of the phases of a tick.
+    std::array<cellify::Percentiles, static_cast<unsigned>(cellify::Phase::Count)> phases;
+
+    // The rolling statistics of the counters of a tick.
+    std::array<cellify::Percentiles, static_cast<unsigned>(cellify::Counter::Count)> counters;
+  };
+
+  /// @brief - Runs a world on a dedicated thread so that the
+  /// duration of a tick and the duration of a frame do not
+  /// depend on each other. The world must not be accessed by
+  /// other threads while the simulation runs: modifications
+  /// are posted as commands executed by the simulation thread
+  /// between two ticks, and the state of the world is published
+  /// after each tick as a render snapshot.
+  class Simulation: public utils::CoreObject {
+    public:
+
+      /// @brief - A modification of the world executed by the
+      /// simulation thread.
+      using Command = std::function<void(cellify::World&)>;
+
+      /**
+       * @brief - Create a new simulation of the input world. The
+       *          thread is not started.
+       * @param world - the world to simulate.
+       */
+      Simulation(cellify::WorldShPtr world);
+
+      /**
+       * @brief - Stop the simulation thread if needed.
+       */
+      ~Simulation();
+
+      /**
+       * @brief - Start the simulation thread. The world is not
+       *          stepped until `setRunning` is called.
+       */
+      void
+      start();
+
+      /**
+       * @brief - Stop the simulation thread and wait for it to
+       *          terminate. Pending commands are executed first.
+       */
+      void
+      stop();
+
+      /**
+       * @brief - Queue a command to be executed by the simulation
+       *          thread before the next tick.
+       * @param cmd - the command to execute.
+       */
+      void
+      post(const Command& cmd);
+
+      /**
+       * @brief - Define whether the world should be stepped. Note
+       *          that this does not pause the world itself, which
+       *          should be done through a command.
+       * @param running - `true` if the world should be stepped.
+       */
+      void
+      setRunning(bool running) noexcept;
+
+      /**
+       * @brief - Define the speed of the simulation: the duration
+       *          of each tick is multiplied by this factor.
+       * @param speed - the speed of the simulation.
+       */
+      void
+      setSpeed(float speed) noexcept;
+
+      /**
+       * @brief - Define whether the simulation runs in fast-forward
+       *          mode: the world is stepped as fast as possible by
+       *          ticks of fixed duration and snapshots are only
+       *          published a few times per second. The mode falls
+       *          back automatically to the regular one in case the
+       *          ticks take longer than the time they simulate.
+       * @param fastForward - `true` to enable the fast-forward.
+       */
+      void
+      setFastForward(bool fastForward) noexcept;
+
+      /**
+       * @brief - Whether the simulation runs in fast-forward mode.
+       *          This changes without notice when the fast-forward
+       *          falls back to the regular mode.
+       * @return - `true` if the fast-forward is active.
+       */
+      bool
+      fastForward() const noexcept;
+
+      /**
+       * @brief - Fetch the latest snapshot published by the
+       *          simulation thread if any. Should only be called
+       *          by the rendering thread.
+       * @return - `true` if a new snapshot is available.
+       */
+      bool
+      acquire() noexcept;
+
+      /**
+       * @brief - Returns the last snapshot acquired. It stays
+       *          valid until the next call to `acquire`.
+       * @return - the last snapshot acquired.
+       */
+      const RenderSnapshot&
+      snapshot() const noexcept;
+
+    private:
+
+      /**
+       * @brief - The loop of the simulation thread: execute the
+       *          commands, step the world and publish snapshots
+       *          until the simulation is stopped.
+       */
+      void
+      simulate();
+
+      /**
+       * @brief - Execute all the commands posted so far.
+       * @return - `true` if at least one command was executed.
+       */
+      bool
+      execute();
+
+      /**
+       * @brief - Describe the current state of the world in the
+       *          back slot of the snapshots and publish it.
+       */
+      void
+      publish();
+
+      /**
+       * @brief - Update the measures of the speed of the simulation
+       *          and fall back from the fast-forward mode in case it
+       *          is slower than real time.
+       * @param now - the current time.
+       * @param steady - `false` if the world is not stepped or
+       *                 if the mode of the simulation changed, in
+       *                 which case the measures restart.
+       * @return - `true` if new measures are available.
+       */
+      bool
+      measure(const std::chrono::steady_clock::time_point& now, bool steady);
+
+    private:
+
+      /**
+       * @brief - The world simulated.
+       */
+      cellify::WorldShPtr m_world;
+
+      /**
+       * @brief - Protects the list of pending commands.
+       */
+      std::mutex m_locker;
+
+      /**
+       * @brief - The commands waiting to be executed.
+       */
+      std::vector<Command> m_commands;
+
+      /**
+       * @brief - Whether the world should be stepped.
+       */
+      std::atomic<bool> m_running;
+
+      /**
+       * @brief - The speed of the simulation.
+       */
+      std::atomic<float> m_speed;
+
+      /**
+       * @brief - Whether the simulation runs in fast-forward mode.
+       */
+      std::atomic<bool> m_fastForward;
+
+      /**
+       * @brief - The start of the current measurement window.
+       */
+      std::chrono::steady_clock::time_point m_window;
+
+      /**
+       * @brief - The time simulated during the current measurement
+       *          window in seconds.
+       */
+      float m_simulated;
+
+      /**
+       * @brief - The number of ticks simulated during the current
+       *          measurement window.
+       */
+      unsigned m_ticks;
+
+      /**
+       * @brief - The ratio between the simulated and wall clock
+       *          times over the last measurement window.
+       */
+      float m_achievedSpeed;
+
+      /**
+       * @brief - The number of ticks per second over the last
+       *          measurement window.
+       */
+      float m_ticksPerSecond;
+
+      /**
+       * @brief - Whether the simulation thread should keep
+       *          running.
+       */
+      std::atomic<bool> m_active;
+
+      /**
+       * @brief - The simulation thread.
+       */
+      std::thread m_thread;
+
+      /**
+       * @brief - The snapshots exchanged between the simulation
+       *          and the rendering threads.
+       */
+      cellify::TripleBuffer<RenderSnapshot> m_snapshots;
+
+      /**
+       * @brief - The index of each chunk holding elements in the
+       *          order they were first met, indexed by the packed
+       *          coordinates of the chunk. Kept from a snapshot to
+       *          the next to avoid allocations.
+       */
+      std::unordered_map<std::uint64_t, unsigned> m_chunkIds;
+
+      /**
+       * @brief - The coordinates of the chunks in the order they
+       *          were first met.
+       */
+      std::vector<ChunkCoord> m_chunkCoords;
+
+      /**
+       * @brief - The chunks sorted rows first, as indices in the
+       *          list of coordinates.
+       */
+      std::vector<unsigned> m_chunkOrder;
+
+      /**
+       * @brief - The position of each chunk in the sorted list of
+       *          chunks of the snapshot.
+       */
+      std::vector<unsigned> m_chunkRanks;
+
+      /**
+       * @brief - The chunk of each element of the world.
+       */
+      std::vector<unsigned> m_chunkOf;
+
+      /**
+       * @brief - The number of elements of each layer in the finest
+       *          bins of density of each chunk, in the order of the
+       *          chunks of the snapshot.
+       */
+      std::vector<unsigned> m_binCounts;
+  };
+
+  using SimulationShPtr = std::shared_ptr<Simulation>;
+}
+
+#endif    /* SIMULATION_HH */
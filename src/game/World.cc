@@ -1,22 +1,158 @@
 
 # include "World.hh"
+# include <limits>
 # include "Influence.hh"
+# include "Ant.hh"
+# include "Colony.hh"
+# include "Food.hh"
+# include "Pheromon.hh"
+
+/// @brief - The offset basis of the FNV-1a hash.
+# define FNV_OFFSET 14695981039346656037ull
+
+/// @brief - The prime of the FNV-1a hash.
+# define FNV_PRIME 1099511628211ull
+
+namespace {
+
+  /**
+   * @brief - Combine the bytes of the input value with the
+   *          hash using the FNV-1a algorithm.
+   * @param h - the current hash.
+   * @param value - the value to combine.
+   * @return - the updated hash.
+   */
+  template <typename T>
+  std::uint64_t
+  combine(std::uint64_t h, const T& value) noexcept {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+
+    for (unsigned id = 0u ; id < sizeof(T) ; ++id) {
+      h ^= bytes[id];
+      h *= FNV_PRIME;
+    }
+
+    return h;
+  }
+
+}
 
 namespace cellify {
 
-  World::World():
+  World::World(const SimulationParams& params):
     utils::CoreObject("world"),
 
+    m_params(params),
+
     m_rng(),
     m_grid(nullptr),
 
     m_paused(true),
-    m_timestamp(zero())
+    m_timestamp(zero()),
+
+    m_profiler(),
+
+    m_checkpoints(newCheckpointDesc()),
+    m_checkpointer(),
+
+    m_journal(nullptr),
+    m_recordStart(0u),
+
+    m_history(),
+    m_removed(),
+
+    m_spawned(),
+    m_actions(),
+
+    m_trajectory(nullptr)
   {
     setService("cellify");
 
     // Create the grid.
-    m_grid = std::make_shared<Grid>(m_rng);
+    m_grid = std::make_shared<Grid>(m_rng, m_params);
+  }
+
+  World::World(const ScenarioDesc& scenario,
+               const SimulationParams& params):
+    utils::CoreObject("world"),
+
+    m_params(params),
+
+    m_rng(scenario.seed),
+    m_grid(nullptr),
+
+    m_paused(true),
+    m_timestamp(zero()),
+
+    m_profiler(),
+
+    m_checkpoints(newCheckpointDesc()),
+    m_checkpointer(),
+
+    m_journal(nullptr),
+    m_recordStart(0u),
+
+    m_history(),
+    m_removed(),
+
+    m_spawned(),
+    m_actions(),
+
+    m_trajectory(nullptr)
+  {
+    setService("cellify");
+
+    // Generate the elements of the scenario.
+    Scenario s(scenario, params);
+    m_grid = std::make_shared<Grid>(s.generate());
+  }
+
+  World::World(const Snapshot& snapshot,
+               const SimulationParams& params):
+    utils::CoreObject("world"),
+
+    m_params(params),
+
+    m_rng(snapshot.desc().seed),
+    m_grid(nullptr),
+
+    m_paused(true),
+    m_timestamp(snapshot.desc().moment),
+
+    m_profiler(),
+
+    m_checkpoints(newCheckpointDesc()),
+    m_checkpointer(),
+
+    m_journal(nullptr),
+    m_recordStart(0u),
+
+    m_history(),
+    m_removed(),
+
+    m_spawned(),
+    m_actions(),
+
+    m_trajectory(nullptr)
+  {
+    setService("cellify");
+
+    m_grid = std::make_shared<Grid>(snapshot.elements());
+  }
+
+  const SimulationParams&
+  World::params() const noexcept {
+    return m_params;
+  }
+
+  TimeStamp
+  World::moment() const noexcept {
+    return m_timestamp;
+  }
+
+  bool
+  World::paused() const noexcept {
+    return m_paused;
   }
 
   const Grid&
@@ -24,6 +160,117 @@ namespace cellify {
     return *m_grid;
   }
 
+  const TickProfiler&
+  World::profiler() const noexcept {
+    return m_profiler;
+  }
+
+  std::uint64_t
+  World::hash() const noexcept {
+    std::uint64_t h = FNV_OFFSET;
+
+    h = combine(h, m_timestamp);
+    h = combine(h, m_grid->size());
+
+    for (unsigned id = 0u ; id < m_grid->size() ; ++id) {
+      const Element& e = m_grid->at(id);
+
+      h = combine(h, e.type());
+      h = combine(h, e.pos().x());
+      h = combine(h, e.pos().y());
+
+      AIShPtr brain = e.brain();
+      if (AntShPtr a = std::dynamic_pointer_cast<Ant>(brain)) {
+        AntState as = a->state();
+        h = combine(h, as.behavior);
+        h = combine(h, as.food);
+      }
+      else if (std::shared_ptr<Colony> c = std::dynamic_pointer_cast<Colony>(brain)) {
+        h = combine(h, c->state().budget);
+      }
+      else if (FoodShPtr f = std::dynamic_pointer_cast<Food>(brain)) {
+        h = combine(h, f->stock());
+      }
+      else if (PheromonShPtr ph = std::dynamic_pointer_cast<Pheromon>(brain)) {
+        h = combine(h, ph->amount());
+      }
+    }
+
+    return h;
+  }
+
+  void
+  World::record(JournalShPtr journal) {
+    journal->open();
+
+    // The state of the world is saved so that the inputs
+    // can be replayed from there.
+    bool running = !m_paused;
+
+    m_journal = nullptr;
+    save(journal->snapshot());
+    m_journal = journal;
+    m_recordStart = m_profiler.ticks();
+
+    if (running) {
+      m_journal->resume(journalTick());
+    }
+  }
+
+  void
+  World::exportTrajectory(TrajectoryShPtr trajectory) {
+    if (m_trajectory != nullptr) {
+      m_trajectory->close();
+    }
+
+    trajectory->open();
+    m_trajectory = trajectory;
+  }
+
+  const Checkpointer&
+  World::checkpointer() const noexcept {
+    return m_checkpointer;
+  }
+
+  void
+  World::setCheckpoints(const CheckpointDesc& desc) noexcept {
+    m_checkpoints = desc;
+  }
+
+  const History&
+  World::history() const noexcept {
+    return m_history;
+  }
+
+  void
+  World::setHistory(const HistoryDesc& desc) noexcept {
+    m_history.reset(desc);
+    m_removed.clear();
+  }
+
+  void
+  World::rewind(unsigned id) {
+    if (m_journal != nullptr) {
+      warn("Rewinding to restore point " + std::to_string(id) + " is not recorded in the journal");
+    }
+
+    TimeStamp moment;
+    Elements elements = m_history.rewind(id, moment, m_rng);
+
+    // The restored elements are paused: they are resumed
+    // in case the world is running.
+    bool running = !m_paused;
+
+    m_grid = std::make_shared<Grid>(elements);
+    m_timestamp = moment;
+    m_removed.clear();
+
+    m_paused = true;
+    if (running) {
+      resumeElements();
+    }
+  }
+
   void
   World::step(float tDelta) {
     // Disable step in case the world is in pause.
@@ -31,45 +278,129 @@ namespace cellify {
       return;
     }
 
-    // The input delat is expressed in seconds so
-    // we need to convert that in milliseconds.
-    m_timestamp += 1000.0f * tDelta;
+    m_profiler.beginTick();
 
-    StepInfo si{
-      m_rng,        // rng
+    {
+      ScopedPhase tick(m_profiler, Phase::Tick);
 
-      m_timestamp,  // moment
-      tDelta,       // elapsed
+      // The input delat is expressed in seconds so
+      // we need to convert that in milliseconds.
+      m_timestamp += 1000.0f * tDelta;
 
-      *m_grid,      // grid
+      // The lists of the previous tick are reused.
+      m_spawned.clear();
+      m_actions.clear();
 
-      Elements(),   // elements
+      StepInfo si{
+        m_rng,        // rng
+        m_params,     // params
 
-      Influences()  // actions
-    };
+        m_timestamp,  // moment
+        tDelta,       // elapsed
 
-    // Simulate elements.
-    for (unsigned id = 0u ; id < m_grid->size() ; ++id) {
-      m_grid->at(id).step(si);
+        *m_grid,      // grid
+
+        m_spawned,    // elements
+
+        m_actions     // actions
+      };
+
+      // Simulate elements.
+      {
+        ScopedPhase sp(m_profiler, Phase::Step);
+
+        for (unsigned id = 0u ; id < m_grid->size() ; ++id) {
+          m_grid->at(id).step(si);
+        }
+
+        m_profiler.count(Counter::ElementsStepped, m_grid->size());
+      }
+
+      // Process influences.
+      {
+        ScopedPhase sp(m_profiler, Phase::Spawn);
+
+        for (unsigned id = 0u ; id < si.spawned.size() ; ++id) {
+          m_grid->spawn(si.spawned[id]);
+        }
+
+        m_profiler.count(Counter::Spawns, si.spawned.size());
+      }
+
+      {
+        ScopedPhase sp(m_profiler, Phase::Influence);
+
+        for (unsigned id = 0u ; id < si.actions.size() ; ++id) {
+          si.actions[id]->apply();
+        }
+
+        m_profiler.count(Counter::Influences, si.actions.size());
+
+        // Release the influences and the spawned elements:
+        // the lists keep their storage for the next tick.
+        m_actions.clear();
+        m_spawned.clear();
+      }
+
+      // Perform the update of the grid (this step
+      // includes deleting the elements marked for
+      // deletion, etc).
+      {
+        ScopedPhase sp(m_profiler, Phase::Update);
+        Serials removed = m_grid->update();
+
+        if (m_history.enabled()) {
+          m_removed.insert(m_removed.end(), removed.cbegin(), removed.cend());
+        }
+      }
+
+      if (m_journal != nullptr) {
+        m_journal->step(journalTick(), tDelta, hash());
+      }
+
+      if (m_trajectory != nullptr) {
+        ScopedPhase sp(m_profiler, Phase::Export);
+        m_trajectory->push(m_profiler.ticks(), m_timestamp, m_grid->elements());
+      }
+
+      // The world is consistent at this point: this is
+      // where checkpoints are taken.
+      if (m_checkpoints.interval > 0u && (m_profiler.ticks() + 1u) % m_checkpoints.interval == 0u) {
+        ScopedPhase sp(m_profiler, Phase::Checkpoint);
+        checkpoint(m_checkpoints.file);
+      }
+
+      if (m_history.enabled() && (m_profiler.ticks() + 1u) % m_history.desc().interval == 0u) {
+        ScopedPhase sp(m_profiler, Phase::History);
+
+        m_history.capture(m_timestamp, m_rng, m_grid->elements(), m_removed);
+        m_removed.clear();
+      }
     }
 
-    // Process influences.
-    for (unsigned id = 0u ; id < si.spawned.size() ; ++id) {
-      m_grid->spawn(si.spawned[id]);
+    m_profiler.endTick();
+  }
+
+  void
+  World::pause() {
+    if (!m_paused && m_journal != nullptr) {
+      m_journal->pause(journalTick());
     }
 
-    for (unsigned id = 0u ; id < si.actions.size() ; ++id) {
-      si.actions[id]->apply();
+    pauseElements();
+  }
+
+  void
+  World::resume() {
+    if (m_paused && m_journal != nullptr) {
+      m_journal->resume(journalTick());
     }
 
-    // Perform the update of the grid (this step
-    // includes deleting the elements marked for
-    // deletion, etc).
-    m_grid->update();
+    resumeElements();
   }
 
   void
-  World::pause() {
+  World::pauseElements() {
     // Pause each element if needed.
     if (m_paused) {
       return;
@@ -83,7 +414,7 @@ namespace cellify {
   }
 
   void
-  World::resume() {
+  World::resumeElements() {
     // Resume each element if needed.
     if (!m_paused) {
       return;
@@ -97,17 +428,18 @@ namespace cellify {
   }
 
   unsigned
-  World::count(const Tile& tile) const noexcept {
-    unsigned count = 0u;
+  World::journalTick() const noexcept {
+    return m_profiler.ticks() - m_recordStart;
+  }
 
-    // Simulate elements.
-    for (unsigned id = 0u ; id < m_grid->size() ; ++id) {
-      if (tile == m_grid->at(id).type()) {
-        ++count;
-      }
-    }
+  unsigned
+  World::count(const Tile& tile) const noexcept {
+    return m_grid->count(tile);
+  }
 
-    return count;
+  const Population&
+  World::population() const noexcept {
+    return m_grid->population();
   }
 
   bool
@@ -136,7 +468,62 @@ namespace cellify {
 
     m_grid->spawn(e);
 
+    if (m_journal != nullptr) {
+      m_journal->spawn(journalTick(), p, tile);
+    }
+
     return true;
   }
 
+  void
+  World::save(const std::string& file) {
+    // Elements are paused so that the time elapsed since
+    // their last move is recorded.
+    bool running = !m_paused;
+
+    write(file, reseed());
+
+    if (running) {
+      resumeElements();
+    }
+  }
+
+  bool
+  World::checkpoint(const std::string& file) {
+    int seed = reseed();
+
+    // The writer runs in a copy of the process: pausing
+    // the world there does not affect this one. Pausing an
+    // element only updates its fields so nothing allocates.
+    return m_checkpointer.start(
+      file,
+      [this, seed](int fd, char* buffer, unsigned capacity) {
+        pauseElements();
+        return writeSnapshot(fd, SnapshotDesc{m_timestamp, seed}, m_grid->elements(), buffer, capacity);
+      }
+    );
+  }
+
+  int
+  World::reseed() noexcept {
+    if (m_journal != nullptr) {
+      m_journal->reseed(journalTick());
+    }
+
+    int seed = m_rng.rndInt(0, std::numeric_limits<int>::max());
+    m_rng = utils::RNG(seed);
+
+    return seed;
+  }
+
+  void
+  World::write(const std::string& file, int seed) {
+    // The pause is not recorded in the journal: it has
+    // no effect on the simulation.
+    pauseElements();
+
+    Snapshot s(file);
+    s.save(SnapshotDesc{m_timestamp, seed}, m_grid->elements());
+  }
+
 }
@@ -3,6 +3,14 @@
 
 # include <memory>
 # include "Grid.hh"
+# include "SimulationParams.hh"
+# include "TickProfiler.hh"
+# include "Scenario.hh"
+# include "Snapshot.hh"
+# include "Checkpointer.hh"
+# include "Journal.hh"
+# include "History.hh"
+# include "Trajectory.hh"
 
 namespace cellify {
 
@@ -10,9 +18,54 @@ namespace cellify {
     public:
 
       /**
-       * @brief - Creates a new infinite grid with no elements.
+       * @brief - Creates a new infinite grid with the default
+       *          elements.
+       * @param params - the parameters of the simulation.
        */
-      World();
+      World(const SimulationParams& params = newSimulationParams());
+
+      /**
+       * @brief - Creates a new world populated with the elements
+       *          generated from the input scenario. The seed of
+       *          the scenario is also used for the simulation so
+       *          that runs are reproducible.
+       * @param scenario - the description of the scenario.
+       * @param params - the parameters of the simulation.
+       */
+      World(const ScenarioDesc& scenario,
+            const SimulationParams& params = newSimulationParams());
+
+      /**
+       * @brief - Creates a new world from a snapshot. The world
+       *          is paused. The parameters of the simulation are
+       *          not part of the snapshot.
+       * @param snapshot - the snapshot to restore, which should
+       *                   already be loaded.
+       * @param params - the parameters of the simulation.
+       */
+      World(const Snapshot& snapshot,
+            const SimulationParams& params = newSimulationParams());
+
+      /**
+       * @brief - Returns the parameters of the simulation.
+       * @return - the parameters of the simulation.
+       */
+      const SimulationParams&
+      params() const noexcept;
+
+      /**
+       * @brief - Returns the time elapsed in the world.
+       * @return - the current moment of the world.
+       */
+      TimeStamp
+      moment() const noexcept;
+
+      /**
+       * @brief - Whether the world is paused.
+       * @return - `true` if the world is paused.
+       */
+      bool
+      paused() const noexcept;
 
       /**
        * @brief - Returns the grid attached to the world.
@@ -21,6 +74,64 @@ namespace cellify {
       const Grid&
       grid() const noexcept;
 
+      /**
+       * @brief - Returns the profiler measuring the duration of
+       *          the phases of each tick of the world.
+       * @return - the profiler of the world.
+       */
+      const TickProfiler&
+      profiler() const noexcept;
+
+      /**
+       * @brief - Returns the object writing the checkpoints of
+       *          the world. It can be used to query statistics
+       *          about the pauses they caused.
+       * @return - the checkpointer of the world.
+       */
+      const Checkpointer&
+      checkpointer() const noexcept;
+
+      /**
+       * @brief - Define the periodic checkpoints of the world.
+       *          They are taken at the end of a tick, once all
+       *          the elements are updated.
+       * @param desc - the description of the checkpoints.
+       */
+      void
+      setCheckpoints(const CheckpointDesc& desc) noexcept;
+
+      /**
+       * @brief - Returns the history of the world, which can be
+       *          used to list the restore points or to bisect the
+       *          moment when a behavior changed.
+       * @return - the history of the world.
+       */
+      const History&
+      history() const noexcept;
+
+      /**
+       * @brief - Define the history of the world. Restore points
+       *          are captured at the end of a tick and keep a copy
+       *          of the random number generator: unlike checkpoints
+       *          they don't change the course of the simulation.
+       *          Any existing restore point is removed.
+       * @param desc - the description of the history.
+       */
+      void
+      setHistory(const HistoryDesc& desc) noexcept;
+
+      /**
+       * @brief - Restore the world to one of the restore points
+       *          of its history. The restore points after it are
+       *          kept until the simulation resumes and captures
+       *          a new one, so that it is possible to move back
+       *          and forth. Rewinding is not recorded in the
+       *          journal.
+       * @param id - the index of the restore point.
+       */
+      void
+      rewind(unsigned id);
+
       /**
        * @brief - Used to move one step ahead in time in this
        *          world, given that `tDelta` represents the
@@ -58,6 +169,86 @@ namespace cellify {
       unsigned
       count(const Tile& tile) const noexcept;
 
+      /**
+       * @brief - The number of elements of each type and of ants
+       *          with each behavior currently in the world. This
+       *          does not depend on the size of the world.
+       * @return - the population of the world.
+       */
+      const Population&
+      population() const noexcept;
+
+      /**
+       * @brief - Save the world to a snapshot file. The random
+       *          number generator is reseeded with a seed drawn
+       *          from itself and stored in the snapshot: its
+       *          internal state is not accessible but this way
+       *          a world restored from the snapshot produces the
+       *          exact same random sequence as this one.
+       * @param file - the path to the snapshot.
+       */
+      void
+      save(const std::string& file);
+
+      /**
+       * @brief - Save the world to a snapshot file in the
+       *          background: the world is only paused for the
+       *          time needed to fork the process. Just like for
+       *          `save` the random number generator is reseeded,
+       *          and this happens even if the checkpoint is
+       *          skipped so that the simulation does not depend
+       *          on the speed at which checkpoints are written.
+       * @param file - the path to the snapshot.
+       * @return - `false` if the checkpoint was skipped as the
+       *           previous one is still being written or it
+       *           could not be started.
+       */
+      bool
+      checkpoint(const std::string& file);
+
+      /**
+       * @brief - Draw a new seed from the random number generator
+       *          and reseed it with this value. This is used when
+       *          saving the world and when replaying a journal.
+       * @return - the new seed.
+       */
+      int
+      reseed() noexcept;
+
+      /**
+       * @brief - Compute a hash of the state of the world: the
+       *          time of the simulation, the position and type of
+       *          the elements and the main properties of their
+       *          behavior. Two worlds with the same hash are very
+       *          likely in the same state.
+       * @return - the hash of the world.
+       */
+      std::uint64_t
+      hash() const noexcept;
+
+      /**
+       * @brief - Start recording the inputs of the world in the
+       *          journal. The current state of the world is saved
+       *          in the snapshot attached to the journal so that
+       *          the session can be replayed. Each step records
+       *          the hash of the world which makes the recording
+       *          slower.
+       * @param journal - the journal to write inputs to.
+       */
+      void
+      record(JournalShPtr journal);
+
+      /**
+       * @brief - Start exporting the state of the ants at the
+       *          end of each tick to the input trajectory. The
+       *          trajectory is opened by this method and closed
+       *          when the world is destroyed or when another one
+       *          is attached.
+       * @param trajectory - the trajectory to export to.
+       */
+      void
+      exportTrajectory(TrajectoryShPtr trajectory);
+
       /**
        * @brief - Generate a new element with the specified type
        *          at the input position.
@@ -71,6 +262,45 @@ namespace cellify {
 
     private:
 
+      /**
+       * @brief - Pause the elements of the world without recording
+       *          it in the journal.
+       */
+      void
+      pauseElements();
+
+      /**
+       * @brief - Resume the elements of the world without recording
+       *          it in the journal.
+       */
+      void
+      resumeElements();
+
+      /**
+       * @brief - The tick to record in the journal: a replay
+       *          starts from the snapshot taken when recording
+       *          started, so ticks are counted from there.
+       * @return - the number of ticks since recording started.
+       */
+      unsigned
+      journalTick() const noexcept;
+
+      /**
+       * @brief - Pause the world and write it to a snapshot file.
+       * @param file - the path to the snapshot.
+       * @param seed - the seed of the random number generator to
+       *               save in the snapshot.
+       */
+      void
+      write(const std::string& file, int seed);
+
+    private:
+
+      /**
+       * @brief - The tuning values of the simulation.
+       */
+      SimulationParams m_params;
+
       /**
        * @brief - The random number generator used by this
        *          world.
@@ -98,6 +328,66 @@ namespace cellify {
        *          NOTE: This value is expressed in milliseconds.
        */
       float m_timestamp;
+
+      /**
+       * @brief - Measures the duration of the phases of each
+       *          tick along with some counters describing the
+       *          work performed.
+       */
+      TickProfiler m_profiler;
+
+      /**
+       * @brief - The description of the periodic checkpoints.
+       */
+      CheckpointDesc m_checkpoints;
+
+      /**
+       * @brief - Writes the checkpoints in the background.
+       */
+      Checkpointer m_checkpointer;
+
+      /**
+       * @brief - The journal recording the inputs of the world if
+       *          any.
+       */
+      JournalShPtr m_journal;
+
+      /**
+       * @brief - The number of ticks simulated by the world when
+       *          the recording started.
+       */
+      unsigned m_recordStart;
+
+      /**
+       * @brief - The in-memory history of the world.
+       */
+      History m_history;
+
+      /**
+       * @brief - The serials of the elements removed since the
+       *          last restore point was captured.
+       */
+      Serials m_removed;
+
+      /**
+       * @brief - The elements spawned during the current tick.
+       *          The list is cleared rather than reallocated at
+       *          each tick.
+       */
+      Elements m_spawned;
+
+      /**
+       * @brief - The influences produced during the current tick.
+       *          The list is cleared rather than reallocated at
+       *          each tick.
+       */
+      Influences m_actions;
+
+      /**
+       * @brief - The trajectory to which the state of the ants
+       *          is exported, if any.
+       */
+      TrajectoryShPtr m_trajectory;
   };
 
   using WorldShPtr = std::shared_ptr<World>;
@@ -3,49 +3,34 @@
 # include <cxxabi.h>
 # include "AStar.hh"
 # include "FoodInteraction.hh"
+# include "Logging.hh"
 
-/// @brief - The vision frustim of an ant: defines
-/// how far it can perceive blocks. It is also used
-/// to define how far a random target can be picked
-/// from the current ant's position.
-# define ANT_VISION_RADIUS 5
-
-/// @brief - The interval between emitting a new
-/// pheromone. Expressed in milliseconds.
-# define PHEROMON_SPAWN_INTERVAL 500
-
-/// @brief - The amount of food that the ant can
-/// carry in one go.
-# define ANT_CARGO_SPACE 5.0f
-
-/// @brief - The minium evaporation rate for pheromons.
-# define PHEROMON_EVAPORATION_RATE 0.15f
+/// @brief - Helps with debugging by prepending the behavior
+/// to any log. The message is only built in case verbose
+/// logs are enabled.
+# define ANT_LOG(message) CELLIFY_VERBOSE("[" + behaviorToString(m_behavior) + "] " + message)
 
 namespace {
 
-  std::vector<int>
-  filterPheromons(const cellify::Info& info,
-                  const std::vector<int>& items,
-                  const cellify::Scent& scent) noexcept
-  {
-    std::vector<int> filtered;
-
-    for (unsigned id = 0u ; id < items.size() ; ++id) {
-      const cellify::Element* el = reinterpret_cast<const cellify::Element*>(info.locator.get(items[id]));
-      if (el->type() != cellify::Tile::Pheromon) {
-        continue;
-      }
-
-      // Only consider pheromon with the specified scent.
-      cellify::Scent sc = *reinterpret_cast<const cellify::Scent*>(el->data());
-      if (sc != scent) {
-        continue;
-      }
-
-      filtered.push_back(items[id]);
-    }
-
-    return filtered;
+  /**
+   * @brief - Whether two states of an ant are identical.
+   * @param lhs - the first state.
+   * @param rhs - the second state.
+   * @return - `true` if the states are the same.
+   */
+  bool
+  same(const cellify::AntState& lhs, const cellify::AntState& rhs) noexcept {
+    return lhs.behavior == rhs.behavior &&
+           lhs.lastPheromon == rhs.lastPheromon &&
+           lhs.hasTarget == rhs.hasTarget &&
+           lhs.randomTarget == rhs.randomTarget &&
+           lhs.targetX == rhs.targetX &&
+           lhs.targetY == rhs.targetY &&
+           lhs.lastX == rhs.lastX &&
+           lhs.lastY == rhs.lastY &&
+           lhs.dirX == rhs.dirX &&
+           lhs.dirY == rhs.dirY &&
+           lhs.food == rhs.food;
   }
 
 }
@@ -74,14 +59,54 @@ namespace cellify {
     m_behavior(Behavior::Wander),
     m_lastPheromon(),
 
-    m_target(nullptr),
+    m_target(),
+    m_hasTarget(false),
     m_randomTarget(false),
     m_lastPos(),
     m_dir(),
 
-    m_food(0.0f)
+    m_food(0.0f),
+
+    m_visible()
   {}
 
+  Ant::Ant(const utils::Uuid& uuid, const AntState& state):
+    AI("ant-" + uuid.toString()),
+
+    m_behavior(state.behavior),
+    m_lastPheromon(state.lastPheromon),
+
+    m_target(state.targetX, state.targetY),
+    m_hasTarget(state.hasTarget),
+    m_randomTarget(state.randomTarget),
+    m_lastPos(state.lastX, state.lastY),
+    m_dir(state.dirX, state.dirY),
+
+    m_food(state.food),
+
+    m_visible()
+  {}
+
+  AntState
+  Ant::state() const noexcept {
+    return AntState{
+      m_behavior,                                  // behavior
+      m_lastPheromon,                              // lastPheromon
+
+      m_hasTarget,                                 // hasTarget
+      m_randomTarget,                              // randomTarget
+      (m_hasTarget ? m_target.x() : 0),            // targetX
+      (m_hasTarget ? m_target.y() : 0),            // targetY
+
+      m_lastPos.x(),                               // lastX
+      m_lastPos.y(),                               // lastY
+      m_dir.x(),                                   // dirX
+      m_dir.y(),                                   // dirY
+
+      m_food                                       // food
+    };
+  }
+
   Behavior
   Ant::mode() const noexcept {
     return m_behavior;
@@ -100,30 +125,31 @@ namespace cellify {
 
   void
   Ant::step(Info& info) {
-    // Check the behavior and handle the definition of a new
-    // target.
-    std::vector<int> items = info.locator.visible(info.pos, ANT_VISION_RADIUS);;
+    AntState before = state();
 
+    // Check the behavior and handle the definition of a new
+    // target. Each behavior queries the surroundings for the
+    // elements it is interested in.
     switch (m_behavior) {
       case Behavior::Food:
-        food(info, items);
+        food(info);
         break;
       case Behavior::Return:
-        returnHome(info, items);
+        returnHome(info);
         break;
       case Behavior::Deposit:
-        deposit(info, items);
+        deposit(info);
         break;
       default:
         warn("Unknown behavior " + behaviorToString(m_behavior));
         [[fallthrough]];
       case Behavior::Wander:
-        wander(info, items);
+        wander(info);
         break;
     }
 
     // Emit a pheromon if possible.
-    if (m_lastPheromon + millisecondsToDuration(PHEROMON_SPAWN_INTERVAL) < info.moment) {
+    if (m_lastPheromon + millisecondsToDuration(info.params.pheromonSpawnInterval) < info.moment) {
       spawnPheromon(info);
     }
 
@@ -132,6 +158,10 @@ namespace cellify {
       m_dir = info.pos - m_lastPos;
       m_lastPos = info.pos;
     }
+
+    if (!same(before, state())) {
+      info.changed = true;
+    }
   }
 
   bool
@@ -153,10 +183,10 @@ namespace cellify {
 
     float a = fi->amount(body);
     if (a > 0.0f) {
-      debug("Gathered " + std::to_string(a) + " food");
+      CELLIFY_DEBUG("Gathered " + std::to_string(a) + " food");
     }
     else {
-      debug("Deposit " + std::to_string(-a) + " food");
+      CELLIFY_DEBUG("Deposit " + std::to_string(-a) + " food");
     }
 
     m_food += a;
@@ -164,33 +194,28 @@ namespace cellify {
     return true;
   }
 
-  void
-  Ant::log(const std::string& message) const noexcept
-  {
-    // Helps with debugging by prepending the behavior to any log.
-    verbose("[" + behaviorToString(m_behavior) + "] " + message);
-  }
-
   bool
   Ant::generatePath(Info& info) {
     // Pick a random target and find a path to it if needed.
     m_randomTarget = false;
-    if (m_target == nullptr) {
-      int x = info.rng.rndInt(info.pos.x() - ANT_VISION_RADIUS, info.pos.x() + ANT_VISION_RADIUS);
-      int y = info.rng.rndInt(info.pos.y() - ANT_VISION_RADIUS, info.pos.y() + ANT_VISION_RADIUS);
+    if (!m_hasTarget) {
+      int x = info.rng.rndInt(info.pos.x() - info.params.antVisionRadius, info.pos.x() + info.params.antVisionRadius);
+      int y = info.rng.rndInt(info.pos.y() - info.params.antVisionRadius, info.pos.y() + info.params.antVisionRadius);
 
-      m_target = std::make_shared<utils::Point2i>(x, y);
+      m_target = utils::Point2i(x, y);
+      m_hasTarget = true;
       m_randomTarget = true;
     }
 
-    AStar astar(info.pos, *m_target, info.locator);
+    AStar astar(info.pos, m_target, info.locator);
     bool ok = astar.findPath(info.path, -1.0f, false);
+    info.changed = true;
     if (!ok) {
-      warn("Failed to find a path for the and");
+      CELLIFY_WARN("Failed to find a path for the and");
     }
 
     if (ok) {
-      log("Moving from " + info.path.begin().toString() + " to " + info.path.end().toString());
+      ANT_LOG("Moving from " + info.path.begin().toString() + " to " + info.path.end().toString());
     }
 
     return ok;
@@ -215,7 +240,8 @@ namespace cellify {
     // Small randomness in the amount and evaporation rate
     // of each pheromon.
     float a = info.rng.rndFloat(1.0f, 1.1f);
-    float e = info.rng.rndFloat(PHEROMON_EVAPORATION_RATE, PHEROMON_EVAPORATION_RATE + 0.1f * PHEROMON_EVAPORATION_RATE);
+    float rate = info.params.pheromonEvaporationRate;
+    float e = info.rng.rndFloat(rate, rate + 0.1f * rate);
 
     info.spawned.push_back(Animat{
       info.pos,
@@ -228,18 +254,27 @@ namespace cellify {
   }
 
   void
-  Ant::wander(Info& info, const std::vector<int>& items) {
-    followPheromonToTarget(info, items, Scent::Food, Tile::Food, Behavior::Food);
+  Ant::wander(Info& info) {
+    followPheromonToTarget(info, Scent::Food, Tile::Food, Behavior::Food);
   }
 
   void
-  Ant::food(Info& info, const std::vector<int>& items) {
+  Ant::food(Info& info) {
     // We don't have to do anything as long as we didn't
     // reach the food. Then we have to go back home.
     if (!info.path.empty()) {
       return;
     }
 
+    // Only the elements on the target are of interest: a
+    // radius of one cell keeps exactly these.
+    VisibilityQuery q = newVisibilityQuery(
+      m_target,
+      1.0f,
+      tileMask(Tile::Food) | tileMask(Tile::Ant)
+    );
+    info.locator.visible(q, m_visible);
+
     // Fetch the food deposit that we reached, and our
     // own body. We consider that if an element has the
     // same kind and position as the target, it is the
@@ -249,18 +284,18 @@ namespace cellify {
 
     unsigned id = 0u;
     unsigned found = 0u;
-    while (id < items.size() && found < 2u) {
-      const Element* el = reinterpret_cast<const Element*>(info.locator.get(items[id]));
+    while (id < m_visible.size() && found < 2u) {
+      const Element* el = reinterpret_cast<const Element*>(info.locator.get(m_visible[id]));
 
       // Handle the deposit.
-      if (el->type() == Tile::Food && el->pos() == *m_target) {
+      if (el->type() == Tile::Food && el->pos() == m_target) {
         deposit = const_cast<Element*>(el);
         ++found;
       }
 
       // Handle the body: we add a test on the identifier
       // as we have it.
-      if (el->type() == Tile::Ant && el->pos() == *m_target && el->uuid() == uuid()) {
+      if (el->type() == Tile::Ant && el->pos() == m_target && el->uuid() == uuid()) {
         body = const_cast<Element*>(el);
         ++found;
       }
@@ -278,46 +313,55 @@ namespace cellify {
 
     // Create an influence to pick up some food.
     info.actions.push_back(std::make_shared<FoodInteraction>(
-      deposit, ANT_CARGO_SPACE, body
+      deposit, info.params.antCargoSpace, body
     ));
 
-    log("Reached food at " + info.pos.toString() + ", going back home");
+    ANT_LOG("Reached food at " + info.pos.toString() + ", going back home");
 
     // And change the behavior.
     m_behavior = Behavior::Return;
   }
 
   void
-  Ant::returnHome(Info& info, const std::vector<int>& items) {
-    followPheromonToTarget(info, items, Scent::Home, Tile::Colony, Behavior::Deposit);
+  Ant::returnHome(Info& info) {
+    followPheromonToTarget(info, Scent::Home, Tile::Colony, Behavior::Deposit);
   }
 
   void
-  Ant::deposit(Info& info, const std::vector<int>& items) {
+  Ant::deposit(Info& info) {
     // We don't have to do anything as long as we didn't
     // reach the colony. Then we have to go back home.
     if (!info.path.empty()) {
       return;
     }
 
+    // Only the elements on the target are of interest: a
+    // radius of one cell keeps exactly these.
+    VisibilityQuery q = newVisibilityQuery(
+      m_target,
+      1.0f,
+      tileMask(Tile::Colony) | tileMask(Tile::Ant)
+    );
+    info.locator.visible(q, m_visible);
+
     // Fetch the food deposit that we got.
     Element* colony = nullptr;
     Element* body = nullptr;
 
     unsigned id = 0u;
     unsigned found = 0u;
-    while (id < items.size() && found < 2u) {
-      const Element* el = reinterpret_cast<const Element*>(info.locator.get(items[id]));
+    while (id < m_visible.size() && found < 2u) {
+      const Element* el = reinterpret_cast<const Element*>(info.locator.get(m_visible[id]));
 
       // Handle the colony.
-      if (el->type() == Tile::Colony && el->pos() == *m_target) {
+      if (el->type() == Tile::Colony && el->pos() == m_target) {
         colony = const_cast<Element*>(el);
         ++found;
       }
 
       // Handle the body: we add a test on the identifier
       // as we have it.
-      if (el->type() == Tile::Ant && el->pos() == *m_target && el->uuid() == uuid()) {
+      if (el->type() == Tile::Ant && el->pos() == m_target && el->uuid() == uuid()) {
         body = const_cast<Element*>(el);
         ++found;
       }
@@ -327,10 +371,10 @@ namespace cellify {
 
     // Create an influence to deposit some food.
     info.actions.push_back(std::make_shared<FoodInteraction>(
-      body, ANT_CARGO_SPACE, colony
+      body, info.params.antCargoSpace, colony
     ));
 
-    log("Reached colony at " + info.pos.toString() + ", going back to wander");
+    ANT_LOG("Reached colony at " + info.pos.toString() + ", going back to wander");
 
     // And change the behavior.
     m_behavior = Behavior::Wander;
@@ -338,7 +382,6 @@ namespace cellify {
 
   bool
   Ant::findClosest(Info& info,
-                   const std::vector<int>& items,
                    const Tile& tile,
                    utils::Point2i& out) const noexcept
   {
@@ -348,8 +391,8 @@ namespace cellify {
 
     // Check for for elements of the input type and find
     // the closest one.
-    for (unsigned id = 0u ; id < items.size() ; ++id) {
-      const Element* el = reinterpret_cast<const Element*>(info.locator.get(items[id]));
+    for (unsigned id = 0u ; id < m_visible.size() ; ++id) {
+      const Element* el = reinterpret_cast<const Element*>(info.locator.get(m_visible[id]));
 
       if (el->type() != tile) {
         continue;
@@ -358,7 +401,7 @@ namespace cellify {
       found = true;
       float dx = el->pos().x() - info.pos.x();
       float dy = el->pos().y() - info.pos.y();
-      float dist = std::sqrt(dx * dx + dy * dy);
+      float dist = dx * dx + dy * dy;
 
       if (dist > d) {
         continue;
@@ -373,29 +416,27 @@ namespace cellify {
 
   bool
   Ant::aggregatePheromomns(Info& info,
-                           const std::vector<int>& items,
-                           const Scent& scent,
                            utils::Point2i& out,
                            bool& reverse) const noexcept
   {
     out = utils::Point2i(0, 0);
 
-    // Filter to keep only pheromons.
-    std::vector<int> ph = filterPheromons(info, items, scent);
-
-    // In case there are none, we couldn't find a target.
-    if (ph.empty()) {
-      return false;
-    }
-
     // Aggregate the average position of the pheromons. We
     // will only consider pheromons that are pointing in
     // the general direction of the ant.
     utils::Point2f temp;
+    unsigned seen = 0u;
     unsigned count = 0u;
 
-    for (unsigned id = 0u ; id < ph.size() ; ++id) {
-      const Element* el = reinterpret_cast<const Element*>(info.locator.get(ph[id]));
+    for (unsigned id = 0u ; id < m_visible.size() ; ++id) {
+      const Element* el = reinterpret_cast<const Element*>(info.locator.get(m_visible[id]));
+
+      // The visible elements only contain pheromons with
+      // the input scent, along with the targets.
+      if (el->type() != Tile::Pheromon) {
+        continue;
+      }
+      ++seen;
 
       // Discard pheromons that are not in the general way
       // the ant is moving. Also, discard pheromons exactly
@@ -416,6 +457,11 @@ namespace cellify {
       ++count;
     }
 
+    // In case there are none, we couldn't find a target.
+    if (seen == 0u) {
+      return false;
+    }
+
     // In case all pheromons were discarding, allow the ant
     // to change direction.
     if (count == 0u) {
@@ -470,7 +516,7 @@ namespace cellify {
       out.x() += sx;
       out.y() += sy;
 
-      log("Moved obstructed target " + old.toString() + " to " + out.toString());
+      ANT_LOG("Moved obstructed target " + old.toString() + " to " + out.toString());
     }
 
     return true;
@@ -478,23 +524,34 @@ namespace cellify {
 
   void
   Ant::followPheromonToTarget(Info& info,
-                              const std::vector<int>& items,
                               const Scent& scent,
                               const Tile& tile,
                               const Behavior& next)
   {
+    // Fetch in a single pass the targets and the pheromons
+    // with the input scent: other elements are filtered by
+    // the locator.
+    VisibilityQuery q = newVisibilityQuery(
+      info.pos,
+      info.params.antVisionRadius,
+      tileMask(tile) | tileMask(Tile::Pheromon)
+    );
+    q.kind = static_cast<int>(scent);
+    info.locator.visible(q, m_visible);
+
     // Check for for colonies and find the closest one.
     utils::Point2i best;
-    if (findClosest(info, items, tile, best)) {
+    if (findClosest(info, tile, best)) {
       // In case the path is not yet directed towards
       // this colony, generate a new path.
       if (!info.path.empty() && info.path.end() == best) {
         return;
       }
 
-      log("Found " + tileToString(tile) + " at " + best.toString());
+      ANT_LOG("Found " + tileToString(tile) + " at " + best.toString());
 
-      m_target = std::make_shared<utils::Point2i>(best.x(), best.y());
+      m_target = best;
+      m_hasTarget = true;
       generatePath(info);
 
       // Update the behavior.
@@ -515,7 +572,7 @@ namespace cellify {
     // for food.
     utils::Point2i avg;
     bool reverse = false;
-    if (!aggregatePheromomns(info, items, scent, avg, reverse)) {
+    if (!aggregatePheromomns(info, avg, reverse)) {
       // In case we have a valid path, continue on it.
       if (!info.path.empty()) {
         return;
@@ -524,15 +581,15 @@ namespace cellify {
       // Otherwise, determine whether we should reverse
       // the direction of the ant.
       if (reverse) {
-        log("Relevant " + scentToString(scent) + " pheromon(s) are behind the ant (out of " + std::to_string(items.size()) + " element(s)), choosing random position");
+        ANT_LOG("Relevant " + scentToString(scent) + " pheromon(s) are behind the ant (out of " + std::to_string(m_visible.size()) + " element(s)), choosing random position");
         m_dir = -m_dir;
         return;
       }
 
       // No pheromons, pick a random location.
-      log("No relevant " + scentToString(scent) + " pheromon(s) seen by ant (out of " + std::to_string(items.size()) + " element(s)), choosing random position");
+      ANT_LOG("No relevant " + scentToString(scent) + " pheromon(s) seen by ant, choosing random position");
 
-      m_target.reset();
+      m_hasTarget = false;
       generatePath(info);
 
       return;
@@ -541,13 +598,14 @@ namespace cellify {
     // In case the average is the same as the target (which
     // means we didn't find a new pheromon) continue on the
     // same path.
-    if (m_target != nullptr && avg == *m_target) {
+    if (m_hasTarget && avg == m_target) {
       return;
     }
 
-    log("Picked target " + avg.toString() + " to return to from " + std::to_string(items.size()) + " visible item(s)");
+    ANT_LOG("Picked target " + avg.toString() + " to return to from " + std::to_string(m_visible.size()) + " visible item(s)");
 
-    m_target = std::make_shared<utils::Point2i>(avg.x(), avg.y());
+    m_target = avg;
+    m_hasTarget = true;
     generatePath(info);
   }
 
@@ -2,6 +2,7 @@
 # define   ANT_HH
 
 # include <memory>
+# include <vector>
 # include <core_utils/Uuid.hh>
 # include "AI.hh"
 # include "Time.hh"
@@ -16,7 +17,8 @@ namespace cellify {
     Wander,
     Food,
     Return,
-    Deposit
+    Deposit,
+    Count
   };
 
   /**
@@ -27,6 +29,38 @@ namespace cellify {
   std::string
   behaviorToString(const Behavior& b) noexcept;
 
+  /// @brief - The internal state of an ant, as persisted in a
+  /// snapshot of the world. It is a plain structure so that it
+  /// can be copied as is to and from a file.
+  struct AntState {
+    // The current behavior of the ant.
+    Behavior behavior;
+
+    // The last time a pheromon was laid.
+    TimeStamp lastPheromon;
+
+    // Whether the ant currently has a target.
+    bool hasTarget;
+
+    // Whether the target was picked randomly.
+    bool randomTarget;
+
+    // The coordinates of the target if any.
+    int targetX;
+    int targetY;
+
+    // The last position of the ant.
+    int lastX;
+    int lastY;
+
+    // The direction of the ant.
+    int dirX;
+    int dirY;
+
+    // The food carried by the ant.
+    float food;
+  };
+
   class Ant: public AI {
     public:
 
@@ -36,6 +70,21 @@ namespace cellify {
        */
       Ant(const utils::Uuid& uuid);
 
+      /**
+       * @brief - Creates an ant from a previously saved state.
+       * @param uuid - the identifier of the body of the ant.
+       * @param state - the state of the ant.
+       */
+      Ant(const utils::Uuid& uuid, const AntState& state);
+
+      /**
+       * @brief - Return the internal state of the ant so that
+       *          it can be saved.
+       * @return - the state of the ant.
+       */
+      AntState
+      state() const noexcept;
+
       /**
        * @brief - Return the current behavior for the ant.
        * @return - the behavior for this ant.
@@ -68,11 +117,6 @@ namespace cellify {
       influence(const Influence* inf,
                 const Element* body) noexcept override;
 
-    protected:
-
-      void
-      log(const std::string& message) const noexcept;
-
     private:
 
       /**
@@ -95,41 +139,35 @@ namespace cellify {
       /**
        * @brief - Handle the wandering behavior.
        * @param info - the info to use to perform the behavior.
-       * @param items - the items that are visible to the ant.
        */
       void
-      wander(Info& info, const std::vector<int>& items);
+      wander(Info& info);
 
       /**
        * @brief - Handle the go to food behavior.
        * @param info - the info to use to perform the behavior.
-       * @param items - the items that are visible to the ant.
        */
       void
-      food(Info& info, const std::vector<int>& items);
+      food(Info& info);
 
       /**
        * @brief - Handle the return to home behavior.
        * @param info - the info to use to perform the behavior.
-       * @param items - the items that are visible to the ant.
        */
       void
-      returnHome(Info& info, const std::vector<int>& items);
+      returnHome(Info& info);
 
       /**
        * @brief - Handle the deposit behavior.
        * @param info - the info to use to perform the behavior.
-       * @param items - the items that are visible to the ant.
        */
       void
-      deposit(Info& info, const std::vector<int>& items);
+      deposit(Info& info);
 
       /**
-       * @brief - Find the closest target of the input type and
-       *          return its position.
+       * @brief - Find the closest target of the input type among
+       *          the visible elements and return its position.
        * @param info - the info to find a target of the input type.
-       * @param items - the list of items from which some of them
-       *                might be of the input type.
        * @param tile - the type of target to find.
        * @param out - the output position of the target. Should
        *              be ignored if the return value is `false`.
@@ -138,17 +176,15 @@ namespace cellify {
        */
       bool
       findClosest(Info& info,
-                  const std::vector<int>& items,
                   const Tile& tile,
                   utils::Point2i& out) const noexcept;
 
       /**
-       * @brief - Used to aggregate a path from the pheromons
-       *          with a type matching the input one.
+       * @brief - Used to aggregate a path from the visible
+       *          pheromons. The elements visible to the ant
+       *          should only contain pheromons with the scent
+       *          to follow.
        * @param info - the info to aggregate pheromons.
-       * @param items - the list of items from which some of
-       *                them are pheromons.
-       * @param scent - the scent of the pheromon to aggregate.
        * @param out - the output position aggregating from the
        *              available pheromons. Should be ignored if
        *              the return value is `false`.
@@ -159,8 +195,6 @@ namespace cellify {
        */
       bool
       aggregatePheromomns(Info& info,
-                          const std::vector<int>& items,
-                          const Scent& scent,
                           utils::Point2i& out,
                           bool& reverse) const noexcept;
 
@@ -169,7 +203,6 @@ namespace cellify {
        *          pheromon with the specified scent until it can
        *          reach a target of the input type.
        * @param info - info about the step.
-       * @param items - the list of visible items.
        * @param scent - the scent to follow.
        * @param tile - the tile to reach.
        * @param next - the next behavior to trigger when the `tile`
@@ -177,16 +210,12 @@ namespace cellify {
        */
       void
       followPheromonToTarget(Info& info,
-                             const std::vector<int>& items,
                              const Scent& scent,
                              const Tile& tile,
                              const Behavior& next);
 
     private:
 
-      /// @brief - Convenience representation of an optional target.
-      using OptTarget = std::shared_ptr<utils::Point2i>;
-
       /**
        * @brief - The beahvior currently active for the ant.
        */
@@ -199,11 +228,16 @@ namespace cellify {
       TimeStamp m_lastPheromon;
 
       /**
-       * @brief - The current target of the ant. Might be empty
-       *          in which case we have to generate a new random
-       *          one.
+       * @brief - The current target of the ant. Only relevant
+       *          when `m_hasTarget` is set.
        */
-      OptTarget m_target;
+      utils::Point2i m_target;
+
+      /**
+       * @brief - Whether the ant has a target. If this is not
+       *          the case we have to generate a new random one.
+       */
+      bool m_hasTarget;
 
       /**
        * @brief - The origin of the target: whether it was picked
@@ -229,6 +263,13 @@ namespace cellify {
        * @brief - The amount of food that this ant is carrying.
        */
       float m_food;
+
+      /**
+       * @brief - The elements matching the last visibility query
+       *          of the ant. Reused across steps so that querying
+       *          the surroundings does not allocate.
+       */
+      std::vector<int> m_visible;
   };
 
   using AntShPtr = std::shared_ptr<Ant>;
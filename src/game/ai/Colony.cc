@@ -3,14 +3,7 @@
 # include <cxxabi.h>
 # include "Ant.hh"
 # include "FoodInteraction.hh"
-
-/// @brief - The duration in milliseconds between two
-/// consecutive spawn of an agent.
-# define ANT_SPAWN_INTERNAL 200
-
-/// @brief - The range around which the agents can be
-/// spawned around the colony.
-# define ANT_SPAWN_RADIUS 2
+# include "Logging.hh"
 
 namespace cellify {
 
@@ -20,17 +13,42 @@ namespace cellify {
     m_budget(50.0f),
     m_antCost(10.0f),
     m_lastSpawn(zero()),
-    m_restTime(millisecondsToDuration(ANT_SPAWN_INTERNAL))
+    m_restTime(millisecondsToDuration(newSimulationParams().antSpawnInterval))
+  {}
+
+  Colony::Colony(const utils::Uuid& uuid, const ColonyState& state):
+    AI("colony-" + uuid.toString()),
+
+    m_budget(state.budget),
+    m_antCost(state.antCost),
+    m_lastSpawn(state.lastSpawn),
+    m_restTime(state.restTime)
   {}
 
+  ColonyState
+  Colony::state() const noexcept {
+    return ColonyState{m_budget, m_antCost, m_lastSpawn, m_restTime};
+  }
+
   void
   Colony::init(Info& info) {
+    m_restTime = millisecondsToDuration(info.params.antSpawnInterval);
+
     // Make sure we can spawn an ant right away if needed.
     m_lastSpawn = info.moment - m_restTime;
   }
 
   void
   Colony::step(Info& info) {
+    // The rest time is a parameter of the simulation: it is
+    // refreshed so that colonies restored from a snapshot use
+    // the values of the world they belong to.
+    Duration rest = millisecondsToDuration(info.params.antSpawnInterval);
+    if (rest != m_restTime) {
+      m_restTime = rest;
+      info.changed = true;
+    }
+
     // If there's enough budget, spawn an ant if it fits
     // with the time constraint.
     if (m_budget >= m_antCost && info.moment > m_lastSpawn + m_restTime) {
@@ -56,7 +74,7 @@ namespace cellify {
     }
 
     float a = fi->amount(body);
-    info("Adding " + std::to_string(a) + " to budget of colony (current: " + std::to_string(m_budget + a) + ")");
+    CELLIFY_INFO("Adding " + std::to_string(a) + " to budget of colony (current: " + std::to_string(m_budget + a) + ")");
 
     m_budget += a;
 
@@ -67,10 +85,10 @@ namespace cellify {
   Colony::spawn(Info& info) noexcept {
     // Compute ranges.
     std::pair<float, float> rangeX = std::make_pair(
-      info.pos.x() - ANT_SPAWN_RADIUS, info.pos.x() + ANT_SPAWN_RADIUS
+      info.pos.x() - info.params.antSpawnRadius, info.pos.x() + info.params.antSpawnRadius
     );
     std::pair<float, float> rangeY = std::make_pair(
-      info.pos.y() - ANT_SPAWN_RADIUS, info.pos.y() + ANT_SPAWN_RADIUS
+      info.pos.y() - info.params.antSpawnRadius, info.pos.y() + info.params.antSpawnRadius
     );
 
     // Pick a random position around the colony.
@@ -88,12 +106,13 @@ namespace cellify {
 
     info.spawned.push_back(Animat{p, brain});
 
-    verbose(
+    CELLIFY_VERBOSE(
       "Registering spawn attempt at " + p.toString() +
       " (budget: " + std::to_string(m_budget) + "/" + std::to_string(m_antCost) + ")"
      );
 
     // Update spawn tracking variables.
+    info.changed = true;
     m_lastSpawn = info.moment;
     m_budget -= m_antCost;
   }
@@ -7,6 +7,22 @@
 
 namespace cellify {
 
+  /// @brief - The internal state of a colony, as persisted in
+  /// a snapshot of the world.
+  struct ColonyState {
+    // The budget available to spawn ants.
+    float budget;
+
+    // The cost of a single ant.
+    float antCost;
+
+    // The last time an ant was spawned.
+    TimeStamp lastSpawn;
+
+    // The minimum duration between two spawns.
+    Duration restTime;
+  };
+
   class Colony: public AI {
     public:
 
@@ -16,6 +32,21 @@ namespace cellify {
        */
       Colony(const utils::Uuid& uuid);
 
+      /**
+       * @brief - Creates a colony from a previously saved state.
+       * @param uuid - the identifier of the colony.
+       * @param state - the state of the colony.
+       */
+      Colony(const utils::Uuid& uuid, const ColonyState& state);
+
+      /**
+       * @brief - Return the internal state of the colony so that
+       *          it can be saved.
+       * @return - the state of the colony.
+       */
+      ColonyState
+      state() const noexcept;
+
       /**
        * @brief - Implementation of the initialization method.
        * @param info - the info of the step.
@@ -2,6 +2,7 @@
 # include "Food.hh"
 # include <cxxabi.h>
 # include "FoodInteraction.hh"
+# include "Logging.hh"
 
 namespace cellify {
 
@@ -11,6 +12,11 @@ namespace cellify {
     m_stock(amount)
   {}
 
+  float
+  Food::stock() const noexcept {
+    return m_stock;
+  }
+
   void
   Food::init(Info& /*info*/) {}
 
@@ -19,7 +25,7 @@ namespace cellify {
     // In case we don't have a valid stock, we have
     // to self-destruct.
     if (m_stock <= 0.0f) {
-      this->info("Deposit " + info.pos.toString() + " is now empty");
+      CELLIFY_INFO("Deposit " + info.pos.toString() + " is now empty");
       info.selfDestruct = true;
     }
   }
@@ -43,10 +49,10 @@ namespace cellify {
 
     float a = fi->amount(body);
     if (a > 0.0f) {
-      info("Piled up " + std::to_string(a) + " food (" + std::to_string(m_stock) + " available)");
+      CELLIFY_INFO("Piled up " + std::to_string(a) + " food (" + std::to_string(m_stock) + " available)");
     }
     else {
-      info(
+      CELLIFY_INFO(
         "Withdrew " + std::to_string(-a) + " food (" + std::to_string(m_stock + a) +
         " remaining)"
       );
@@ -16,6 +16,13 @@ namespace cellify {
        */
       Food(float amount);
 
+      /**
+       * @brief - Return the amount of food still available.
+       * @return - the stock of the deposit.
+       */
+      float
+      stock() const noexcept;
+
       /**
        * @brief - Implementation of the initialization method.
        * @param info - the info of the step.
@@ -7,6 +7,7 @@
 # include "Path.hh"
 # include "Locator.hh"
 # include "Time.hh"
+# include "SimulationParams.hh"
 
 namespace cellify {
 
@@ -53,6 +54,9 @@ namespace cellify {
     // processes during the step.
     utils::RNG& rng;
 
+    // The tuning values of the simulation.
+    const SimulationParams& params;
+
     // The moment at which the processing is taking place.
     TimeStamp moment;
 
@@ -70,12 +74,20 @@ namespace cellify {
     // deletion.
     bool selfDestruct;
 
-    // A list of new AIs that might be created by this
-    // agent.
-    Animats spawned;
+    // Whether the agent changed its internal state or its
+    // path during the processing. Unchanged elements are not
+    // captured again by the history of the world.
+    bool changed;
 
-    // A list of the influences produced by this agent.
-    Influences actions;
+    // A list of new AIs that might be created by this
+    // agent. It is owned by the caller, which can reuse it
+    // from one agent to the next.
+    Animats& spawned;
+
+    // A list of the influences produced by this agent. It
+    // may already contain the influences produced by other
+    // agents during the same step.
+    Influences& actions;
   };
 
 }
@@ -39,6 +39,16 @@ namespace cellify {
     return m_created;
   }
 
+  float
+  Pheromon::amount() const noexcept {
+    return m_amount;
+  }
+
+  float
+  Pheromon::evaporation() const noexcept {
+    return m_evaporation;
+  }
+
   void
   Pheromon::init(Info& /*info*/) {}
 
@@ -46,6 +56,7 @@ namespace cellify {
   Pheromon::step(Info& info) {
     // Decrease the amount.
     m_amount -= (m_evaporation * info.elapsed);
+    info.changed = true;
 
     // Self-destruct if needed.
     if (m_amount <= 0.0f) {
@@ -49,6 +49,20 @@ namespace cellify {
       const TimeStamp&
       created() const noexcept;
 
+      /**
+       * @brief - Return the amount of pheromon laid out.
+       * @return - the amount of pheromon.
+       */
+      float
+      amount() const noexcept;
+
+      /**
+       * @brief - Return the evaporation rate of the pheromon.
+       * @return - the evaporation rate.
+       */
+      float
+      evaporation() const noexcept;
+
       /**
        * @brief - Implementation of the initialization method.
        * @param info - the info of the step.
@@ -1,17 +1,23 @@
 
 # include "Element.hh"
+# include <atomic>
 # include <cstring>
 # include "Grid.hh"
 # include "Ant.hh"
 # include "Colony.hh"
 # include "Pheromon.hh"
-
-/// @brief - The interval defining two consecutive
-/// moves of an ant in milliseconds.
-# define IDLE_TIME 200
+# include "Food.hh"
 
 namespace {
 
+  /// @brief - The serial of the next element created.
+  std::atomic<std::uint64_t> g_nextSerial(0u);
+
+  /// @brief - The agents spawned by the brain of the element
+  /// processed by the thread. The list is cleared rather than
+  /// reallocated for each element.
+  thread_local cellify::Animats g_spawned;
+
   cellify::Tile
   tileFromBrain(cellify::AIShPtr brain) noexcept {
     // Based on the type of the AI, assign the correct
@@ -22,9 +28,11 @@ namespace {
     if (std::dynamic_pointer_cast<cellify::Pheromon>(brain)) {
       return cellify::Tile::Pheromon;
     }
+    if (std::dynamic_pointer_cast<cellify::Food>(brain)) {
+      return cellify::Tile::Food;
+    }
 
-    // Assume it's an ant as the food doesn't have a
-    // brain at all.
+    // Assume it's an ant.
     return cellify::Tile::Ant;
   }
 
@@ -83,6 +91,7 @@ namespace cellify {
     m_tile(t),
     m_data(),
     m_pos(pos),
+    m_prev(pos),
 
     m_brain(brain),
 
@@ -90,7 +99,10 @@ namespace cellify {
 
     m_path(),
     m_last(0.0f),
-    m_elapsedSinceLast(zero())
+    m_elapsedSinceLast(zero()),
+
+    m_serial(g_nextSerial++),
+    m_dirty(true)
   {
     setService("world");
 
@@ -136,14 +148,84 @@ namespace cellify {
     return m_pos;
   }
 
+  const utils::Point2i&
+  Element::previous() const noexcept {
+    return m_prev;
+  }
+
   bool
   Element::tobeDeleted() const noexcept {
     return m_deleted;
   }
 
+  unsigned
+  Element::dataSize() const noexcept {
+    return m_data.size();
+  }
+
+  AIShPtr
+  Element::brain() const noexcept {
+    return m_brain;
+  }
+
+  const Path&
+  Element::path() const noexcept {
+    return m_path;
+  }
+
+  const TimeStamp&
+  Element::last() const noexcept {
+    return m_last;
+  }
+
+  const Duration&
+  Element::elapsedSinceLast() const noexcept {
+    return m_elapsedSinceLast;
+  }
+
+  void
+  Element::restore(const TimeStamp& last,
+                   const Duration& elapsedSinceLast) noexcept
+  {
+    m_last = last;
+    m_elapsedSinceLast = elapsedSinceLast;
+    m_dirty = true;
+  }
+
+  void
+  Element::restore(const Path& path,
+                   const TimeStamp& last,
+                   const Duration& elapsedSinceLast)
+  {
+    m_path = path;
+    m_prev = m_pos;
+    restore(last, elapsedSinceLast);
+  }
+
+  std::uint64_t
+  Element::serial() const noexcept {
+    return m_serial;
+  }
+
+  void
+  Element::setSerial(std::uint64_t serial) noexcept {
+    m_serial = serial;
+  }
+
+  bool
+  Element::dirty() const noexcept {
+    return m_dirty;
+  }
+
+  void
+  Element::clean() noexcept {
+    m_dirty = false;
+  }
+
   void
   Element::plug(AIShPtr brain) noexcept {
     m_brain = brain;
+    m_dirty = true;
   }
 
   void
@@ -154,22 +236,28 @@ namespace cellify {
     }
 
     // Initialize the brain.
+    g_spawned.clear();
+
     Info i = {
       m_pos,
       info.rng,
+      info.params,
       info.moment,
       info.elapsed,
       m_path,
       info.grid,
       m_deleted,
-      Animats(),
-      Influences()
+      true,
+      g_spawned,
+      info.actions
     };
     m_brain->init(i);
+    m_dirty = true;
 
     // Persist the information.
     if (!m_path.empty()) {
       m_pos = m_path.begin();
+      m_prev = m_pos;
     }
     m_deleted = i.selfDestruct;
 
@@ -185,6 +273,7 @@ namespace cellify {
 
       info.spawned.push_back(e);
     }
+    g_spawned.clear();
 
     m_last = info.moment;
   }
@@ -196,28 +285,58 @@ namespace cellify {
       return;
     }
 
-    // Advance the brain.
+    // Advance the brain: the influences are directly
+    // added to the ones of the step.
+    g_spawned.clear();
+
     Info i = {
       m_pos,
       info.rng,
+      info.params,
       info.moment,
       info.elapsed,
       m_path,
       info.grid,
       m_deleted,
-      Animats(),
-      Influences()
+      false,
+      g_spawned,
+      info.actions
     };
+    // Ants may change their behavior during the step: the
+    // grid keeps track of the number of ants with each one
+    // and the data of the element reflects the current one.
+    const Ant* ant = (m_tile == Tile::Ant ? dynamic_cast<const Ant*>(m_brain.get()) : nullptr);
+    Behavior before = (ant != nullptr ? ant->mode() : Behavior::Wander);
+
     m_brain->step(i);
 
+    if (ant != nullptr) {
+      Behavior after = ant->mode();
+      if (after != before) {
+        info.grid.changeBehavior(before, after);
+      }
+
+      if (m_data.size() >= sizeof(Behavior)) {
+        std::memcpy(m_data.data(), reinterpret_cast<const char*>(&after), sizeof(Behavior));
+      }
+    }
+
+    // The brain reports whether it changed its internal
+    // state or the path of the element.
+    if (i.changed) {
+      m_dirty = true;
+    }
+
     // Pick the next position in the path and advance
     // to this location if we moved long enough in the
     // past.
     if (!m_path.empty()) {
       Duration d = info.moment - m_last;
-      if (d >= millisecondsToDuration(IDLE_TIME)) {
+      if (d >= millisecondsToDuration(info.params.idleTime)) {
+        m_prev = m_pos;
         m_pos = m_path.advance();
         m_last = info.moment;
+        m_dirty = true;
       }
     }
 
@@ -227,20 +346,9 @@ namespace cellify {
     // Copy the spawned elements.
     for (unsigned id = 0u ; id < i.spawned.size() ; ++id) {
       const Animat& a = i.spawned[id];
-
-      // Generate the type of the element from its brain.
-      Tile t = tileFromBrain(a.brain);
-      std::vector<char> d = dataFromBrain(a.brain);
-
-      utils::Uuid uuid = (a.brain != nullptr ? a.brain->uuid() : utils::Uuid::create());
-
-      ElementShPtr e = std::make_shared<Element>(t, a.pos, a.brain, d, uuid);
-
-      info.spawned.push_back(e);
+      info.spawned.push_back(newElement(a.pos, a.brain));
     }
-
-    // And copy the influences.
-    info.actions.insert(info.actions.end(), i.actions.cbegin(), i.actions.cend());
+    g_spawned.clear();
   }
 
   bool
@@ -258,7 +366,13 @@ namespace cellify {
       );
     }
 
-    return m_brain->influence(inf, this);
+    // Only a successful influence changes the brain.
+    bool ok = m_brain->influence(inf, this);
+    if (ok) {
+      m_dirty = true;
+    }
+
+    return ok;
   }
 
   void
@@ -295,6 +409,18 @@ namespace cellify {
     }
 
     m_brain->merge(*rhs.m_brain);
+    m_dirty = true;
+  }
+
+  ElementShPtr
+  newElement(const utils::Point2i& pos, AIShPtr brain) {
+    // Generate the type of the element from its brain.
+    Tile t = tileFromBrain(brain);
+    std::vector<char> d = dataFromBrain(brain);
+
+    utils::Uuid uuid = (brain != nullptr ? brain->uuid() : utils::Uuid::create());
+
+    return std::make_shared<Element>(t, pos, brain, d, uuid);
   }
 
 }
@@ -3,6 +3,7 @@
 
 # include <vector>
 # include <memory>
+# include <cstdint>
 # include <core_utils/CoreObject.hh>
 # include <core_utils/Uuid.hh>
 # include <maths_utils/Point2.hh>
@@ -62,6 +63,67 @@ namespace cellify {
       const char*
       data() const noexcept;
 
+      /**
+       * @brief - The size in bytes of the specific data for
+       *          this element.
+       * @return - the size of the data segment.
+       */
+      unsigned
+      dataSize() const noexcept;
+
+      /**
+       * @brief - The brain driving this element, if any.
+       * @return - the brain of the element or null.
+       */
+      AIShPtr
+      brain() const noexcept;
+
+      /**
+       * @brief - The path currently followed by the element.
+       * @return - the path of the element.
+       */
+      const Path&
+      path() const noexcept;
+
+      /**
+       * @brief - The last time the element moved.
+       * @return - the time of the last move.
+       */
+      const TimeStamp&
+      last() const noexcept;
+
+      /**
+       * @brief - The time elapsed since the last move of the
+       *          element at the moment it was paused.
+       * @return - the elapsed time since the last move.
+       */
+      const Duration&
+      elapsedSinceLast() const noexcept;
+
+      /**
+       * @brief - Restore the motion of the element, typically
+       *          when loading it from a snapshot.
+       * @param last - the last time the element moved.
+       * @param elapsedSinceLast - the time elapsed since the
+       *                           last move when paused.
+       */
+      void
+      restore(const TimeStamp& last,
+              const Duration& elapsedSinceLast) noexcept;
+
+      /**
+       * @brief - Restore the motion of the element along with
+       *          the path it follows.
+       * @param path - the path followed by the element.
+       * @param last - the last time the element moved.
+       * @param elapsedSinceLast - the time elapsed since the
+       *                           last move when paused.
+       */
+      void
+      restore(const Path& path,
+              const TimeStamp& last,
+              const Duration& elapsedSinceLast);
+
       /**
        * @brief - The position of the element.
        * @return - the position of the element.
@@ -69,6 +131,14 @@ namespace cellify {
       const utils::Point2i&
       pos() const noexcept;
 
+      /**
+       * @brief - The position of the element before its last
+       *          move, or its position if it did not move yet.
+       * @return - the previous position of the element.
+       */
+      const utils::Point2i&
+      previous() const noexcept;
+
       /**
        * @brief - Defines whether this element has been marked
        *          for deletion.
@@ -136,6 +206,42 @@ namespace cellify {
       virtual void
       resume(const TimeStamp& t);
 
+      /**
+       * @brief - A number identifying the element in the process.
+       *          Serials are attributed in increasing order when
+       *          creating elements, which matches the order in
+       *          which they are registered in the grid.
+       * @return - the serial of the element.
+       */
+      std::uint64_t
+      serial() const noexcept;
+
+      /**
+       * @brief - Override the serial of the element, typically
+       *          when restoring it from the history of a world.
+       * @param serial - the new serial of the element.
+       */
+      void
+      setSerial(std::uint64_t serial) noexcept;
+
+      /**
+       * @brief - Whether the element changed since the last call
+       *          to `clean`. New elements are dirty, and elements
+       *          become dirty when they move, when their brain
+       *          reports a change during a step, when they're
+       *          successfully influenced or when they're merged
+       *          with another one.
+       * @return - `true` if the element may have changed.
+       */
+      bool
+      dirty() const noexcept;
+
+      /**
+       * @brief - Mark the element as not changed.
+       */
+      void
+      clean() noexcept;
+
       /**
        * @brief - Perform the merge of the two elements assuming
        *          they have the same type. Otherwise an error is
@@ -171,6 +277,12 @@ namespace cellify {
        */
       utils::Point2i m_pos;
 
+      /**
+       * @brief - The position of the element before its last
+       *          move. Only used for display purposes.
+       */
+      utils::Point2i m_prev;
+
       /**
        * @brief - The brain of this element.
        */
@@ -197,9 +309,32 @@ namespace cellify {
        *          the element moved at the moment of the pause.
        */
       Duration m_elapsedSinceLast;
+
+      /**
+       * @brief - The serial of the element.
+       */
+      std::uint64_t m_serial;
+
+      /**
+       * @brief - Whether the element changed since it was last
+       *          marked as clean.
+       */
+      bool m_dirty;
   };
 
   using ElementShPtr = std::shared_ptr<Element>;
+
+  /**
+   * @brief - Create a new element driven by the input brain:
+   *          the type of the element and its specific data
+   *          are deduced from the brain, and its identifier
+   *          is the one of the brain.
+   * @param pos - the position of the element.
+   * @param brain - the brain of the element.
+   * @return - the created element.
+   */
+  ElementShPtr
+  newElement(const utils::Point2i& pos, AIShPtr brain);
 }
 
 #endif    /* ELEMENT_HH */
@@ -4,34 +4,45 @@
 # include "Ant.hh"
 # include "Pheromon.hh"
 # include "Food.hh"
+# include "Logging.hh"
 
-/// @brief - The radius of the food circle around the
-/// central colony.
-# define FOOD_DEPOSITS_RADIUS 10
+namespace cellify {
 
-/// @brief - The number of deposits to put on the food
-/// circle around the colony.
-# define FOOD_DEPOSITS_COUNT 4
+  Grid::Grid(utils::RNG& rng,
+             const SimulationParams& params):
+    utils::CoreObject("grid"),
 
-/// @brief - The amount of food in deposits.
-# define FOOD_STOCK 50.0f
+    m_min(),
+    m_max(),
 
-/// @brief - The dimensions of the initial walls.
-# define WALL_LENGTH 6
+    m_cells(),
 
-namespace cellify {
+    m_population()
+  {
+    setService("game");
+
+    initialize(rng, params);
+
+    for (unsigned id = 0u ; id < m_cells.size() ; ++id) {
+      track(*m_cells[id], true);
+    }
+  }
 
-  Grid::Grid(utils::RNG& rng):
+  Grid::Grid(const Elements& elements):
     utils::CoreObject("grid"),
 
     m_min(),
     m_max(),
 
-    m_cells()
+    m_cells(elements),
+
+    m_population()
   {
     setService("game");
 
-    initialize(rng);
+    for (unsigned id = 0u ; id < m_cells.size() ; ++id) {
+      track(*m_cells[id], true);
+    }
   }
 
   utils::Point2i
@@ -49,6 +60,32 @@ namespace cellify {
     return m_cells.size();
   }
 
+  const Elements&
+  Grid::elements() const noexcept {
+    return m_cells;
+  }
+
+  const Population&
+  Grid::population() const noexcept {
+    return m_population;
+  }
+
+  unsigned
+  Grid::count(const Tile& tile) const noexcept {
+    return m_population.tiles[static_cast<unsigned>(tile)];
+  }
+
+  unsigned
+  Grid::count(const Behavior& behavior) const noexcept {
+    return m_population.behaviors[static_cast<unsigned>(behavior)];
+  }
+
+  void
+  Grid::changeBehavior(const Behavior& from, const Behavior& to) noexcept {
+    --m_population.behaviors[static_cast<unsigned>(from)];
+    ++m_population.behaviors[static_cast<unsigned>(to)];
+  }
+
   Element&
   Grid::at(unsigned id) {
     if (id > m_cells.size()) {
@@ -99,7 +136,19 @@ namespace cellify {
 
   bool
   Grid::obstructed(int x, int y, bool includeNonSolid) const noexcept {
-    return !at(x, y, includeNonSolid).empty();
+    for (unsigned id = 0u ; id < m_cells.size() ; ++id) {
+      const Element& c = *m_cells[id];
+      if (c.pos().x() != x || c.pos().y() != y) {
+        continue;
+      }
+
+      bool isSolid = c.type() == Tile::Colony || c.type() == Tile::Food || c.type() == Tile::Obstacle;
+      if (includeNonSolid || isSolid) {
+        return true;
+      }
+    }
+
+    return false;
   }
 
   bool
@@ -132,6 +181,45 @@ namespace cellify {
     return out;
   }
 
+  unsigned
+  Grid::visible(const VisibilityQuery& query,
+                Indices& out) const noexcept
+  {
+    out.clear();
+
+    // Compare squared distances: the ones which are smaller
+    // than the squared radius are the ones which are closer
+    // than the radius.
+    float r = query.radius * query.radius;
+
+    for (unsigned id = 0u ; id < m_cells.size() ; ++id) {
+      const Element& c = *m_cells[id];
+
+      if ((query.types & tileMask(c.type())) == 0u) {
+        continue;
+      }
+
+      float dx = c.pos().x() - query.pos.x();
+      float dy = c.pos().y() - query.pos.y();
+      float dst = dx * dx + dy * dy;
+
+      if (dst >= r) {
+        continue;
+      }
+
+      if (query.kind >= 0 && c.type() == Tile::Pheromon) {
+        Scent s = *reinterpret_cast<const Scent*>(c.data());
+        if (static_cast<int>(s) != query.kind) {
+          continue;
+        }
+      }
+
+      out.push_back(static_cast<int>(id));
+    }
+
+    return out.size();
+  }
+
   const void*
   Grid::get(unsigned id) const noexcept {
     if (id > m_cells.size()) {
@@ -164,7 +252,7 @@ namespace cellify {
     if (elem->type() == Tile::Food || elem->type() == Tile::Colony || elem->type() == Tile::Obstacle) {
       Indices ids = at(elem->pos().x(), elem->pos().y());
       if (!ids.empty()) {
-        debug(
+        CELLIFY_DEBUG(
           "Preventing insertion of " + tileToString(elem->type()) +
           " at " + elem->pos().toString() + ", already containing an element"
         );
@@ -173,38 +261,49 @@ namespace cellify {
       }
     }
 
-    verbose(
+    CELLIFY_VERBOSE(
       "Spawning agent with type " + tileToString(elem->type()) +
       " at " + elem->pos().toString()
     );
 
     m_cells.push_back(elem);
+    track(*elem, true);
   }
 
-  void
+  Serials
   Grid::update() noexcept {
     // Use the standard algorithm to remove elements
     // that have been marked for deletion.
-    unsigned sz = m_cells.size();
+    Serials removed;
 
     m_cells.erase(
       std::remove_if(
         m_cells.begin(),
         m_cells.end(),
-        [](ElementShPtr el){
-          return el->tobeDeleted();
+        [this, &removed](ElementShPtr el){
+          if (!el->tobeDeleted()) {
+            return false;
+          }
+
+          track(*el, false);
+          removed.push_back(el->serial());
+          return true;
         }
       ),
       m_cells.end()
     );
 
-    if (sz != m_cells.size()) {
-      verbose("Removed " + std::to_string(sz - m_cells.size()) + " agent(s)");
+    if (!removed.empty()) {
+      CELLIFY_VERBOSE("Removed " + std::to_string(removed.size()) + " agent(s)");
     }
+
+    return removed;
   }
 
   void
-  Grid::initialize(utils::RNG& /*rng*/) noexcept {
+  Grid::initialize(utils::RNG& /*rng*/,
+                   const SimulationParams& params) noexcept
+  {
     // Generate an anthill at the origin of the world.
     m_cells.push_back(std::make_shared<Element>(
       Tile::Colony, utils::Point2i(), std::make_shared<Colony>(utils::Uuid::create())
@@ -212,11 +311,11 @@ namespace cellify {
 
     // Generate a ring of food around it with a certain
     // radius.
-    for (unsigned id = 0u ; id < FOOD_DEPOSITS_COUNT ; ++id) {
-      float perc = 1.0f * id / FOOD_DEPOSITS_COUNT;
+    for (unsigned id = 0u ; id < params.foodDepositsCount ; ++id) {
+      float perc = 1.0f * id / params.foodDepositsCount;
 
-      float fx = FOOD_DEPOSITS_RADIUS * std::cos(2.0f * M_PI * perc);
-      float fy = FOOD_DEPOSITS_RADIUS * std::sin(2.0f * M_PI * perc);
+      float fx = params.foodDepositsRadius * std::cos(2.0f * M_PI * perc);
+      float fy = params.foodDepositsRadius * std::sin(2.0f * M_PI * perc);
 
       int x = static_cast<int>(std::round(fx));
       int y = static_cast<int>(std::round(fy));
@@ -225,7 +324,7 @@ namespace cellify {
         std::make_shared<Element>(
           Tile::Food,
           utils::Point2i(x, y),
-          std::make_shared<Food>(FOOD_STOCK)
+          std::make_shared<Food>(params.foodStock)
         )
       );
     }
@@ -246,54 +345,60 @@ namespace cellify {
       }
     };
 
+    int length = params.wallLength;
+
     // Left wall.
-    wall(-5, -4, 0 - WALL_LENGTH / 2, 0 + WALL_LENGTH / 2 + 1);
+    wall(-5, -4, 0 - length / 2, 0 + length / 2 + 1);
 
     // Right wall.
-    wall(5, 6, 0 - WALL_LENGTH / 2, 0 + WALL_LENGTH / 2 + 1);
+    wall(5, 6, 0 - length / 2, 0 + length / 2 + 1);
 
     // Top wall.
-    wall(0 - WALL_LENGTH / 2, 0 + WALL_LENGTH / 2 + 1, 7, 8);
+    wall(0 - length / 2, 0 + length / 2 + 1, 7, 8);
 
     // Bottom wall.
-    wall(0 - WALL_LENGTH / 2, 0 + WALL_LENGTH / 2 + 1, -7, -6);
+    wall(0 - length / 2, 0 + length / 2 + 1, -7, -6);
   }
 
   bool
   Grid::mergePheromon(ElementShPtr p) noexcept {
-    // Get elements at the position of the pheromon.
-    Indices ids = at(p->pos().x(), p->pos().y(), true);
-
-    // If there are none, nothing to merge.
-    if (ids.empty()) {
-      return false;
-    }
-
     Scent toMerge = *reinterpret_cast<const Scent*>(p->data());
 
-    // Check for a pheromon with the same scent.
-    unsigned id = 0u;
-
-    while (id < ids.size()) {
-      Element& ex = at(ids[id]);
-
-      // We have to have a pheromon with the same scent.
-      if (ex.type() == Tile::Pheromon) {
-        Scent existingScent = *reinterpret_cast<const Scent*>(ex.data());
+    // Look for a pheromon with the same scent at the position
+    // of the new one. The cells are scanned directly rather
+    // than through `at` so that no list is built.
+    for (unsigned id = 0u ; id < m_cells.size() ; ++id) {
+      Element& ex = *m_cells[id];
+      if (ex.type() != Tile::Pheromon || ex.pos() != p->pos()) {
+        continue;
+      }
 
-        if (toMerge == existingScent) {
-          // Merge both elements.
-          ex.merge(*p);
+      Scent existingScent = *reinterpret_cast<const Scent*>(ex.data());
+      if (toMerge == existingScent) {
+        // Merge both elements.
+        ex.merge(*p);
 
-          return true;
-        }
+        return true;
       }
-
-      ++id;
     }
 
     // We didn't merge the pheromon.
     return false;
   }
 
+  void
+  Grid::track(const Element& e, bool added) noexcept {
+    unsigned& t = m_population.tiles[static_cast<unsigned>(e.type())];
+    t = (added ? t + 1u : t - 1u);
+
+    // The behavior is read from the brain rather than from
+    // the data of the element, as it is the one compared by
+    // the element when it is stepped.
+    const Ant* a = (e.type() == Tile::Ant ? dynamic_cast<const Ant*>(e.brain().get()) : nullptr);
+    if (a != nullptr) {
+      unsigned& b = m_population.behaviors[static_cast<unsigned>(a->mode())];
+      b = (added ? b + 1u : b - 1u);
+    }
+  }
+
 }
@@ -1,6 +1,7 @@
 #ifndef    GRID_HH
 # define   GRID_HH
 
+# include <array>
 # include <vector>
 # include <memory>
 # include <maths_utils/Point2.hh>
@@ -8,7 +9,9 @@
 # include <core_utils/RNG.hh>
 # include "Tiles.hh"
 # include "StepInfo.hh"
+# include "SimulationParams.hh"
 # include "Element.hh"
+# include "Ant.hh"
 # include "Locator.hh"
 
 namespace cellify {
@@ -17,15 +20,43 @@ namespace cellify {
   /// of elements indices.
   using Indices = std::vector<int>;
 
+  /// @brief - Convenience define allowing to represent a list
+  /// of elements serials.
+  using Serials = std::vector<std::uint64_t>;
+
+  /// @brief - The number of elements of the grid by type and
+  /// the number of ants by behavior. It is kept up to date as
+  /// elements are spawned, removed or change their behavior so
+  /// that reading it does not depend on the size of the grid.
+  struct Population {
+    // The number of elements of each type.
+    std::array<unsigned, static_cast<unsigned>(Tile::Count)> tiles;
+
+    // The number of ants with each behavior.
+    std::array<unsigned, static_cast<unsigned>(Behavior::Count)> behaviors;
+  };
+
   class Grid: public utils::CoreObject, public Locator {
     public:
 
       /**
-       * @brief - Creates a new infinite grid with no elements.
+       * @brief - Creates a new infinite grid with the default
+       *          layout: a colony surrounded by walls and food
+       *          deposits.
        * @param rng - a random number generator to use to create
        *              the grid and initialize it.
+       * @param params - the parameters defining the layout.
        */
-      Grid(utils::RNG& rng);
+      Grid(utils::RNG& rng,
+           const SimulationParams& params = newSimulationParams());
+
+      /**
+       * @brief - Creates a new infinite grid with the input
+       *          elements. They are inserted as is: no merge
+       *          or obstruction check is performed.
+       * @param elements - the elements of the grid.
+       */
+      Grid(const Elements& elements);
 
       /**
        * @brief - Returns the minimum extent of the grid.
@@ -51,6 +82,49 @@ namespace cellify {
       unsigned
       size() const noexcept;
 
+      /**
+       * @brief - Returns the elements registered in the grid.
+       * @return - the list of elements.
+       */
+      const Elements&
+      elements() const noexcept;
+
+      /**
+       * @brief - Returns the number of elements of each type and
+       *          of ants with each behavior.
+       * @return - the population of the grid.
+       */
+      const Population&
+      population() const noexcept;
+
+      /**
+       * @brief - Returns the number of elements with the input
+       *          type in the grid.
+       * @param tile - the type of the elements to count.
+       * @return - the number of elements with this type.
+       */
+      unsigned
+      count(const Tile& tile) const noexcept;
+
+      /**
+       * @brief - Returns the number of ants with the input
+       *          behavior in the grid.
+       * @param behavior - the behavior of the ants to count.
+       * @return - the number of ants with this behavior.
+       */
+      unsigned
+      count(const Behavior& behavior) const noexcept;
+
+      /**
+       * @brief - Register the change of behavior of an ant of
+       *          the grid. Should be called by the element as
+       *          it is stepped.
+       * @param from - the previous behavior of the ant.
+       * @param to - the new behavior of the ant.
+       */
+      void
+      changeBehavior(const Behavior& from, const Behavior& to) noexcept;
+
       /**
        * @brief - Returns the element at the specified index.
        * @param id - the index of the element to fetch.
@@ -87,8 +161,9 @@ namespace cellify {
 
       /**
        * @brief - Determine whether the input coordinates are
-       *          obstructed. Internally the above method is
-       *          called.
+       *          obstructed. The elements are filtered like in
+       *          the above method but the scan stops at the first
+       *          match and no list is built.
        * @param x - the abscissa to check for obstruction.
        * @param y - the ordinate to check for obstruction.
        * @param includeNonSolid - `true` in case the obstruction
@@ -123,6 +198,19 @@ namespace cellify {
       visible(const utils::Point2i& p,
               float d) const noexcept override;
 
+      /**
+       * @brief - Implementation of the interface method to find the
+       *          elements matching a query. The kind of elements is
+       *          the scent of the pheromons: other elements do not
+       *          have one and are never filtered by it.
+       * @param query - the description of the elements to find.
+       * @param out - output list receiving the elements.
+       * @return - the number of elements found.
+       */
+      unsigned
+      visible(const VisibilityQuery& query,
+              Indices& out) const noexcept override;
+
       /**
        * @brief - Implementation of the interface method to fetch the
        *          element at the specified index. We return null if
@@ -145,8 +233,9 @@ namespace cellify {
       /**
        * @brief - Update the grid and remove elements which have
        *          been marked for deletion.
+       * @return - the serials of the removed elements.
        */
-      void
+      Serials
       update() noexcept;
 
     private:
@@ -154,9 +243,11 @@ namespace cellify {
       /**
        * @brief - Generate a random grid.
        * @param rng - a randomness generator.
+       * @param params - the parameters defining the layout.
        */
       void
-      initialize(utils::RNG& rng) noexcept;
+      initialize(utils::RNG& rng,
+                 const SimulationParams& params) noexcept;
 
       /**
        * @brief - Used to attempt the merge of the input pheromon.
@@ -166,6 +257,15 @@ namespace cellify {
       bool
       mergePheromon(ElementShPtr p) noexcept;
 
+      /**
+       * @brief - Update the population with an element added to
+       *          or removed from the grid.
+       * @param e - the element.
+       * @param added - `true` if the element is added.
+       */
+      void
+      track(const Element& e, bool added) noexcept;
+
     private:
 
       /**
@@ -186,6 +286,12 @@ namespace cellify {
        * @brief - The list of elements registered in the grid.
        */
       std::vector<ElementShPtr> m_cells;
+
+      /**
+       * @brief - The number of elements of each type and of ants
+       *          with each behavior in the grid.
+       */
+      Population m_population;
   };
 
   using GridShPtr = std::shared_ptr<Grid>;
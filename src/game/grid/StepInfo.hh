@@ -5,6 +5,7 @@
 # include <memory>
 # include <core_utils/RNG.hh>
 # include "Time.hh"
+# include "SimulationParams.hh"
 
 namespace cellify {
 
@@ -38,6 +39,9 @@ namespace cellify {
     // processes during the step.
     utils::RNG& rng;
 
+    // The tuning values of the simulation.
+    const SimulationParams& params;
+
     // The moment at which the processing is taking place.
     TimeStamp moment;
 
@@ -49,12 +53,13 @@ namespace cellify {
     Grid& grid;
 
     // The list of elements that will be spawned after the
-    // end of the step.
-    Elements spawned;
+    // end of the step. It is owned by the caller, which can
+    // reuse it from one step to the next.
+    Elements& spawned;
 
     // The list of influences that will be processed at the
-    // end of the step.
-    Influences actions;
+    // end of the step. It is owned by the caller as well.
+    Influences& actions;
   };
 
 }
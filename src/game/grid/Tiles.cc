@@ -21,4 +21,9 @@ namespace cellify {
     }
   }
 
+  unsigned
+  tileMask(const Tile& t) noexcept {
+    return 1u << static_cast<unsigned>(t);
+  }
+
 }
@@ -13,7 +13,8 @@ namespace cellify {
     Ant,
     Food,
     Pheromon,
-    Obstacle
+    Obstacle,
+    Count
   };
 
   /**
@@ -24,6 +25,14 @@ namespace cellify {
   std::string
   tileToString(const Tile& t) noexcept;
 
+  /**
+   * @brief - The mask selecting a tile in a visibility query.
+   * @param t - the tile.
+   * @return - the mask of the tile.
+   */
+  unsigned
+  tileMask(const Tile& t) noexcept;
+
 }
 
 #endif    /* TILES_HH */
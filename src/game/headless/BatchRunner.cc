@@ -0,0 +1,285 @@
+
+# include "BatchRunner.hh"
+# include <atomic>
+# include <algorithm>
+# include <chrono>
+# include <thread>
+# include <fstream>
+# include <core_utils/CoreException.hh>
+# include "Colony.hh"
+# include "Food.hh"
+
+namespace {
+
+  /**
+   * @brief - The total amount of food available in the deposits
+   *          of the world.
+   * @param g - the grid of the world.
+   * @return - the amount of food.
+   */
+  float
+  foodStock(const cellify::Grid& g) noexcept {
+    float out = 0.0f;
+
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const cellify::Element& e = g.at(id);
+      if (e.type() != cellify::Tile::Food) {
+        continue;
+      }
+
+      if (cellify::FoodShPtr f = std::dynamic_pointer_cast<cellify::Food>(e.brain())) {
+        out += f->stock();
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - The total budget of the colonies of the world.
+   * @param g - the grid of the world.
+   * @return - the budget of the colonies.
+   */
+  float
+  colonyBudget(const cellify::Grid& g) noexcept {
+    float out = 0.0f;
+
+    for (unsigned id = 0u ; id < g.size() ; ++id) {
+      const cellify::Element& e = g.at(id);
+      if (e.type() != cellify::Tile::Colony) {
+        continue;
+      }
+
+      if (std::shared_ptr<cellify::Colony> c = std::dynamic_pointer_cast<cellify::Colony>(e.brain())) {
+        out += c->state().budget;
+      }
+    }
+
+    return out;
+  }
+
+}
+
+namespace cellify {
+
+  BatchDesc
+  newBatchDesc(const HeadlessDesc& run,
+               const ScenarioDesc& scenario,
+               const SimulationParams& params,
+               unsigned repeats,
+               unsigned jobs) noexcept
+  {
+    return BatchDesc{run, scenario, params, Sweep(), repeats, jobs};
+  }
+
+  BatchRunner::BatchRunner(const BatchDesc& desc):
+    utils::CoreObject("batch"),
+
+    m_desc(desc),
+
+    m_results(),
+    m_elapsed(0.0f)
+  {
+    setService("headless");
+
+    for (unsigned id = 0u ; id < m_desc.sweep.size() ; ++id) {
+      const SweepAxis& axis = m_desc.sweep[id];
+
+      SimulationParams p = m_desc.params;
+      if (!setParam(p, axis.name, 0.0f)) {
+        error(
+          "Failed to create batch",
+          "Unknown parameter \"" + axis.name + "\""
+        );
+      }
+      if (layoutParam(axis.name)) {
+        error(
+          "Failed to create batch",
+          "Parameter \"" + axis.name + "\" only applies to the default layout"
+        );
+      }
+      if (axis.values.empty()) {
+        error(
+          "Failed to create batch",
+          "No value provided for parameter \"" + axis.name + "\""
+        );
+      }
+    }
+
+    if (m_desc.repeats == 0u) {
+      m_desc.repeats = 1u;
+    }
+  }
+
+  unsigned
+  BatchRunner::size() const noexcept {
+    unsigned out = m_desc.repeats;
+
+    for (unsigned id = 0u ; id < m_desc.sweep.size() ; ++id) {
+      out *= m_desc.sweep[id].values.size();
+    }
+
+    return out;
+  }
+
+  void
+  BatchRunner::run() {
+    using Clock = std::chrono::steady_clock;
+
+    unsigned count = size();
+    unsigned jobs = m_desc.jobs;
+    if (jobs == 0u) {
+      jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    jobs = std::min(jobs, count);
+
+    notice(
+      "Executing " + std::to_string(count) + " run(s) of " + std::to_string(m_desc.run.ticks) +
+      " tick(s) on " + std::to_string(jobs) + " thread(s)"
+    );
+
+    m_results.assign(count, BatchResult());
+
+    // Each thread picks the next run to execute: runs have
+    // different durations so a static split would leave some
+    // cores idle at the end of the batch. Each result has its
+    // own slot so no lock is needed.
+    std::atomic<unsigned> next(0u);
+    auto worker = [this, &next, count]() {
+      unsigned id = next.fetch_add(1u);
+
+      while (id < count) {
+        m_results[id] = execute(id);
+        id = next.fetch_add(1u);
+      }
+    };
+
+    Clock::time_point start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned id = 0u ; id < jobs ; ++id) {
+      threads.push_back(std::thread(worker));
+    }
+    for (unsigned id = 0u ; id < threads.size() ; ++id) {
+      threads[id].join();
+    }
+
+    std::chrono::duration<float, std::milli> d = Clock::now() - start;
+    m_elapsed = d.count();
+
+    unsigned failed = 0u;
+    for (unsigned id = 0u ; id < m_results.size() ; ++id) {
+      failed += (m_results[id].success ? 0u : 1u);
+    }
+
+    notice(
+      "Executed " + std::to_string(count) + " run(s) in " + std::to_string(m_elapsed) +
+      "ms, " + std::to_string(failed) + " failed"
+    );
+  }
+
+  const std::vector<BatchResult>&
+  BatchRunner::results() const noexcept {
+    return m_results;
+  }
+
+  void
+  BatchRunner::write(const std::string& file) const {
+    std::ofstream out(file, std::ios::trunc);
+    if (!out.good()) {
+      error(
+        "Failed to write batch results to \"" + file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    for (unsigned id = 0u ; id < m_desc.sweep.size() ; ++id) {
+      out << m_desc.sweep[id].name << ",";
+    }
+    out << "seed,success,ticks,elapsed_ms,ticks_per_s,tick_p50_ms,tick_p99_ms,"
+        << "elements,ants,pheromons,collected,budget\n";
+
+    for (unsigned id = 0u ; id < m_results.size() ; ++id) {
+      const BatchResult& r = m_results[id];
+
+      for (unsigned v = 0u ; v < r.values.size() ; ++v) {
+        out << r.values[v] << ",";
+      }
+
+      out << r.seed << "," << (r.success ? 1 : 0) << "," << r.ticks << ","
+          << r.elapsed << "," << r.ticksPerSecond << "," << r.tick.p50 << "," << r.tick.p99 << ","
+          << r.elements << "," << r.ants << "," << r.pheromons << ","
+          << r.collected << "," << r.budget << "\n";
+    }
+
+    notice("Wrote " + std::to_string(m_results.size()) + " result(s) to \"" + file + "\"");
+  }
+
+  BatchResult
+  BatchRunner::execute(unsigned id) const {
+    // The repeats of a combination are consecutive and the
+    // last axis of the sweep varies the fastest.
+    unsigned repeat = id % m_desc.repeats;
+    unsigned combination = id / m_desc.repeats;
+
+    SimulationParams params = m_desc.params;
+    std::vector<float> values(m_desc.sweep.size(), 0.0f);
+
+    for (int axis = static_cast<int>(m_desc.sweep.size()) - 1 ; axis >= 0 ; --axis) {
+      const SweepAxis& a = m_desc.sweep[axis];
+
+      values[axis] = a.values[combination % a.values.size()];
+      combination /= a.values.size();
+
+      setParam(params, a.name, values[axis]);
+    }
+
+    ScenarioDesc scenario = m_desc.scenario;
+    scenario.seed += static_cast<int>(repeat);
+
+    BatchResult out{
+      values,          // values
+      scenario.seed,   // seed
+      false,           // success
+      0u,              // ticks
+      0.0f,            // elapsed
+      0.0f,            // ticksPerSecond
+      Percentiles{},   // tick
+      0u,              // elements
+      0u,              // ants
+      0u,              // pheromons
+      0.0f,            // collected
+      0.0f             // budget
+    };
+
+    try {
+      WorldShPtr world = std::make_shared<World>(scenario, params);
+      float stock = foodStock(world->grid());
+
+      HeadlessRunner runner(m_desc.run, world);
+      runner.run();
+
+      const TickProfiler& p = world->profiler();
+
+      out.success = true;
+      out.ticks = p.ticks();
+      out.elapsed = runner.elapsed();
+      out.ticksPerSecond = runner.ticksPerSecond();
+      out.tick = p.percentiles(Phase::Tick);
+      out.elements = world->grid().size();
+      out.ants = world->count(Tile::Ant);
+      out.pheromons = world->count(Tile::Pheromon);
+      out.collected = stock - foodStock(world->grid());
+      out.budget = colonyBudget(world->grid());
+    }
+    catch (const utils::CoreException& e) {
+      warn("Run " + std::to_string(id) + " failed: " + e.what());
+    }
+    catch (const std::exception& e) {
+      warn("Run " + std::to_string(id) + " failed: " + e.what());
+    }
+
+    return out;
+  }
+
+}
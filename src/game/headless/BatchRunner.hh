@@ -0,0 +1,186 @@
+#ifndef    BATCH_RUNNER_HH
+# define   BATCH_RUNNER_HH
+
+# include <string>
+# include <vector>
+# include <core_utils/CoreObject.hh>
+# include "HeadlessRunner.hh"
+# include "Scenario.hh"
+# include "SimulationParams.hh"
+
+namespace cellify {
+
+  /// @brief - The values taken by a parameter of the simulation
+  /// in a batch of runs.
+  struct SweepAxis {
+    // The name of the parameter, as accepted by `setParam`.
+    std::string name;
+
+    // The values of the parameter.
+    std::vector<float> values;
+  };
+
+  /// @brief - The parameters varying in a batch of runs: all
+  /// the combinations of their values are simulated.
+  using Sweep = std::vector<SweepAxis>;
+
+  /// @brief - Convenience structure describing a batch of
+  /// independent headless runs.
+  struct BatchDesc {
+    // The description of each run.
+    HeadlessDesc run;
+
+    // The scenario used to generate the world of each run.
+    ScenarioDesc scenario;
+
+    // The parameters of the simulation which are not part of
+    // the sweep.
+    SimulationParams params;
+
+    // The parameters varying between runs.
+    Sweep sweep;
+
+    // The number of runs of each combination of parameters:
+    // each one uses a different seed for the scenario.
+    unsigned repeats;
+
+    // The number of runs executed in parallel, or `0` to use
+    // one per core.
+    unsigned jobs;
+  };
+
+  /**
+   * @brief - Creates a description of a batch without any
+   *          parameter to sweep.
+   * @param run - the description of each run.
+   * @param scenario - the scenario of each run.
+   * @param params - the parameters of the simulation.
+   * @param repeats - the number of runs of each combination.
+   * @param jobs - the number of runs executed in parallel.
+   * @return - the description of the batch.
+   */
+  BatchDesc
+  newBatchDesc(const HeadlessDesc& run = newHeadlessDesc(),
+               const ScenarioDesc& scenario = newScenarioDesc(),
+               const SimulationParams& params = newSimulationParams(),
+               unsigned repeats = 1u,
+               unsigned jobs = 0u) noexcept;
+
+  /// @brief - The throughput and outcome of a single run.
+  struct BatchResult {
+    // The values of the swept parameters, in the order of the
+    // axes of the sweep.
+    std::vector<float> values;
+
+    // The seed of the scenario.
+    int seed;
+
+    // Whether the run completed.
+    bool success;
+
+    // The number of ticks simulated.
+    unsigned ticks;
+
+    // The duration of the run in milliseconds.
+    float elapsed;
+
+    // The number of ticks simulated per second.
+    float ticksPerSecond;
+
+    // The percentiles of the duration of a tick in
+    // milliseconds.
+    Percentiles tick;
+
+    // The number of elements at the end of the run.
+    unsigned elements;
+
+    // The number of ants at the end of the run.
+    unsigned ants;
+
+    // The number of pheromons at the end of the run.
+    unsigned pheromons;
+
+    // The food taken from the deposits during the run.
+    float collected;
+
+    // The budget of the colonies at the end of the run.
+    float budget;
+  };
+
+  /// @brief - Simulates many independent worlds over a grid of
+  /// parameters. Each run uses its own world and is executed
+  /// by one of a pool of threads so that a batch scales with
+  /// the number of cores.
+  class BatchRunner: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Creates a new batch. An error is raised if one
+       *          of the swept parameters does not exist.
+       * @param desc - the description of the batch.
+       */
+      BatchRunner(const BatchDesc& desc);
+
+      /**
+       * @brief - The number of runs of the batch.
+       * @return - the number of runs.
+       */
+      unsigned
+      size() const noexcept;
+
+      /**
+       * @brief - Execute all the runs of the batch. A run which
+       *          fails is reported but does not stop the batch.
+       */
+      void
+      run();
+
+      /**
+       * @brief - Returns the results of the last execution, one
+       *          per run in the order of the combinations.
+       * @return - the results of the runs.
+       */
+      const std::vector<BatchResult>&
+      results() const noexcept;
+
+      /**
+       * @brief - Write the results of the last execution to the
+       *          input file as CSV, one line per run. An error is
+       *          raised if the file can't be opened.
+       * @param file - the path to the output file.
+       */
+      void
+      write(const std::string& file) const;
+
+    private:
+
+      /**
+       * @brief - Execute a single run of the batch.
+       * @param id - the index of the run.
+       * @return - the result of the run.
+       */
+      BatchResult
+      execute(unsigned id) const;
+
+    private:
+
+      /**
+       * @brief - The description of the batch.
+       */
+      BatchDesc m_desc;
+
+      /**
+       * @brief - The results of the last execution.
+       */
+      std::vector<BatchResult> m_results;
+
+      /**
+       * @brief - The duration of the last execution in
+       *          milliseconds.
+       */
+      float m_elapsed;
+  };
+
+}
+
+#endif    /* BATCH_RUNNER_HH */
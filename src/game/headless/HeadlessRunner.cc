@@ -0,0 +1,227 @@
+
+# include "HeadlessRunner.hh"
+# include <chrono>
+# include <sstream>
+
+namespace cellify {
+
+  HeadlessDesc
+  newHeadlessDesc(unsigned ticks,
+                  float tDelta) noexcept
+  {
+    return HeadlessDesc{ticks, tDelta};
+  }
+
+  HeadlessRunner::HeadlessRunner(const HeadlessDesc& desc,
+                                 WorldShPtr world):
+    utils::CoreObject("runner"),
+
+    m_desc(desc),
+    m_world(world),
+    m_observers(),
+
+    m_ticks(0u),
+    m_elapsed(0.0f),
+    m_observed(0.0f)
+  {
+    setService("headless");
+
+    if (m_world == nullptr) {
+      m_world = std::make_shared<World>();
+    }
+  }
+
+  const World&
+  HeadlessRunner::world() const noexcept {
+    return *m_world;
+  }
+
+  float
+  HeadlessRunner::ticksPerSecond() const noexcept {
+    if (m_elapsed <= 0.0f) {
+      return 0.0f;
+    }
+
+    return 1000.0f * m_ticks / m_elapsed;
+  }
+
+  float
+  HeadlessRunner::elapsed() const noexcept {
+    return m_elapsed;
+  }
+
+  float
+  HeadlessRunner::observed() const noexcept {
+    return m_observed;
+  }
+
+  void
+  HeadlessRunner::observe(const Observer& observer) {
+    m_observers.push_back(observer);
+  }
+
+  void
+  HeadlessRunner::run() {
+    using Clock = std::chrono::steady_clock;
+
+    notice(
+      "Simulating " + std::to_string(m_desc.ticks) + " tick(s) of " +
+      std::to_string(m_desc.tDelta) + "s"
+    );
+
+    m_world->resume();
+
+    // Only the steps of the world are accounted for in the
+    // throughput: the observers (e.g. the capture of frames)
+    // are measured separately.
+    std::chrono::duration<float, std::milli> stepping(0.0f);
+    std::chrono::duration<float, std::milli> observing(0.0f);
+
+    for (unsigned id = 0u ; id < m_desc.ticks ; ++id) {
+      Clock::time_point start = Clock::now();
+      m_world->step(m_desc.tDelta);
+      Clock::time_point end = Clock::now();
+
+      stepping += end - start;
+
+      if (m_observers.empty()) {
+        continue;
+      }
+
+      for (unsigned o = 0u ; o < m_observers.size() ; ++o) {
+        m_observers[o](*m_world);
+      }
+
+      observing += Clock::now() - end;
+    }
+
+    m_ticks = m_desc.ticks;
+    m_elapsed = stepping.count();
+    m_observed = observing.count();
+
+    m_world->pause();
+  }
+
+  void
+  HeadlessRunner::replay(const Journal& journal) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Entry> entries = journal.read();
+
+    notice("Replaying " + std::to_string(entries.size()) + " input(s)");
+
+    unsigned ticks = 0u;
+    Clock::time_point start = Clock::now();
+
+    for (unsigned id = 0u ; id < entries.size() ; ++id) {
+      const Entry& e = entries[id];
+
+      switch (e.input) {
+        case Input::Step: {
+          unsigned tick = m_world->profiler().ticks();
+          if (e.tick != tick) {
+            error(
+              "Failed to replay step " + std::to_string(e.tick),
+              "World is at tick " + std::to_string(tick)
+            );
+          }
+
+          m_world->step(e.tDelta);
+          ++ticks;
+
+          std::uint64_t hash = m_world->hash();
+          if (hash != e.hash) {
+            std::stringstream out;
+            out << "Expected hash " << std::hex << e.hash << " but got " << hash;
+
+            error("Replay diverged at tick " + std::to_string(e.tick), out.str());
+          }
+          } break;
+        case Input::Spawn:
+          m_world->spawn(e.pos, e.tile);
+          break;
+        case Input::Pause:
+          m_world->pause();
+          break;
+        case Input::Resume:
+          m_world->resume();
+          break;
+        case Input::Reseed:
+          m_world->reseed();
+          break;
+        default:
+          break;
+      }
+    }
+
+    std::chrono::duration<float, std::milli> d = Clock::now() - start;
+    m_ticks = ticks;
+    m_elapsed = d.count();
+    m_observed = 0.0f;
+
+    m_world->pause();
+
+    notice("Verified the hash of " + std::to_string(ticks) + " tick(s)");
+  }
+
+  void
+  HeadlessRunner::report() const {
+    const TickProfiler& p = m_world->profiler();
+
+    notice(
+      "Simulated " + std::to_string(p.ticks()) + " tick(s) in " +
+      std::to_string(m_elapsed) + "ms (" + std::to_string(ticksPerSecond()) + " tick(s)/s)"
+    );
+    if (!m_observers.empty()) {
+      notice("Spent " + std::to_string(m_observed) + "ms in the observers of the run");
+    }
+
+    for (unsigned id = 0u ; id < static_cast<unsigned>(Phase::Count) ; ++id) {
+      Phase ph = static_cast<Phase>(id);
+      notice("Phase " + phaseToString(ph) + " (ms): " + percentilesToString(p.percentiles(ph), 3));
+    }
+
+    for (unsigned id = 0u ; id < static_cast<unsigned>(Counter::Count) ; ++id) {
+      Counter c = static_cast<Counter>(id);
+      notice("Counter " + counterToString(c) + ": " + percentilesToString(p.percentiles(c), 0));
+    }
+
+    const Population& pop = m_world->population();
+
+    std::string tiles;
+    for (unsigned id = 0u ; id < static_cast<unsigned>(Tile::Count) ; ++id) {
+      tiles += (id == 0u ? "" : ", ") + tileToString(static_cast<Tile>(id)) + ": " + std::to_string(pop.tiles[id]);
+    }
+    notice("Population: " + tiles);
+
+    std::string behaviors;
+    for (unsigned id = 0u ; id < static_cast<unsigned>(Behavior::Count) ; ++id) {
+      behaviors += (id == 0u ? "" : ", ") + behaviorToString(static_cast<Behavior>(id)) + ": " + std::to_string(pop.behaviors[id]);
+    }
+    notice("Behaviors: " + behaviors);
+
+    const Checkpointer& cp = m_world->checkpointer();
+    if (cp.started() > 0u || cp.skipped() > 0u) {
+      notice(
+        "Checkpoints: " + std::to_string(cp.started()) + " started, " +
+        std::to_string(cp.skipped()) + " skipped, " + std::to_string(cp.failed()) +
+        " failed, longest pause " + std::to_string(cp.maxPause()) + "ms"
+      );
+    }
+  }
+
+  void
+  HeadlessRunner::save(const std::string& file) {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start = Clock::now();
+    m_world->save(file);
+    std::chrono::duration<float, std::milli> d = Clock::now() - start;
+
+    notice(
+      "Saved " + std::to_string(m_world->grid().size()) + " element(s) to \"" + file +
+      "\" in " + std::to_string(d.count()) + "ms"
+    );
+  }
+
+}
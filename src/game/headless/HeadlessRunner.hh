@@ -0,0 +1,160 @@
+#ifndef    HEADLESS_RUNNER_HH
+# define   HEADLESS_RUNNER_HH
+
+# include <vector>
+# include <functional>
+# include <core_utils/CoreObject.hh>
+# include "World.hh"
+# include "Journal.hh"
+
+namespace cellify {
+
+  /// @brief - Convenience structure describing a simulation
+  /// to run without any rendering.
+  struct HeadlessDesc {
+    // The number of ticks to simulate.
+    unsigned ticks;
+
+    // The duration of a single tick in seconds.
+    float tDelta;
+  };
+
+  /**
+   * @brief - Creates a default description of a headless run.
+   * @param ticks - the number of ticks to simulate.
+   * @param tDelta - the duration of a tick in seconds.
+   * @return - the description of the run.
+   */
+  HeadlessDesc
+  newHeadlessDesc(unsigned ticks = 1000u,
+                  float tDelta = 0.016f) noexcept;
+
+  class HeadlessRunner: public utils::CoreObject {
+    public:
+
+      /// @brief - A function called with the world after each
+      /// tick of a run.
+      using Observer = std::function<void(const World&)>;
+
+      /**
+       * @brief - Creates a new runner for the input world.
+       * @param desc - the description of the run.
+       * @param world - the world to simulate. In case it is
+       *                null a default world is created.
+       */
+      HeadlessRunner(const HeadlessDesc& desc,
+                     WorldShPtr world = nullptr);
+
+      /**
+       * @brief - Returns the world simulated by this runner. It
+       *          can be used to query the profiler once the run
+       *          is over.
+       * @return - the simulated world.
+       */
+      const World&
+      world() const noexcept;
+
+      /**
+       * @brief - Returns the number of ticks simulated per second
+       *          of wall clock time during the last run.
+       * @return - the throughput of the simulation.
+       */
+      float
+      ticksPerSecond() const noexcept;
+
+      /**
+       * @brief - Returns the time spent stepping the world during
+       *          the last run.
+       * @return - the duration of the last run in milliseconds.
+       */
+      float
+      elapsed() const noexcept;
+
+      /**
+       * @brief - Returns the time spent in the observers during
+       *          the last run.
+       * @return - the duration of the observers in milliseconds.
+       */
+      float
+      observed() const noexcept;
+
+      /**
+       * @brief - Register a function to call after each tick of
+       *          the next runs. Its duration is measured apart
+       *          from the one of the ticks.
+       * @param observer - the function to call.
+       */
+      void
+      observe(const Observer& observer);
+
+      /**
+       * @brief - Simulate the world for the number of ticks set
+       *          in the description.
+       */
+      void
+      run();
+
+      /**
+       * @brief - Replay the inputs recorded in the journal on the
+       *          world, which should be restored from the snapshot
+       *          attached to the journal. The hash of the world is
+       *          verified after each step and an error is raised
+       *          at the first tick where it differs from the one
+       *          recorded. The description of the run is ignored.
+       * @param journal - the journal to replay.
+       */
+      void
+      replay(const Journal& journal);
+
+      /**
+       * @brief - Log a summary of the profiling information of
+       *          the last run.
+       */
+      void
+      report() const;
+
+      /**
+       * @brief - Save the simulated world to a snapshot file.
+       * @param file - the path to the snapshot.
+       */
+      void
+      save(const std::string& file);
+
+    private:
+
+      /**
+       * @brief - The description of the run.
+       */
+      HeadlessDesc m_desc;
+
+      /**
+       * @brief - The world simulated by this runner.
+       */
+      WorldShPtr m_world;
+
+      /**
+       * @brief - The functions called after each tick.
+       */
+      std::vector<Observer> m_observers;
+
+      /**
+       * @brief - The number of ticks simulated during the last run.
+       */
+      unsigned m_ticks;
+
+      /**
+       * @brief - The time spent stepping the world during the last
+       *          run in milliseconds.
+       */
+      float m_elapsed;
+
+      /**
+       * @brief - The time spent in the observers during the last
+       *          run in milliseconds.
+       */
+      float m_observed;
+  };
+
+}
+
+#endif    /* HEADLESS_RUNNER_HH */
@@ -0,0 +1,61 @@
+
+# include "Logging.hh"
+# include <atomic>
+
+namespace {
+
+  /// @brief - The current minimum level of the logs. Read
+  /// from any thread running a simulation, hence atomic.
+  std::atomic<int> g_level(
+    static_cast<int>(cellify::log::defaultLevel())
+  );
+
+}
+
+namespace cellify {
+  namespace log {
+
+    Level
+    defaultLevel() noexcept {
+      if (CELLIFY_MIN_LOG_LEVEL > CELLIFY_LOG_LEVEL_DEBUG) {
+        return static_cast<Level>(CELLIFY_MIN_LOG_LEVEL);
+      }
+
+      return Level::Debug;
+    }
+
+    void
+    setLevel(const Level& level) noexcept {
+      g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    Level
+    level() noexcept {
+      return static_cast<Level>(g_level.load(std::memory_order_relaxed));
+    }
+
+    bool
+    enabled(int level) noexcept {
+      return level >= g_level.load(std::memory_order_relaxed);
+    }
+
+    const char*
+    levelToString(const Level& level) noexcept {
+      switch (level) {
+        case Level::Verbose:
+          return "verbose";
+        case Level::Debug:
+          return "debug";
+        case Level::Info:
+          return "info";
+        case Level::Notice:
+          return "notice";
+        case Level::Warning:
+          return "warning";
+        default:
+          return "unknown";
+      }
+    }
+
+  }
+}
@@ -0,0 +1,97 @@
+#ifndef    LOGGING_HH
+# define   LOGGING_HH
+
+/// @brief - Numeric representation of the log levels. These
+/// are needed by the preprocessor to be able to discard the
+/// messages below the minimum level at compile time.
+# define CELLIFY_LOG_LEVEL_VERBOSE 0
+# define CELLIFY_LOG_LEVEL_DEBUG   1
+# define CELLIFY_LOG_LEVEL_INFO    2
+# define CELLIFY_LOG_LEVEL_NOTICE  3
+# define CELLIFY_LOG_LEVEL_WARNING 4
+
+/// @brief - The minimum level of the messages compiled in the
+/// application. It is usually provided by the build system.
+# ifndef CELLIFY_MIN_LOG_LEVEL
+#  define CELLIFY_MIN_LOG_LEVEL CELLIFY_LOG_LEVEL_VERBOSE
+# endif
+
+namespace cellify {
+  namespace log {
+
+    /// @brief - The levels of logs that can be filtered at
+    /// runtime. The values match the preprocessor ones.
+    enum class Level {
+      Verbose = CELLIFY_LOG_LEVEL_VERBOSE,
+      Debug = CELLIFY_LOG_LEVEL_DEBUG,
+      Info = CELLIFY_LOG_LEVEL_INFO,
+      Notice = CELLIFY_LOG_LEVEL_NOTICE,
+      Warning = CELLIFY_LOG_LEVEL_WARNING
+    };
+
+    /**
+     * @brief - Returns the default level for the logs: it is
+     *          the debug level unless the minimum level set
+     *          at compile time is higher.
+     * @return - the default log level.
+     */
+    Level
+    defaultLevel() noexcept;
+
+    /**
+     * @brief - Define the minimum level for a message to be
+     *          produced at runtime. Messages with a lower level
+     *          are not even formatted.
+     * @param level - the new minimum level.
+     */
+    void
+    setLevel(const Level& level) noexcept;
+
+    /**
+     * @brief - Returns the current minimum level of the logs.
+     * @return - the minimum level of the logs at runtime.
+     */
+    Level
+    level() noexcept;
+
+    /**
+     * @brief - Whether a message with the input level should
+     *          be produced.
+     * @param level - the level of the message.
+     * @return - `true` if the message should be produced.
+     */
+    bool
+    enabled(int level) noexcept;
+
+    /**
+     * @brief - Convert a level to a human readable string.
+     * @param level - the level to convert.
+     * @return - the string representing the level.
+     */
+    const char*
+    levelToString(const Level& level) noexcept;
+
+  }
+}
+
+/// @brief - Lazily produce a log message through the method of
+/// the surrounding `utils::CoreObject`: the arguments are only
+/// evaluated when the level is both compiled in and enabled at
+/// runtime. The first check is resolved at compile time so that
+/// messages below the minimum level cost nothing at all.
+# define CELLIFY_LOG(lvl, method, ...)                          \
+  do {                                                          \
+    if constexpr (CELLIFY_LOG_LEVEL_##lvl >= CELLIFY_MIN_LOG_LEVEL) { \
+      if (::cellify::log::enabled(CELLIFY_LOG_LEVEL_##lvl)) {   \
+        this->method(__VA_ARGS__);                              \
+      }                                                         \
+    }                                                           \
+  } while (false)
+
+# define CELLIFY_VERBOSE(...) CELLIFY_LOG(VERBOSE, verbose, __VA_ARGS__)
+# define CELLIFY_DEBUG(...) CELLIFY_LOG(DEBUG, debug, __VA_ARGS__)
+# define CELLIFY_INFO(...) CELLIFY_LOG(INFO, info, __VA_ARGS__)
+# define CELLIFY_NOTICE(...) CELLIFY_LOG(NOTICE, notice, __VA_ARGS__)
+# define CELLIFY_WARN(...) CELLIFY_LOG(WARNING, warn, __VA_ARGS__)
+
+#endif    /* LOGGING_HH */
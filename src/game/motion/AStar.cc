@@ -1,13 +1,23 @@
 
 # include "AStar.hh"
-# include <deque>
 # include <iterator>
 # include <maths_utils/LocationUtils.hh>
 # include "Node.hh"
 # include "AStarNodes.hh"
+# include "Logging.hh"
+# include "TickProfiler.hh"
+# include "Tracer.hh"
 
 namespace {
 
+  /// @brief - The nodes explored by the searches of the thread.
+  /// Each search resets them rather than allocating new ones.
+  thread_local cellify::AStarNodes g_nodes;
+
+  /// @brief - The neighbors of the node explored by the search
+  /// of the thread.
+  thread_local cellify::Nodes g_neighbors;
+
   bool
   pathTooFar(const cellify::Path& path,
              const utils::Point2i& p,
@@ -55,26 +65,33 @@ namespace cellify {
     // The code for this algorithm has been taken from the
     // below link:
     // https://en.wikipedia.org/wiki/A*_search_algorithm
-    Path out;
     path.clear();
 
+    TRACE_SCOPE("astar", "path");
+    profileCount(Counter::AStarCalls);
+
     if (allowLog) {
-      verbose(
+      CELLIFY_VERBOSE(
         "Starting a* at " + std::to_string(m_start.x()) + "x" + std::to_string(m_start.y()) +
         " to reach " + std::to_string(m_end.x()) + "x" + std::to_string(m_end.y())
       );
     }
 
     // The list of nodes that are currently being explored.
-    AStarNodes nodes;
+    AStarNodes& nodes = g_nodes;
     nodes.seed(m_start, utils::d(m_start, m_end));
 
+    // Count the nodes expanded locally and report them
+    // once the search is over.
+    unsigned expanded = 0u;
+
     while (!nodes.stuck()) {
       // Fetch the best node.
       Node current = nodes.pickBest(true);
+      ++expanded;
 
       if (allowLog) {
-        verbose(
+        CELLIFY_VERBOSE(
           "Picked node " + std::to_string(current.p().x()) + "x" + std::to_string(current.p().y()) +
           " with c " + std::to_string(current.cost()) +
           " h is " + std::to_string(current.heuristic()) +
@@ -84,12 +101,14 @@ namespace cellify {
 
       // In case we reached the end, stop the algorithm.
       if (current.contains(m_end)) {
+        profileCount(Counter::NodesExpanded, expanded);
         return reconstruct(path, nodes, radius, allowLog);
       }
 
       // Generate neighbors for the current node and try
       // to register each of them.
-      Nodes neighbors = current.generateNeighbors(m_end);
+      Nodes& neighbors = g_neighbors;
+      current.generateNeighbors(m_end, neighbors);
       for (unsigned id = 0u ; id < neighbors.size() ; ++id) {
         const Node& neighbor = neighbors[id];
 
@@ -112,21 +131,21 @@ namespace cellify {
     }
 
     // We couldn't reach the goal, the algorithm failed.
+    profileCount(Counter::NodesExpanded, expanded);
     return false;
   }
 
   bool
   AStar::reconstruct(Path& path, const AStarNodes& nodes, float radius, bool allowLog) const noexcept {
     // Reconstruct the path and reverse it as we start
-    // from the end.
-    path.clear();
-    Path out = nodes.reconstruct(m_end, allowLog);
-    out.reverse();
-
-    // Make sure that we reached the starting point. If
-    // this is the case we can copy the path we just built
-    // to the output argument.
-    if (out.begin() != m_start) {
+    // from the end. It is built in place so that the
+    // storage of the previous path is reused.
+    nodes.reconstruct(m_end, path, allowLog);
+    path.reverse();
+
+    // Make sure that we reached the starting point.
+    if (path.begin() != m_start) {
+      path.clear();
       return false;
     }
 
@@ -134,13 +153,11 @@ namespace cellify {
     // limit at any point: if this is the case we
     // will prevent it from being returned as we do
     // not consider it valid.
-    if (pathTooFar(out, m_start, radius)) {
+    if (pathTooFar(path, m_start, radius)) {
+      path.clear();
       return false;
     }
 
-    // Copy the path.
-    std::swap(path, out);
-
     return true;
   }
 
@@ -1,6 +1,12 @@
 
 # include "AStarNodes.hh"
+# include <algorithm>
 # include "Node.hh"
+# include "Logging.hh"
+
+/// @brief - The initial number of slots of the ancestors
+/// table. Must be a power of two.
+# define ANCESTORS_INITIAL_SIZE 256u
 
 namespace cellify {
 
@@ -8,8 +14,11 @@ namespace cellify {
     utils::CoreObject("nodes"),
 
     m_ancestors(),
+    m_links(0u),
+    m_search(0u),
 
     m_openNodes(),
+    m_head(0u),
     m_sorted(true)
   {
     setService("astar");
@@ -17,26 +26,44 @@ namespace cellify {
 
   bool
   AStarNodes::stuck() const noexcept {
-    return m_openNodes.empty();
+    return m_head >= m_openNodes.size();
   }
 
   bool
   AStarNodes::opened() const noexcept {
-    return m_openNodes.size();
+    return m_openNodes.size() > m_head;
   }
 
   void
   AStarNodes::seed(const utils::Point2i& p, float heuristic) noexcept {
-    // Clear data.
+    // Clear data: the links of the previous searches are
+    // not removed but considered as free slots.
     m_openNodes.clear();
-    m_ancestors.clear();
+    m_head = 0u;
+    m_sorted = true;
+
+    m_links = 0u;
+    ++m_search;
+
+    if (m_search == 0u) {
+      // The identifier of the search wrapped around: free
+      // all the slots for good.
+      for (unsigned id = 0u ; id < m_ancestors.size() ; ++id) {
+        m_ancestors[id].search = 0u;
+      }
+
+      m_search = 1u;
+    }
+
+    if (m_ancestors.empty()) {
+      m_ancestors.resize(ANCESTORS_INITIAL_SIZE, Link{utils::Point2i(), utils::Point2i(), 0.0f, 0u});
+    }
 
     // Register the node as an opened node.
     m_openNodes.push_back(Node(p, 0.0f, heuristic));
 
     // And register this node as its own ancestor.
-    std::string h = hash(p);
-    m_ancestors[h] = std::make_pair(h, 0.0f);
+    link(p, p, 0.0f);
   }
 
   bool
@@ -44,34 +71,34 @@ namespace cellify {
                       const utils::Point2i& parent,
                       bool allowLog) noexcept
   {
-    std::string cHash = hash(child.p());
-    std::string pHash = hash(parent);
-
-    Ancestors::iterator anc = m_ancestors.find(cHash);
-    bool exist = (anc != m_ancestors.end());
+    unsigned id = slot(child.p());
+    bool exist = used(id);
 
     // In case the node doesn't exist, we always register
     // it as it's the first time that we can reach it.
     if (!exist) {
-      m_ancestors[cHash] = std::make_pair(pHash, child.cost());
+      link(child.p(), parent, child.cost());
       m_openNodes.push_back(child);
       m_sorted = false;
     }
     // Otherwise the new association should have a better
     // cost than the currently registered one to be used
     // as the new best link.
-    else if (child.cost() < anc->second.second) {
-      anc->second = std::make_pair(pHash, child.cost());
+    else if (child.cost() < m_ancestors[id].cost) {
+      Link& l = m_ancestors[id];
 
       if (allowLog) {
-        verbose(
+        CELLIFY_VERBOSE(
           "Updating " + std::to_string(child.p().x()) + "x" + std::to_string(child.p().y()) +
-          " from (c " + std::to_string(anc->second.second) +
-          " parent: " + anc->first + ")" +
+          " from (c " + std::to_string(l.cost) +
+          " parent: " + hash(l.parent) + ")" +
           " to (c: " + std::to_string(child.cost()) +
-          " parent is " + pHash + ")"
+          " parent is " + hash(parent) + ")"
         );
       }
+
+      l.parent = parent;
+      l.cost = child.cost();
     }
 
     return exist;
@@ -85,41 +112,41 @@ namespace cellify {
         return lhs.cost() + lhs.heuristic() < rhs.cost() + rhs.heuristic();
       };
 
-      std::sort(m_openNodes.begin(), m_openNodes.end(), cmp);
+      std::sort(m_openNodes.begin() + m_head, m_openNodes.end(), cmp);
 
       m_sorted = true;
     }
 
 
-    Node best = m_openNodes.front();
+    Node best = m_openNodes[m_head];
 
     if (pop) {
-      m_openNodes.pop_front();
+      ++m_head;
     }
 
     return best;
   }
 
-  Path
-  AStarNodes::reconstruct(const utils::Point2i& end, bool allowLog) const {
-    Path out(end);
+  void
+  AStarNodes::reconstruct(const utils::Point2i& end, Path& out, bool allowLog) const {
+    out.clear();
+    out.add(end, false);
 
     // Start from the end position and continue until we
     // don't have any parents for the node anymore.
-    std::string h = hash(end);
+    utils::Point2i p = end;
 
-    Ancestors::const_iterator it = m_ancestors.find(h);
+    unsigned id = slot(p);
     bool foundRoot = false;
 
-    while (it != m_ancestors.cend() && !foundRoot) {
-      // Unhash the current position.
-      utils::Point2i p = unhash(h);
+    while (used(id) && !foundRoot) {
+      const Link& l = m_ancestors[id];
 
       if (allowLog) {
-        verbose(
+        CELLIFY_VERBOSE(
           "Registering point " + std::to_string(p.x()) + "x" + std::to_string(p.y()) +
-          " with hash " + h +
-          ", parent is " + it->second.first
+          " with hash " + hash(p) +
+          ", parent is " + hash(l.parent)
         );
       }
 
@@ -127,12 +154,57 @@ namespace cellify {
       out.add(p, false);
 
       // Move to the parents if any.
-      foundRoot = (h == it->second.first);
-      h = it->second.first;
-      it = m_ancestors.find(h);
+      foundRoot = (p == l.parent);
+      p = l.parent;
+      id = slot(p);
+    }
+  }
+
+  unsigned
+  AStarNodes::slot(const utils::Point2i& p) const noexcept {
+    unsigned mask = m_ancestors.size() - 1u;
+
+    unsigned h = static_cast<unsigned>(p.x()) * 73856093u;
+    h ^= static_cast<unsigned>(p.y()) * 19349663u;
+
+    // Probe the following slots until the node or a free
+    // slot is found: the table is never full.
+    unsigned id = h & mask;
+    while (used(id) && m_ancestors[id].child != p) {
+      id = (id + 1u) & mask;
+    }
+
+    return id;
+  }
+
+  bool
+  AStarNodes::used(unsigned id) const noexcept {
+    return m_ancestors[id].search == m_search;
+  }
+
+  void
+  AStarNodes::link(const utils::Point2i& child,
+                   const utils::Point2i& parent,
+                   float cost) noexcept
+  {
+    // Keep the table at most half full so that the probes
+    // stay short. Only the links of the current search are
+    // moved to the larger table.
+    if (2u * (m_links + 1u) > m_ancestors.size()) {
+      Ancestors old;
+      old.swap(m_ancestors);
+
+      m_ancestors.resize(2u * old.size(), Link{utils::Point2i(), utils::Point2i(), 0.0f, 0u});
+
+      for (unsigned id = 0u ; id < old.size() ; ++id) {
+        if (old[id].search == m_search) {
+          m_ancestors[slot(old[id].child)] = old[id];
+        }
+      }
     }
 
-    return out;
+    m_ancestors[slot(child)] = Link{child, parent, cost, m_search};
+    ++m_links;
   }
 
 }
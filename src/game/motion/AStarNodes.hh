@@ -1,9 +1,7 @@
 #ifndef    ASTAR_NODES_HH
 # define   ASTAR_NODES_HH
 
-# include <string>
-# include <deque>
-# include <unordered_map>
+# include <vector>
 # include <core_utils/CoreObject.hh>
 # include "Node.hh"
 # include "Path.hh"
@@ -11,7 +9,9 @@
 namespace cellify {
 
   /// @brief - A convenience structure to manage the list
-  /// of nodes explored by the AStar.
+  /// of nodes explored by the AStar. Seeding the nodes resets
+  /// them without releasing their storage, so that the same
+  /// set can be reused by many searches without allocating.
   class AStarNodes: public utils::CoreObject {
     public:
 
@@ -71,42 +71,103 @@ namespace cellify {
 
       /**
        * @brief - Reconstruct the list of nodes that were traversed
-       *          to reach the input location.
+       *          to reach the input location. The points are added
+       *          from the end location.
        * @param end - the end location to which the path should be
        *              reconstructed.
+       * @param out - the output path, cleared beforehand so that
+       *              its storage is reused.
        * @param allowLog - whether or not the logs are allowed.
-       * @return - the reconstructed path.
        */
-      Path
-      reconstruct(const utils::Point2i& end, bool allowLog) const;
+      void
+      reconstruct(const utils::Point2i& end, Path& out, bool allowLog) const;
 
     private:
 
-      /// @brief - A convenience definition allowing to keep track
-      /// of a node and a cost.
-      using Link = std::pair<std::string, float>;
+      /// @brief - Associates a node reached by the algorithm to
+      /// the parent which allowed to reach it, along with the cost
+      /// to go from the parent to the node.
+      struct Link {
+        // The node reached.
+        utils::Point2i child;
+
+        // The parent of the node.
+        utils::Point2i parent;
+
+        // The cost to reach the node.
+        float cost;
+
+        // The search during which the link was registered: links
+        // registered by previous searches are free slots.
+        unsigned search;
+      };
 
-      /// @brief - An association map where each element has as a key
-      /// the child hash and as a value the hash of the parent which
-      /// allowed to reach the child along with the cost to go from
-      // the parent to the child.
-      using Ancestors = std::unordered_map<std::string, Link>;
+      /// @brief - An open addressing table of links indexed by the
+      /// position of the child. Its size is a power of two.
+      using Ancestors = std::vector<Link>;
 
-      /// @brief - A list of nodes where one can add and remove from
-      /// both ends.
-      using OpenNodes = std::deque<Node>;
+      /// @brief - A list of nodes: the ones before the head were
+      /// already explored.
+      using OpenNodes = std::vector<Node>;
+
+      /**
+       * @brief - Find the slot of the link for the input node. It
+       *          is either the slot where the node is registered or
+       *          the free slot where it should be.
+       * @param p - the position of the node.
+       * @return - the index of the slot.
+       */
+      unsigned
+      slot(const utils::Point2i& p) const noexcept;
+
+      /**
+       * @brief - Whether the slot holds a link registered by the
+       *          current search.
+       * @param id - the index of the slot.
+       * @return - `true` if the slot is used.
+       */
+      bool
+      used(unsigned id) const noexcept;
+
+      /**
+       * @brief - Register a new link for the input node, which is
+       *          not yet registered. The table grows if needed.
+       * @param child - the node reached.
+       * @param parent - the parent of the node.
+       * @param cost - the cost to reach the node.
+       */
+      void
+      link(const utils::Point2i& child,
+           const utils::Point2i& parent,
+           float cost) noexcept;
 
       /**
        * @brief - The ancestors table explored by the algorithm.
        */
       Ancestors m_ancestors;
 
+      /**
+       * @brief - The number of links registered by the current
+       *          search in the ancestors table.
+       */
+      unsigned m_links;
+
+      /**
+       * @brief - The identifier of the current search.
+       */
+      unsigned m_search;
+
       /**
        * @brief - The list of nodes that are currently open to be
        *          explored by the algorithm.
        */
       OpenNodes m_openNodes;
 
+      /**
+       * @brief - The index of the first node still open.
+       */
+      unsigned m_head;
+
       /**
        * @brief - Whether or not the open nodes have been sorted by
        *          relevance already or not.
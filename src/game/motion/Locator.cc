@@ -0,0 +1,19 @@
+
+# include "Locator.hh"
+
+namespace cellify {
+
+  VisibilityQuery
+  newVisibilityQuery(const utils::Point2i& pos,
+                     float radius,
+                     unsigned types) noexcept
+  {
+    return VisibilityQuery{
+      pos,    // pos
+      radius, // radius
+      types,  // types
+      -1      // kind
+    };
+  }
+
+}
@@ -1,10 +1,44 @@
 #ifndef    LOCATOR_HH
 # define   LOCATOR_HH
 
+# include <vector>
 # include <maths_utils/Point2.hh>
 
 namespace cellify {
 
+  /// @brief - Describes the elements looked for by a filtered
+  /// visibility query. The types and kinds of elements are
+  /// expressed as raw values so that the interface does not
+  /// depend on the elements of the implementation.
+  struct VisibilityQuery {
+    // The position around which elements are looked for.
+    utils::Point2i pos;
+
+    // The radius around the position.
+    float radius;
+
+    // A mask of the types of elements of interest: an element
+    // with type `t` is kept if the bit `t` is set.
+    unsigned types;
+
+    // The kind of elements of interest for the types which
+    // define one, or a negative value to keep all of them.
+    int kind;
+  };
+
+  /**
+   * @brief - Create a query for all the elements within the
+   *          input radius of a position.
+   * @param pos - the position to consider.
+   * @param radius - the radius around the position.
+   * @param types - the mask of the types of interest.
+   * @return - the description of the query.
+   */
+  VisibilityQuery
+  newVisibilityQuery(const utils::Point2i& pos,
+                     float radius,
+                     unsigned types = ~0u) noexcept;
+
   class Locator {
     public:
 
@@ -40,6 +74,21 @@ namespace cellify {
       visible(const utils::Point2i& p,
               float d) const noexcept = 0;
 
+      /**
+       * @brief - Interface method allowing to fetch the items
+       *          matching the input query. The filters are
+       *          applied while looking for the items so that
+       *          no intermediate list is created.
+       * @param query - the description of the items to find.
+       * @param out - output list receiving the identifiers of
+       *              the items. It is cleared first: callers
+       *              can reuse it to avoid allocations.
+       * @return - the number of items found.
+       */
+      virtual unsigned
+      visible(const VisibilityQuery& query,
+              std::vector<int>& out) const noexcept = 0;
+
       /**
        * @brief - Fetch the element at the specified index. The
        *          concrete type of the element return is left to
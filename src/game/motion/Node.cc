@@ -35,7 +35,15 @@ namespace cellify {
 
   Nodes
   Node::generateNeighbors(const utils::Point2i& target) const noexcept {
-    std::vector<Node> neighbors(Count);
+    Nodes neighbors;
+    generateNeighbors(target, neighbors);
+
+    return neighbors;
+  }
+
+  void
+  Node::generateNeighbors(const utils::Point2i& target, Nodes& neighbors) const noexcept {
+    neighbors.resize(Count);
 
     utils::Point2i np;
 
@@ -73,8 +81,6 @@ namespace cellify {
       m_c + utils::d(m_p, np),
       utils::d(np, target)
     );
-
-    return neighbors;
   }
 
   std::string
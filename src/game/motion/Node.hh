@@ -67,6 +67,17 @@ namespace cellify {
       Nodes
       generateNeighbors(const utils::Point2i& target) const noexcept;
 
+      /**
+       * @brief - Generate neighbors for this node in the output
+       *          list, which is resized to hold them. This allows
+       *          to reuse the same list for many nodes.
+       * @param target - target, used to compute the heuristic
+       *                 of each neighbor.
+       * @param neighbors - the output list of neighboring nodes.
+       */
+      void
+      generateNeighbors(const utils::Point2i& target, Nodes& neighbors) const noexcept;
+
     private:
 
       /**
@@ -98,8 +98,10 @@ namespace cellify {
       error("Failed to advance on path", "Path is empty");
     }
 
+    // Paths are short so shifting the remaining points is
+    // cheap.
     utils::Point2i p = m_points.front();
-    m_points.pop_front();
+    m_points.erase(m_points.begin());
 
     return p;
   }
@@ -1,14 +1,17 @@
 #ifndef    PATH_HH
 # define   PATH_HH
 
-# include <deque>
+# include <vector>
 # include <maths_utils/Point2.hh>
 # include <core_utils/CoreObject.hh>
 
 namespace cellify {
 
-  /// @brief - Convenience define for a vector of points.
-  using Points = std::deque<utils::Point2i>;
+  /// @brief - Convenience define for a vector of points. A
+  /// vector is used rather than a deque as it does not need
+  /// any allocation when empty, which is the case for most
+  /// of the elements of the world.
+  using Points = std::vector<utils::Point2i>;
 
   /// @brief - A convenience structure to define a path as a list
   /// of point.
@@ -0,0 +1,94 @@
+
+# include "SimulationParams.hh"
+# include <cmath>
+# include <algorithm>
+
+namespace cellify {
+
+  SimulationParams
+  newSimulationParams() noexcept {
+    return SimulationParams{
+      5,      // antVisionRadius
+      500,    // pheromonSpawnInterval
+      5.0f,   // antCargoSpace
+      0.15f,  // pheromonEvaporationRate
+      200,    // antSpawnInterval
+      2,      // antSpawnRadius
+      200,    // idleTime
+      10,     // foodDepositsRadius
+      4u,     // foodDepositsCount
+      50.0f,  // foodStock
+      6       // wallLength
+    };
+  }
+
+  std::vector<std::string>
+  paramNames() noexcept {
+    return std::vector<std::string>{
+      "ant-vision-radius",
+      "pheromon-spawn-interval",
+      "ant-cargo-space",
+      "pheromon-evaporation-rate",
+      "ant-spawn-interval",
+      "ant-spawn-radius",
+      "idle-time",
+      "food-deposits-radius",
+      "food-deposits-count",
+      "food-stock",
+      "wall-length"
+    };
+  }
+
+  bool
+  setParam(SimulationParams& params,
+           const std::string& name,
+           float value) noexcept
+  {
+    int i = static_cast<int>(std::round(value));
+
+    if (name == "ant-vision-radius") {
+      params.antVisionRadius = i;
+    }
+    else if (name == "pheromon-spawn-interval") {
+      params.pheromonSpawnInterval = i;
+    }
+    else if (name == "ant-cargo-space") {
+      params.antCargoSpace = value;
+    }
+    else if (name == "pheromon-evaporation-rate") {
+      params.pheromonEvaporationRate = value;
+    }
+    else if (name == "ant-spawn-interval") {
+      params.antSpawnInterval = i;
+    }
+    else if (name == "ant-spawn-radius") {
+      params.antSpawnRadius = i;
+    }
+    else if (name == "idle-time") {
+      params.idleTime = i;
+    }
+    else if (name == "food-deposits-radius") {
+      params.foodDepositsRadius = i;
+    }
+    else if (name == "food-deposits-count") {
+      params.foodDepositsCount = static_cast<unsigned>(std::max(i, 0));
+    }
+    else if (name == "food-stock") {
+      params.foodStock = value;
+    }
+    else if (name == "wall-length") {
+      params.wallLength = i;
+    }
+    else {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool
+  layoutParam(const std::string& name) noexcept {
+    return name == "food-deposits-radius" || name == "wall-length";
+  }
+
+}
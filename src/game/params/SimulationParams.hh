@@ -0,0 +1,98 @@
+#ifndef    SIMULATION_PARAMS_HH
+# define   SIMULATION_PARAMS_HH
+
+# include <string>
+# include <vector>
+
+namespace cellify {
+
+  /// @brief - Convenience structure regrouping the tuning
+  /// values of the simulation. Each world holds its own set
+  /// so that worlds with different values can be simulated
+  /// side by side.
+  struct SimulationParams {
+    // How far an ant can perceive blocks, in cells. It is
+    // also used to define how far a random target can be
+    // picked from the position of the ant.
+    int antVisionRadius;
+
+    // The interval between two pheromons laid by an ant in
+    // milliseconds.
+    int pheromonSpawnInterval;
+
+    // The amount of food that an ant can carry in one go.
+    float antCargoSpace;
+
+    // The minimum evaporation rate of the pheromons laid by
+    // the ants.
+    float pheromonEvaporationRate;
+
+    // The duration between two consecutive spawns of an ant
+    // by a colony in milliseconds.
+    int antSpawnInterval;
+
+    // The range around a colony where ants are spawned.
+    int antSpawnRadius;
+
+    // The duration an element waits on a cell before moving
+    // to the next one of its path in milliseconds.
+    int idleTime;
+
+    // The radius of the food circle around the colony of the
+    // default world.
+    int foodDepositsRadius;
+
+    // The number of deposits on the food circle of the default
+    // world.
+    unsigned foodDepositsCount;
+
+    // The amount of food in the deposits of the default world.
+    float foodStock;
+
+    // The length of the walls around the colony of the default
+    // world.
+    int wallLength;
+  };
+
+  /**
+   * @brief - Creates the default parameters of the simulation.
+   * @return - the default parameters.
+   */
+  SimulationParams
+  newSimulationParams() noexcept;
+
+  /**
+   * @brief - Returns the names of the parameters which can be
+   *          modified with `setParam`.
+   * @return - the names of the parameters.
+   */
+  std::vector<std::string>
+  paramNames() noexcept;
+
+  /**
+   * @brief - Change the value of a parameter from its name, as
+   *          used on the command line. Integral parameters are
+   *          rounded to the closest value.
+   * @param params - the parameters to modify.
+   * @param name - the name of the parameter.
+   * @param value - the new value of the parameter.
+   * @return - `false` if the name does not match any parameter.
+   */
+  bool
+  setParam(SimulationParams& params,
+           const std::string& name,
+           float value) noexcept;
+
+  /**
+   * @brief - Whether a parameter only describes the default
+   *          layout of the world. Such parameters don't have
+   *          any effect on worlds generated from a scenario.
+   * @param name - the name of the parameter.
+   * @return - `true` if the parameter is a layout parameter.
+   */
+  bool
+  layoutParam(const std::string& name) noexcept;
+
+}
+
+#endif    /* SIMULATION_PARAMS_HH */
@@ -0,0 +1,223 @@
+
+# include "Checkpointer.hh"
+# include <chrono>
+# include <cstdlib>
+# include <algorithm>
+# include <cstdio>
+# include <cerrno>
+# include <csignal>
+# include <cstring>
+# include <thread>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/wait.h>
+# include <sys/resource.h>
+
+/// @brief - The suffix of the file written by a checkpoint
+/// before it is complete.
+# define CHECKPOINT_TEMPORARY_SUFFIX ".tmp"
+
+/// @brief - The niceness of the process writing a checkpoint
+/// so that it does not compete with the simulation.
+# define CHECKPOINT_NICENESS 10
+
+/// @brief - The time in milliseconds given to a checkpoint to
+/// complete before its process is killed.
+# define CHECKPOINT_TIMEOUT 60000
+
+/// @brief - The interval in milliseconds at which the process
+/// writing a checkpoint is polled when waiting for it.
+# define CHECKPOINT_POLL_INTERVAL 5
+
+/// @brief - The size of the buffer staging the data of each
+/// checkpoint in the child process.
+# define CHECKPOINT_BUFFER_SIZE (1u << 20u)
+
+namespace cellify {
+
+  CheckpointDesc
+  newCheckpointDesc(const std::string& file,
+                    unsigned interval) noexcept
+  {
+    return CheckpointDesc{file, interval};
+  }
+
+  Checkpointer::Checkpointer():
+    utils::CoreObject("checkpointer"),
+
+    m_child(-1),
+    m_file(),
+    m_deadline(),
+    m_buffer(),
+
+    m_started(0u),
+    m_skipped(0u),
+    m_failed(0u),
+
+    m_lastPause(0.0f),
+    m_maxPause(0.0f)
+  {
+    setService("persistence");
+  }
+
+  Checkpointer::~Checkpointer() {
+    try {
+      collect(true);
+    }
+    catch (...) {
+      // Nothing more can be done.
+    }
+  }
+
+  bool
+  Checkpointer::busy() {
+    collect(false);
+    return m_child > 0;
+  }
+
+  bool
+  Checkpointer::start(const std::string& file,
+                      const Writer& writer)
+  {
+    using Clock = std::chrono::steady_clock;
+
+    if (busy()) {
+      ++m_skipped;
+      warn("Skipping checkpoint to \"" + file + "\", \"" + m_file + "\" is still being written");
+
+      return false;
+    }
+
+    // Everything needed by the child is prepared before the
+    // fork: it must not allocate.
+    std::string tmp = file + CHECKPOINT_TEMPORARY_SUFFIX;
+    if (m_buffer.empty()) {
+      m_buffer.resize(CHECKPOINT_BUFFER_SIZE);
+    }
+
+    Clock::time_point start = Clock::now();
+    pid_t pid = ::fork();
+
+    if (pid == 0) {
+      // The child only writes the checkpoint with raw system
+      // calls and leaves without running any destructor or
+      // exit handler: they belong to the parent.
+      ::setpriority(PRIO_PROCESS, 0, CHECKPOINT_NICENESS);
+
+      int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      bool ok = (fd >= 0 && writer(fd, m_buffer.data(), m_buffer.size()));
+
+      if (fd >= 0 && ::close(fd) != 0) {
+        ok = false;
+      }
+      if (ok && ::rename(tmp.c_str(), file.c_str()) != 0) {
+        ok = false;
+      }
+
+      ::_exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    std::chrono::duration<float, std::milli> d = Clock::now() - start;
+
+    // A failed fork only loses this checkpoint: the next one
+    // is attempted as usual.
+    if (pid < 0) {
+      ++m_failed;
+      warn("Failed to start checkpoint to \"" + file + "\": " + std::strerror(errno));
+
+      return false;
+    }
+
+    m_child = pid;
+    m_file = file;
+    m_deadline = start + std::chrono::milliseconds(CHECKPOINT_TIMEOUT);
+
+    ++m_started;
+    m_lastPause = d.count();
+    m_maxPause = std::max(m_maxPause, m_lastPause);
+
+    debug("Started checkpoint to \"" + file + "\" in " + std::to_string(m_lastPause) + "ms");
+
+    return true;
+  }
+
+  void
+  Checkpointer::wait() {
+    collect(true);
+  }
+
+  unsigned
+  Checkpointer::started() const noexcept {
+    return m_started;
+  }
+
+  unsigned
+  Checkpointer::skipped() const noexcept {
+    return m_skipped;
+  }
+
+  unsigned
+  Checkpointer::failed() const noexcept {
+    return m_failed;
+  }
+
+  float
+  Checkpointer::lastPause() const noexcept {
+    return m_lastPause;
+  }
+
+  float
+  Checkpointer::maxPause() const noexcept {
+    return m_maxPause;
+  }
+
+  void
+  Checkpointer::collect(bool block) {
+    if (m_child <= 0) {
+      return;
+    }
+
+    int status = 0;
+    pid_t pid = ::waitpid(m_child, &status, WNOHANG);
+
+    while (pid == 0) {
+      // A child which does not complete in time is most
+      // likely stuck: it is killed so that the following
+      // checkpoints are not all skipped.
+      if (std::chrono::steady_clock::now() >= m_deadline) {
+        warn(
+          "Checkpoint to \"" + m_file + "\" did not complete within " +
+          std::to_string(CHECKPOINT_TIMEOUT) + "ms, killing it"
+        );
+
+        ::kill(m_child, SIGKILL);
+        pid = ::waitpid(m_child, &status, 0);
+
+        break;
+      }
+
+      // Still running.
+      if (!block) {
+        return;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(CHECKPOINT_POLL_INTERVAL));
+      pid = ::waitpid(m_child, &status, WNOHANG);
+    }
+
+    m_child = -1;
+
+    if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      ++m_failed;
+      warn("Failed to write checkpoint to \"" + m_file + "\"");
+
+      std::string tmp = m_file + CHECKPOINT_TEMPORARY_SUFFIX;
+      std::remove(tmp.c_str());
+
+      return;
+    }
+
+    debug("Wrote checkpoint to \"" + m_file + "\"");
+  }
+
+}
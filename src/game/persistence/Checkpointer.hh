@@ -0,0 +1,218 @@
+#ifndef    CHECKPOINTER_HH
+# define   CHECKPOINTER_HH
+
+# include <string>
+# include <chrono>
+# include <vector>
+# include <functional>
+# include <sys/types.h>
+# include <core_utils/CoreObject.hh>
+
+namespace cellify {
+
+  /// @brief - Convenience structure describing the periodic
+  /// checkpoints of a world.
+  struct CheckpointDesc {
+    // The path to the snapshot file written by each checkpoint.
+    std::string file;
+
+    // The number of ticks between two checkpoints, or `0` to
+    // disable the checkpoints.
+    unsigned interval;
+  };
+
+  /**
+   * @brief - Creates a description of the checkpoints. By
+   *          default they are disabled.
+   * @param file - the path to the snapshot file.
+   * @param interval - the number of ticks between two of them.
+   * @return - the description of the checkpoints.
+   */
+  CheckpointDesc
+  newCheckpointDesc(const std::string& file = "",
+                    unsigned interval = 0u) noexcept;
+
+  /// @brief - Writes checkpoints in the background. Each of them
+  /// is taken by forking the process: the child inherits a copy
+  /// on write image of the memory which is consistent with the
+  /// moment of the fork, and serializes it while the parent goes
+  /// on with the simulation. The parent is only paused for the
+  /// duration of the fork itself. A single checkpoint is written
+  /// at any time: requests received while the previous one is
+  /// still in progress are skipped.
+  /// The child is a copy of a multi-threaded process: any lock
+  /// held by another thread at the time of the fork stays held
+  /// forever in the child. So the child only performs raw system
+  /// calls, and a child which does not complete in time is killed
+  /// so that it can't block the next checkpoints.
+  class Checkpointer: public utils::CoreObject {
+    public:
+
+      /// @brief - A function writing the checkpoint to the input
+      /// file descriptor, staging data in the input buffer. It is
+      /// called in the child process so it should not allocate,
+      /// log nor take any lock. It returns `false` on failure.
+      using Writer = std::function<bool(int, char*, unsigned)>;
+
+      /**
+       * @brief - Create a new checkpointer with no checkpoint in
+       *          progress.
+       */
+      Checkpointer();
+
+      /**
+       * @brief - Wait for the checkpoint in progress if any so
+       *          that it is not left incomplete.
+       */
+      ~Checkpointer();
+
+      /**
+       * @brief - Deleted copy constructor: the object tracks the
+       *          child process writing the checkpoint.
+       */
+      Checkpointer(const Checkpointer&) = delete;
+
+      /**
+       * @brief - Deleted assignment operator.
+       */
+      Checkpointer&
+      operator=(const Checkpointer&) = delete;
+
+      /**
+       * @brief - Whether a checkpoint is still being written.
+       *          The child process is collected in case it is
+       *          terminated, or killed in case it exceeded its
+       *          deadline.
+       * @return - `true` if a checkpoint is in progress.
+       */
+      bool
+      busy();
+
+      /**
+       * @brief - Start a new checkpoint. The writer is called in
+       *          a child process with a temporary file which is
+       *          renamed to the final file once complete: a crash
+       *          during the write never corrupts the previous
+       *          checkpoint.
+       * @param file - the path to the checkpoint.
+       * @param writer - the function producing the checkpoint.
+       * @return - `false` if the checkpoint was skipped because
+       *           another one is still in progress or the child
+       *           process could not be started.
+       */
+      bool
+      start(const std::string& file,
+            const Writer& writer);
+
+      /**
+       * @brief - Block until the checkpoint in progress if any
+       *          is written or exceeds its deadline.
+       */
+      void
+      wait();
+
+      /**
+       * @brief - The number of checkpoints started so far.
+       * @return - the number of checkpoints started.
+       */
+      unsigned
+      started() const noexcept;
+
+      /**
+       * @brief - The number of checkpoints skipped because the
+       *          previous one was still in progress.
+       * @return - the number of checkpoints skipped.
+       */
+      unsigned
+      skipped() const noexcept;
+
+      /**
+       * @brief - The number of checkpoints that failed to be
+       *          written.
+       * @return - the number of failed checkpoints.
+       */
+      unsigned
+      failed() const noexcept;
+
+      /**
+       * @brief - The duration during which the caller was paused
+       *          by the last checkpoint.
+       * @return - the last pause in milliseconds.
+       */
+      float
+      lastPause() const noexcept;
+
+      /**
+       * @brief - The longest duration during which the caller was
+       *          paused by a checkpoint.
+       * @return - the longest pause in milliseconds.
+       */
+      float
+      maxPause() const noexcept;
+
+    private:
+
+      /**
+       * @brief - Collect the child process writing the checkpoint.
+       *          It is killed in case it exceeded its deadline, and
+       *          its temporary file is removed in case it failed.
+       * @param block - whether to wait for its termination.
+       */
+      void
+      collect(bool block);
+
+    private:
+
+      /**
+       * @brief - The identifier of the process writing the current
+       *          checkpoint, or `-1` if there's none.
+       */
+      pid_t m_child;
+
+      /**
+       * @brief - The file written by the current checkpoint.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The moment after which the current checkpoint is
+       *          considered stuck.
+       */
+      std::chrono::steady_clock::time_point m_deadline;
+
+      /**
+       * @brief - The buffer used by the child to stage the data
+       *          of the checkpoint. It is allocated by the parent
+       *          as the child should not allocate.
+       */
+      std::vector<char> m_buffer;
+
+      /**
+       * @brief - The number of checkpoints started.
+       */
+      unsigned m_started;
+
+      /**
+       * @brief - The number of checkpoints skipped.
+       */
+      unsigned m_skipped;
+
+      /**
+       * @brief - The number of checkpoints which failed.
+       */
+      unsigned m_failed;
+
+      /**
+       * @brief - The last pause in milliseconds.
+       */
+      float m_lastPause;
+
+      /**
+       * @brief - The longest pause in milliseconds.
+       */
+      float m_maxPause;
+  };
+
+}
+
+#endif    /* CHECKPOINTER_HH */
@@ -0,0 +1,315 @@
+
+# include "History.hh"
+# include <algorithm>
+
+/// @brief - The approximate memory used by an element of the
+/// oldest restore point on top of its encoded representation:
+/// the serial, the buffer and the node of the hash map.
+# define STATE_ENTRY_OVERHEAD (sizeof(std::uint64_t) + sizeof(std::vector<char>) + 2u * sizeof(void*))
+
+namespace cellify {
+
+  HistoryDesc
+  newHistoryDesc(unsigned interval,
+                 std::size_t budget) noexcept
+  {
+    return HistoryDesc{interval, budget};
+  }
+
+  History::History(const HistoryDesc& desc):
+    utils::CoreObject("history"),
+
+    m_desc(desc),
+
+    m_hasBase(false),
+    m_baseMoment(zero()),
+    m_baseRng(),
+    m_base(),
+    m_baseBytes(0u),
+
+    m_deltas(),
+    m_deltasBytes(0u),
+
+    m_cursor(-1),
+    m_overBudget(false)
+  {
+    setService("persistence");
+  }
+
+  const HistoryDesc&
+  History::desc() const noexcept {
+    return m_desc;
+  }
+
+  void
+  History::reset(const HistoryDesc& desc) noexcept {
+    m_desc = desc;
+    clear();
+  }
+
+  bool
+  History::enabled() const noexcept {
+    return m_desc.interval > 0u;
+  }
+
+  unsigned
+  History::size() const noexcept {
+    return m_hasBase ? 1u + m_deltas.size() : 0u;
+  }
+
+  std::size_t
+  History::bytes() const noexcept {
+    return m_baseBytes + m_deltasBytes;
+  }
+
+  unsigned
+  History::cursor() const noexcept {
+    if (m_cursor >= 0) {
+      return static_cast<unsigned>(m_cursor);
+    }
+
+    return size();
+  }
+
+  TimeStamp
+  History::moment(unsigned id) const {
+    if (id >= size()) {
+      error(
+        "Failed to fetch restore point " + std::to_string(id),
+        "Only " + std::to_string(size()) + " available"
+      );
+    }
+
+    return (id == 0u ? m_baseMoment : m_deltas[id - 1u].moment);
+  }
+
+  void
+  History::capture(const TimeStamp& moment,
+                   const utils::RNG& rng,
+                   const Elements& elements,
+                   const Serials& removed)
+  {
+    // Discard the restore points which are not part of
+    // the simulation anymore.
+    if (m_cursor >= 0) {
+      while (m_deltas.size() > static_cast<unsigned>(m_cursor)) {
+        const Delta& d = m_deltas.back();
+        m_deltasBytes -= footprint(d);
+        m_deltas.pop_back();
+      }
+
+      m_cursor = -1;
+    }
+
+    if (!m_hasBase) {
+      for (unsigned id = 0u ; id < elements.size() ; ++id) {
+        Element& e = *elements[id];
+
+        std::vector<char>& buf = m_base[e.serial()];
+        encodeElement(e, moment, buf);
+        e.clean();
+
+        m_baseBytes += buf.size() + STATE_ENTRY_OVERHEAD;
+      }
+
+      m_baseMoment = moment;
+      m_baseRng = rng;
+      m_hasBase = true;
+
+      return;
+    }
+
+    Delta d{moment, rng, std::vector<char>(), std::vector<unsigned>(), Serials(), removed};
+
+    for (unsigned id = 0u ; id < elements.size() ; ++id) {
+      Element& e = *elements[id];
+      if (!e.dirty()) {
+        continue;
+      }
+
+      d.offsets.push_back(d.changed.size());
+      d.serials.push_back(e.serial());
+      encodeElement(e, moment, d.changed);
+
+      e.clean();
+    }
+
+    d.changed.shrink_to_fit();
+    d.offsets.shrink_to_fit();
+    d.serials.shrink_to_fit();
+
+    m_deltasBytes += footprint(d);
+    m_deltas.push_back(std::move(d));
+
+    shrink();
+  }
+
+  Elements
+  History::restore(unsigned id, TimeStamp& moment) const {
+    if (id >= size()) {
+      error(
+        "Failed to restore point " + std::to_string(id),
+        "Only " + std::to_string(size()) + " available"
+      );
+    }
+
+    // Gather the most recent representation of each
+    // element without copying it.
+    std::unordered_map<std::uint64_t, const char*> view;
+    view.reserve(m_base.size());
+
+    for (State::const_iterator it = m_base.cbegin() ; it != m_base.cend() ; ++it) {
+      view[it->first] = it->second.data();
+    }
+    moment = m_baseMoment;
+
+    for (unsigned dId = 0u ; dId < id ; ++dId) {
+      const Delta& d = m_deltas[dId];
+
+      for (unsigned r = 0u ; r < d.removed.size() ; ++r) {
+        view.erase(d.removed[r]);
+      }
+      for (unsigned c = 0u ; c < d.serials.size() ; ++c) {
+        view[d.serials[c]] = d.changed.data() + d.offsets[c];
+      }
+
+      moment = d.moment;
+    }
+
+    std::vector<std::pair<std::uint64_t, const char*>> ordered(view.cbegin(), view.cend());
+    std::sort(ordered.begin(), ordered.end());
+
+    Elements out;
+    out.reserve(ordered.size());
+
+    for (unsigned eId = 0u ; eId < ordered.size() ; ++eId) {
+      unsigned size = 0u;
+      ElementShPtr e = decode(ordered[eId].second, size);
+
+      // Elements which didn't change since an older restore
+      // point were encoded at that moment: the time elapsed
+      // since their last move is computed again.
+      e->setSerial(ordered[eId].first);
+      e->pause(moment);
+      e->clean();
+
+      out.push_back(e);
+    }
+
+    return out;
+  }
+
+  Elements
+  History::rewind(unsigned id, TimeStamp& moment, utils::RNG& rng) {
+    Elements out = restore(id, moment);
+    rng = (id == 0u ? m_baseRng : m_deltas[id - 1u].rng);
+    m_cursor = static_cast<int>(id);
+
+    return out;
+  }
+
+  unsigned
+  History::bisect(const Predicate& predicate) const {
+    unsigned lo = 0u;
+    unsigned hi = size();
+
+    while (lo < hi) {
+      unsigned mid = lo + (hi - lo) / 2u;
+
+      TimeStamp moment;
+      if (predicate(restore(mid, moment))) {
+        hi = mid;
+      }
+      else {
+        lo = mid + 1u;
+      }
+    }
+
+    return lo;
+  }
+
+  void
+  History::clear() noexcept {
+    m_hasBase = false;
+    m_base.clear();
+    m_baseBytes = 0u;
+
+    m_deltas.clear();
+    m_deltasBytes = 0u;
+
+    m_cursor = -1;
+    m_overBudget = false;
+  }
+
+  std::size_t
+  History::footprint(const Delta& d) noexcept {
+    return sizeof(Delta) + d.changed.size() + sizeof(unsigned) * d.offsets.size() +
+           sizeof(std::uint64_t) * (d.serials.size() + d.removed.size());
+  }
+
+  void
+  History::encodeElement(const Element& e,
+                         const TimeStamp& moment,
+                         std::vector<char>& out) const
+  {
+    // The world is running when restore points are taken:
+    // the elapsed time since the last move is computed as
+    // it would be when pausing the element.
+    if (!encode(e, moment - e.last(), out)) {
+      error(
+        "Failed to capture element at " + e.pos().toString(),
+        "Specific data is too large"
+      );
+    }
+  }
+
+  void
+  History::shrink() {
+    unsigned folded = 0u;
+
+    while (bytes() > m_desc.budget && !m_deltas.empty()) {
+      Delta& d = m_deltas.front();
+
+      for (unsigned r = 0u ; r < d.removed.size() ; ++r) {
+        State::iterator it = m_base.find(d.removed[r]);
+        if (it != m_base.end()) {
+          m_baseBytes -= it->second.size() + STATE_ENTRY_OVERHEAD;
+          m_base.erase(it);
+        }
+      }
+
+      for (unsigned c = 0u ; c < d.serials.size() ; ++c) {
+        unsigned end = (c + 1u < d.offsets.size() ? d.offsets[c + 1u] : d.changed.size());
+
+        std::vector<char>& buf = m_base[d.serials[c]];
+        if (buf.empty()) {
+          m_baseBytes += STATE_ENTRY_OVERHEAD;
+        }
+
+        m_baseBytes -= buf.size();
+        buf.assign(d.changed.data() + d.offsets[c], d.changed.data() + end);
+        m_baseBytes += buf.size();
+      }
+
+      m_baseMoment = d.moment;
+      m_baseRng = d.rng;
+
+      m_deltasBytes -= footprint(d);
+      m_deltas.pop_front();
+
+      ++folded;
+    }
+
+    if (folded > 0u) {
+      verbose("Folded " + std::to_string(folded) + " restore point(s) to respect the budget");
+    }
+    if (bytes() > m_desc.budget && !m_overBudget) {
+      m_overBudget = true;
+      warn(
+        "History uses " + std::to_string(bytes()) + " byte(s) which exceeds the budget of " +
+        std::to_string(m_desc.budget) + " byte(s)"
+      );
+    }
+  }
+
+}
@@ -0,0 +1,296 @@
+#ifndef    HISTORY_HH
+# define   HISTORY_HH
+
+# include <deque>
+# include <vector>
+# include <cstdint>
+# include <functional>
+# include <unordered_map>
+# include <core_utils/CoreObject.hh>
+# include <core_utils/RNG.hh>
+# include "Grid.hh"
+# include "Snapshot.hh"
+
+namespace cellify {
+
+  /// @brief - Convenience structure describing the history of
+  /// a world kept in memory.
+  struct HistoryDesc {
+    // The number of ticks between two restore points, or `0`
+    // to disable the history.
+    unsigned interval;
+
+    // The maximum amount of memory used by the history, in
+    // bytes.
+    std::size_t budget;
+  };
+
+  /**
+   * @brief - Creates a description of the history. By default
+   *          it is disabled.
+   * @param interval - the number of ticks between two restore
+   *                   points.
+   * @param budget - the maximum memory used by the history in
+   *                 bytes.
+   * @return - the description of the history.
+   */
+  HistoryDesc
+  newHistoryDesc(unsigned interval = 0u,
+                 std::size_t budget = 64u * 1024u * 1024u) noexcept;
+
+  /// @brief - A bounded history of the states of a world. The
+  /// oldest restore point is kept in full while the following
+  /// ones are stored as deltas: each delta only holds the
+  /// elements which changed since the previous restore point
+  /// (as reported by their dirty flag) and the serials of the
+  /// elements removed in the meantime. When the memory budget
+  /// is exceeded, the oldest delta is folded into the oldest
+  /// restore point.
+  /// Each restore point keeps a copy of the random number
+  /// generator of the world rather than a seed drawn from it:
+  /// capturing a restore point doesn't change the simulation.
+  class History: public utils::CoreObject {
+    public:
+
+      /// @brief - A predicate evaluated on the elements of a
+      /// restore point.
+      using Predicate = std::function<bool(const Elements&)>;
+
+      /**
+       * @brief - Create a new empty history.
+       * @param desc - the description of the history.
+       */
+      History(const HistoryDesc& desc = newHistoryDesc());
+
+      /**
+       * @brief - Returns the description of the history.
+       * @return - the description of the history.
+       */
+      const HistoryDesc&
+      desc() const noexcept;
+
+      /**
+       * @brief - Change the description of the history. All the
+       *          restore points are removed.
+       * @param desc - the new description of the history.
+       */
+      void
+      reset(const HistoryDesc& desc) noexcept;
+
+      /**
+       * @brief - Whether restore points should be captured.
+       * @return - `true` if the history is enabled.
+       */
+      bool
+      enabled() const noexcept;
+
+      /**
+       * @brief - The number of restore points available.
+       * @return - the number of restore points.
+       */
+      unsigned
+      size() const noexcept;
+
+      /**
+       * @brief - The approximate memory used by the history.
+       * @return - the memory used in bytes.
+       */
+      std::size_t
+      bytes() const noexcept;
+
+      /**
+       * @brief - The index of the restore point which was last
+       *          restored, or `size()` if none was restored since
+       *          the last capture.
+       * @return - the index of the current restore point.
+       */
+      unsigned
+      cursor() const noexcept;
+
+      /**
+       * @brief - The moment of the simulation of a restore point.
+       * @param id - the index of the restore point.
+       * @return - the moment of the restore point.
+       */
+      TimeStamp
+      moment(unsigned id) const;
+
+      /**
+       * @brief - Capture a new restore point. In case a restore
+       *          point was restored since the last capture, the
+       *          ones after it are discarded first. The dirty
+       *          flag of the elements is cleared.
+       * @param moment - the moment of the simulation.
+       * @param rng - the random number generator of the world.
+       * @param elements - the elements of the world.
+       * @param removed - the serials of the elements removed since
+       *                  the last capture.
+       */
+      void
+      capture(const TimeStamp& moment,
+              const utils::RNG& rng,
+              const Elements& elements,
+              const Serials& removed);
+
+      /**
+       * @brief - Build the elements of a restore point, ordered
+       *          by serial so that they are in the same order as
+       *          in the grid when they were captured. They keep
+       *          their serials and are not dirty.
+       * @param id - the index of the restore point.
+       * @param moment - output value holding the moment of the
+       *                 simulation at this point.
+       * @return - the elements of the restore point.
+       */
+      Elements
+      restore(unsigned id, TimeStamp& moment) const;
+
+      /**
+       * @brief - Restore a restore point and make it the current
+       *          one: the next capture discards the points after
+       *          it.
+       * @param id - the index of the restore point.
+       * @param moment - output value holding the moment of the
+       *                 simulation at this point.
+       * @param rng - output value holding the random number
+       *              generator of the world at this point.
+       * @return - the elements of the restore point.
+       */
+      Elements
+      rewind(unsigned id, TimeStamp& moment, utils::RNG& rng);
+
+      /**
+       * @brief - Find the first restore point for which the input
+       *          predicate holds, assuming that once it holds it
+       *          stays true for the following points. This allows
+       *          to find when a behavior changed in a logarithmic
+       *          number of restorations.
+       * @param predicate - the predicate to evaluate.
+       * @return - the index of the first restore point where the
+       *           predicate holds or `size()` if there's none.
+       */
+      unsigned
+      bisect(const Predicate& predicate) const;
+
+      /**
+       * @brief - Remove all the restore points.
+       */
+      void
+      clear() noexcept;
+
+    private:
+
+      /// @brief - The changes between two restore points.
+      struct Delta {
+        // The moment of the simulation.
+        TimeStamp moment;
+
+        // The random number generator of the world.
+        utils::RNG rng;
+
+        // The encoded elements which changed, one after the
+        // other.
+        std::vector<char> changed;
+
+        // The offset of each changed element in the buffer.
+        std::vector<unsigned> offsets;
+
+        // The serials of the changed elements, in the order
+        // they appear in the buffer.
+        Serials serials;
+
+        // The serials of the removed elements.
+        Serials removed;
+      };
+
+      /// @brief - The encoded elements of a restore point indexed
+      /// by serial.
+      using State = std::unordered_map<std::uint64_t, std::vector<char>>;
+
+      /**
+       * @brief - Encode an element, raising an error if it is not
+       *          possible.
+       * @param e - the element to encode.
+       * @param moment - the moment of the simulation.
+       * @param out - the buffer to append the element to.
+       */
+      void
+      encodeElement(const Element& e,
+                    const TimeStamp& moment,
+                    std::vector<char>& out) const;
+
+      /**
+       * @brief - The approximate memory used by a delta.
+       * @param d - the delta.
+       * @return - the memory used in bytes.
+       */
+      static std::size_t
+      footprint(const Delta& d) noexcept;
+
+      /**
+       * @brief - Fold the oldest delta into the base restore point
+       *          until the memory budget is respected.
+       */
+      void
+      shrink();
+
+    private:
+
+      /**
+       * @brief - The description of the history.
+       */
+      HistoryDesc m_desc;
+
+      /**
+       * @brief - Whether the oldest restore point exists.
+       */
+      bool m_hasBase;
+
+      /**
+       * @brief - The moment of the oldest restore point.
+       */
+      TimeStamp m_baseMoment;
+
+      /**
+       * @brief - The random number generator of the world at the
+       *          oldest restore point.
+       */
+      utils::RNG m_baseRng;
+
+      /**
+       * @brief - The elements of the oldest restore point.
+       */
+      State m_base;
+
+      /**
+       * @brief - The memory used by the oldest restore point.
+       */
+      std::size_t m_baseBytes;
+
+      /**
+       * @brief - The deltas leading to the following restore points.
+       */
+      std::deque<Delta> m_deltas;
+
+      /**
+       * @brief - The memory used by the deltas.
+       */
+      std::size_t m_deltasBytes;
+
+      /**
+       * @brief - The index of the last restored point, or a
+       *          negative value if none was restored since the
+       *          last capture.
+       */
+      int m_cursor;
+
+      /**
+       * @brief - Whether the oldest restore point alone exceeds
+       *          the budget, which is only reported once.
+       */
+      bool m_overBudget;
+  };
+
+}
+
+#endif    /* HISTORY_HH */
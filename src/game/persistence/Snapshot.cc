@@ -0,0 +1,765 @@
+
+# include "Snapshot.hh"
+# include <cerrno>
+# include <cstring>
+# include <memory>
+# include <algorithm>
+# include <type_traits>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "Ant.hh"
+# include "Colony.hh"
+# include "Food.hh"
+# include "Pheromon.hh"
+
+/// @brief - The magic bytes identifying a snapshot file.
+# define SNAPSHOT_MAGIC "CELLSNAP"
+
+/// @brief - The maximum size of the specific data attached
+/// to an element.
+# define ELEMENT_DATA_SIZE 16u
+
+/// @brief - The alignment of the sections in the file.
+# define SECTION_ALIGNMENT 8u
+
+/// @brief - The size of the buffer staging the records before
+/// they are written to the file when saving a snapshot.
+# define SNAPSHOT_STAGING_SIZE (1u << 20u)
+
+namespace {
+
+  /// @brief - The kind of brain attached to an element.
+  enum class Brain: std::uint8_t {
+    None,
+    Ant,
+    Colony,
+    Food,
+    Pheromon
+  };
+
+  /// @brief - Describes an array of records in the file.
+  struct Section {
+    // The offset of the first record in bytes.
+    std::uint64_t offset;
+
+    // The number of records.
+    std::uint64_t count;
+  };
+
+  /// @brief - The header of a snapshot file.
+  struct Header {
+    // Identifies the file as a snapshot.
+    char magic[8];
+
+    // The version of the format.
+    std::uint32_t version;
+
+    // The size of the header, as an additional safety net.
+    std::uint32_t size;
+
+    // The moment of the simulation.
+    cellify::TimeStamp moment;
+
+    // The seed of the random number generator.
+    std::int32_t seed;
+
+    // The arrays of records.
+    Section elements;
+    Section points;
+    Section ants;
+    Section colonies;
+    Section foods;
+    Section pheromons;
+  };
+
+  /// @brief - The record of a single element.
+  struct ElementRecord {
+    // The position of the element.
+    std::int32_t x;
+    std::int32_t y;
+
+    // The type of the element.
+    std::uint8_t tile;
+
+    // The kind of brain of the element.
+    Brain brain;
+
+    // The size of the specific data.
+    std::uint8_t dataSize;
+
+    // Unused, kept for alignment.
+    std::uint8_t padding;
+
+    // The index of the brain in the array of its kind.
+    std::uint32_t brainIndex;
+
+    // The range of points of the path of the element.
+    std::uint32_t pathStart;
+    std::uint32_t pathSize;
+
+    // The motion properties of the element.
+    cellify::TimeStamp last;
+    cellify::Duration elapsed;
+
+    // The specific data of the element.
+    char data[ELEMENT_DATA_SIZE];
+  };
+
+  /// @brief - The record of a point of a path.
+  struct PointRecord {
+    std::int32_t x;
+    std::int32_t y;
+  };
+
+  /// @brief - The record of a food deposit.
+  struct FoodRecord {
+    float stock;
+  };
+
+  /// @brief - The record of a pheromon.
+  struct PheromonRecord {
+    cellify::Scent scent;
+    cellify::TimeStamp created;
+    float amount;
+    float evaporation;
+  };
+
+  static_assert(std::is_trivially_copyable<cellify::AntState>::value, "Ant state should be trivially copyable");
+  static_assert(std::is_trivially_copyable<cellify::ColonyState>::value, "Colony state should be trivially copyable");
+
+  /// @brief - The state of the brain of an element.
+  union Payload {
+    cellify::AntState ant;
+    cellify::ColonyState colony;
+    FoodRecord food;
+    PheromonRecord pheromon;
+  };
+
+  /**
+   * @brief - Fill the record of an element, except for the
+   *          references to its brain and path.
+   * @param e - the element.
+   * @param elapsed - the time elapsed since the last move.
+   * @param r - the record to fill.
+   * @return - `false` if the data of the element is too big.
+   */
+  bool
+  describe(const cellify::Element& e, const cellify::Duration& elapsed, ElementRecord& r) noexcept {
+    std::memset(&r, 0, sizeof(ElementRecord));
+
+    r.x = e.pos().x();
+    r.y = e.pos().y();
+    r.tile = static_cast<std::uint8_t>(e.type());
+    r.brain = Brain::None;
+
+    if (e.dataSize() > ELEMENT_DATA_SIZE) {
+      return false;
+    }
+    r.dataSize = static_cast<std::uint8_t>(e.dataSize());
+    if (e.hasData()) {
+      std::memcpy(r.data, e.data(), e.dataSize());
+    }
+
+    r.last = e.last();
+    r.elapsed = elapsed;
+
+    return true;
+  }
+
+  /**
+   * @brief - Describe the state of the brain of an element.
+   * @param brain - the brain.
+   * @param p - the state of the brain.
+   * @return - the kind of brain.
+   */
+  Brain
+  describe(const cellify::AIShPtr& brain, Payload& p) noexcept {
+    // The state is cleared so that padding bytes are always
+    // the same: this keeps the snapshots reproducible.
+    std::memset(&p, 0, sizeof(Payload));
+
+    // Plain casts avoid touching the reference counts of the
+    // brains: this is called several times per element when
+    // saving a snapshot.
+    if (const cellify::Ant* a = dynamic_cast<const cellify::Ant*>(brain.get())) {
+      // The ant state contains padding: copy its fields one
+      // by one rather than the whole structure.
+      cellify::AntState as = a->state();
+
+      p.ant.behavior = as.behavior;
+      p.ant.lastPheromon = as.lastPheromon;
+      p.ant.hasTarget = as.hasTarget;
+      p.ant.randomTarget = as.randomTarget;
+      p.ant.targetX = as.targetX;
+      p.ant.targetY = as.targetY;
+      p.ant.lastX = as.lastX;
+      p.ant.lastY = as.lastY;
+      p.ant.dirX = as.dirX;
+      p.ant.dirY = as.dirY;
+      p.ant.food = as.food;
+
+      return Brain::Ant;
+    }
+    if (const cellify::Colony* c = dynamic_cast<const cellify::Colony*>(brain.get())) {
+      p.colony = c->state();
+      return Brain::Colony;
+    }
+    if (const cellify::Food* f = dynamic_cast<const cellify::Food*>(brain.get())) {
+      p.food = FoodRecord{f->stock()};
+      return Brain::Food;
+    }
+    if (const cellify::Pheromon* ph = dynamic_cast<const cellify::Pheromon*>(brain.get())) {
+      p.pheromon = PheromonRecord{ph->kind(), ph->created(), ph->amount(), ph->evaporation()};
+      return Brain::Pheromon;
+    }
+
+    return Brain::None;
+  }
+
+  /**
+   * @brief - The size of the state of a kind of brain.
+   * @param kind - the kind of brain.
+   * @return - the size of its state in bytes.
+   */
+  unsigned
+  payloadSize(const Brain& kind) noexcept {
+    switch (kind) {
+      case Brain::Ant:
+        return sizeof(cellify::AntState);
+      case Brain::Colony:
+        return sizeof(cellify::ColonyState);
+      case Brain::Food:
+        return sizeof(FoodRecord);
+      case Brain::Pheromon:
+        return sizeof(PheromonRecord);
+      case Brain::None:
+      default:
+        return 0u;
+    }
+  }
+
+  /**
+   * @brief - Create a brain from its state. Each brain receives
+   *          a new identifier.
+   * @param kind - the kind of brain.
+   * @param data - the state of the brain.
+   * @return - the brain or null if the kind is `None`.
+   */
+  cellify::AIShPtr
+  brainOf(const Brain& kind, const char* data) {
+    Payload p;
+    std::memcpy(&p, data, payloadSize(kind));
+
+    switch (kind) {
+      case Brain::Ant:
+        return std::make_shared<cellify::Ant>(utils::Uuid::create(), p.ant);
+      case Brain::Colony:
+        return std::make_shared<cellify::Colony>(utils::Uuid::create(), p.colony);
+      case Brain::Food:
+        return std::make_shared<cellify::Food>(p.food.stock);
+      case Brain::Pheromon:
+        return std::make_shared<cellify::Pheromon>(p.pheromon.scent, p.pheromon.created, p.pheromon.amount, p.pheromon.evaporation);
+      case Brain::None:
+      default:
+        return nullptr;
+    }
+  }
+
+  /**
+   * @brief - Create an element from its record.
+   * @param r - the record of the element.
+   * @param brain - the brain of the element.
+   * @param points - the points of its path.
+   * @return - the element.
+   */
+  cellify::ElementShPtr
+  elementOf(const ElementRecord& r, cellify::AIShPtr brain, const PointRecord* points) {
+    // The body of an element shares the identifier of its
+    // brain (see `newElement`).
+    cellify::ElementShPtr e = std::make_shared<cellify::Element>(
+      static_cast<cellify::Tile>(r.tile),
+      utils::Point2i(r.x, r.y),
+      brain,
+      std::vector<char>(r.data, r.data + r.dataSize),
+      (brain != nullptr ? brain->uuid() : utils::Uuid())
+    );
+
+    if (r.pathSize == 0u) {
+      e->restore(r.last, r.elapsed);
+    }
+    else {
+      cellify::Path path;
+      for (unsigned p = 0u ; p < r.pathSize ; ++p) {
+        path.add(utils::Point2i(points[p].x, points[p].y), true);
+      }
+
+      e->restore(path, r.last, r.elapsed);
+    }
+
+    return e;
+  }
+
+  std::uint64_t
+  align(std::uint64_t offset) noexcept {
+    return (offset + SECTION_ALIGNMENT - 1u) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+  }
+
+  Section
+  layout(std::uint64_t& offset, std::uint64_t count, std::uint64_t size) noexcept {
+    Section s{align(offset), count};
+    offset = s.offset + s.count * size;
+
+    return s;
+  }
+
+  /// @brief - Writes a section of a file through a fixed
+  /// staging buffer with raw system calls only. The sections
+  /// of a file are written at their offset so that they can
+  /// all be produced at once.
+  struct Stream {
+    // The file descriptor to write to.
+    int fd;
+
+    // The staging buffer and its capacity.
+    char* buffer;
+    std::uint64_t capacity;
+
+    // The number of bytes pending in the buffer.
+    std::uint64_t pending;
+
+    // The offset in the file of the first pending byte.
+    std::uint64_t offset;
+
+    // Whether all the writes succeeded so far.
+    bool ok;
+  };
+
+  void
+  flush(Stream& s) noexcept {
+    std::uint64_t done = 0u;
+
+    while (s.ok && done < s.pending) {
+      ssize_t w = ::pwrite(s.fd, s.buffer + done, s.pending - done, s.offset + done);
+      if (w < 0 && errno == EINTR) {
+        continue;
+      }
+
+      s.ok = (w > 0);
+      done += (w > 0 ? static_cast<std::uint64_t>(w) : 0u);
+    }
+
+    s.offset += s.pending;
+    s.pending = 0u;
+  }
+
+  void
+  put(Stream& s, const void* data, std::uint64_t size) noexcept {
+    const char* src = reinterpret_cast<const char*>(data);
+
+    while (size > 0u && s.ok) {
+      std::uint64_t chunk = std::min(size, s.capacity - s.pending);
+      std::memcpy(s.buffer + s.pending, src, chunk);
+
+      s.pending += chunk;
+      src += chunk;
+      size -= chunk;
+
+      if (s.pending == s.capacity) {
+        flush(s);
+      }
+    }
+  }
+
+  template <typename Record>
+  bool
+  valid(const Section& s, std::uint64_t size) noexcept {
+    return s.offset % SECTION_ALIGNMENT == 0u &&
+           s.offset <= size &&
+           s.count <= (size - s.offset) / sizeof(Record);
+  }
+
+}
+
+namespace cellify {
+
+  Snapshot::Snapshot(const std::string& file):
+    utils::CoreObject("snapshot"),
+
+    m_file(file),
+    m_data(nullptr),
+    m_size(0u)
+  {
+    setService("persistence");
+  }
+
+  Snapshot::~Snapshot() {
+    unmap();
+  }
+
+  void
+  Snapshot::load() {
+    unmap();
+
+    int fd = ::open(m_file.c_str(), O_RDONLY);
+    if (fd < 0) {
+      error(
+        "Failed to load snapshot \"" + m_file + "\"",
+        std::string("Failed to open file: ") + std::strerror(errno)
+      );
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+      ::close(fd);
+      error(
+        "Failed to load snapshot \"" + m_file + "\"",
+        "File is too small to be a snapshot"
+      );
+    }
+
+    m_size = static_cast<std::uint64_t>(st.st_size);
+    m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (m_data == MAP_FAILED) {
+      m_data = nullptr;
+      error(
+        "Failed to load snapshot \"" + m_file + "\"",
+        std::string("Failed to map file: ") + std::strerror(errno)
+      );
+    }
+
+    // The records are read once, in order.
+    ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+
+    // Check the consistency of the header: the records
+    // themselves are checked when building elements.
+    const Header& h = *reinterpret_cast<const Header*>(at(0u));
+
+    std::string reason;
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) {
+      reason = "Invalid magic bytes";
+    }
+    else if (h.version != SNAPSHOT_VERSION) {
+      reason = "Unsupported version " + std::to_string(h.version) + " (expected " + std::to_string(SNAPSHOT_VERSION) + ")";
+    }
+    else if (h.size != sizeof(Header)) {
+      reason = "Invalid header size " + std::to_string(h.size);
+    }
+    else if (!valid<ElementRecord>(h.elements, m_size) ||
+             !valid<PointRecord>(h.points, m_size) ||
+             !valid<AntState>(h.ants, m_size) ||
+             !valid<ColonyState>(h.colonies, m_size) ||
+             !valid<FoodRecord>(h.foods, m_size) ||
+             !valid<PheromonRecord>(h.pheromons, m_size))
+    {
+      reason = "Sections don't fit in the file";
+    }
+
+    if (!reason.empty()) {
+      unmap();
+      error("Failed to load snapshot \"" + m_file + "\"", reason);
+    }
+  }
+
+  SnapshotDesc
+  Snapshot::desc() const {
+    const Header& h = *reinterpret_cast<const Header*>(header());
+    return SnapshotDesc{h.moment, h.seed};
+  }
+
+  unsigned
+  Snapshot::size() const {
+    const Header& h = *reinterpret_cast<const Header*>(header());
+    return h.elements.count;
+  }
+
+  Elements
+  Snapshot::elements() const {
+    const Header& h = *reinterpret_cast<const Header*>(header());
+
+    const ElementRecord* records = reinterpret_cast<const ElementRecord*>(at(h.elements.offset));
+    const PointRecord* points = reinterpret_cast<const PointRecord*>(at(h.points.offset));
+    const AntState* ants = reinterpret_cast<const AntState*>(at(h.ants.offset));
+    const ColonyState* colonies = reinterpret_cast<const ColonyState*>(at(h.colonies.offset));
+    const FoodRecord* foods = reinterpret_cast<const FoodRecord*>(at(h.foods.offset));
+    const PheromonRecord* pheromons = reinterpret_cast<const PheromonRecord*>(at(h.pheromons.offset));
+
+    Elements out;
+    out.reserve(h.elements.count);
+
+    for (std::uint64_t id = 0u ; id < h.elements.count ; ++id) {
+      const ElementRecord& r = records[id];
+
+      if (r.tile > static_cast<std::uint8_t>(Tile::Obstacle) || r.dataSize > ELEMENT_DATA_SIZE) {
+        error(
+          "Failed to load element " + std::to_string(id) + " from \"" + m_file + "\"",
+          "Invalid tile or data size"
+        );
+      }
+
+      std::uint64_t count = 0u;
+      switch (r.brain) {
+        case Brain::None:
+          break;
+        case Brain::Ant:
+          count = h.ants.count;
+          break;
+        case Brain::Colony:
+          count = h.colonies.count;
+          break;
+        case Brain::Food:
+          count = h.foods.count;
+          break;
+        case Brain::Pheromon:
+          count = h.pheromons.count;
+          break;
+        default:
+          break;
+      }
+
+      bool invalidBrain = (r.brain != Brain::None && r.brainIndex >= count);
+      bool invalidPath = (static_cast<std::uint64_t>(r.pathStart) + r.pathSize > h.points.count);
+      if (invalidBrain || invalidPath) {
+        error(
+          "Failed to load element " + std::to_string(id) + " from \"" + m_file + "\"",
+          "Invalid brain or path reference"
+        );
+      }
+
+      const char* payload = nullptr;
+      switch (r.brain) {
+        case Brain::Ant:
+          payload = reinterpret_cast<const char*>(&ants[r.brainIndex]);
+          break;
+        case Brain::Colony:
+          payload = reinterpret_cast<const char*>(&colonies[r.brainIndex]);
+          break;
+        case Brain::Food:
+          payload = reinterpret_cast<const char*>(&foods[r.brainIndex]);
+          break;
+        case Brain::Pheromon:
+          payload = reinterpret_cast<const char*>(&pheromons[r.brainIndex]);
+          break;
+        case Brain::None:
+        default:
+          break;
+      }
+
+      AIShPtr brain = brainOf(r.brain, payload);
+      ElementShPtr e = elementOf(r, brain, points + r.pathStart);
+
+      out.push_back(e);
+    }
+
+    return out;
+  }
+
+  void
+  Snapshot::save(const SnapshotDesc& desc,
+                 const Elements& elements)
+  {
+    int fd = ::open(m_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      error(
+        "Failed to save snapshot to \"" + m_file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    std::unique_ptr<char[]> buffer(new char[SNAPSHOT_STAGING_SIZE]);
+    bool ok = writeSnapshot(fd, desc, elements, buffer.get(), SNAPSHOT_STAGING_SIZE);
+
+    if (::close(fd) != 0 || !ok) {
+      error(
+        "Failed to save snapshot to \"" + m_file + "\"",
+        "Failed to write file"
+      );
+    }
+
+    debug("Saved " + std::to_string(elements.size()) + " element(s) to \"" + m_file + "\"");
+  }
+
+  bool
+  writeSnapshot(int fd,
+                const SnapshotDesc& desc,
+                const Elements& elements,
+                char* buffer,
+                unsigned capacity) noexcept
+  {
+    // A first pass counts the records of each array so that
+    // the layout of the file is known: all the arrays are then
+    // produced by a single pass over the elements.
+    std::uint64_t points = 0u;
+    std::uint64_t brains[5] = {0u, 0u, 0u, 0u, 0u};
+
+    for (unsigned id = 0u ; id < elements.size() ; ++id) {
+      const Element& e = *elements[id];
+
+      Payload p;
+      ++brains[static_cast<unsigned>(describe(e.brain(), p))];
+      points += e.path().size();
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(Header));
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.size = sizeof(Header);
+    h.moment = desc.moment;
+    h.seed = desc.seed;
+
+    std::uint64_t offset = sizeof(Header);
+    h.elements = layout(offset, elements.size(), sizeof(ElementRecord));
+    h.points = layout(offset, points, sizeof(PointRecord));
+    h.ants = layout(offset, brains[static_cast<unsigned>(Brain::Ant)], sizeof(AntState));
+    h.colonies = layout(offset, brains[static_cast<unsigned>(Brain::Colony)], sizeof(ColonyState));
+    h.foods = layout(offset, brains[static_cast<unsigned>(Brain::Food)], sizeof(FoodRecord));
+    h.pheromons = layout(offset, brains[static_cast<unsigned>(Brain::Pheromon)], sizeof(PheromonRecord));
+
+    // Each array gets a slice of the staging buffer. The gaps
+    // between the arrays are left as holes, which read as the
+    // zeros used for padding. The records of the brains are
+    // indexed by their kind.
+    std::uint64_t slice = capacity / 6u;
+    if (slice == 0u) {
+      return false;
+    }
+
+    Stream elementsStream{fd, buffer, slice, 0u, h.elements.offset, true};
+    Stream pointsStream{fd, buffer + slice, slice, 0u, h.points.offset, true};
+    Stream brainsStreams[5] = {
+      Stream{fd, nullptr, 0u, 0u, 0u, true},
+      Stream{fd, buffer + 2u * slice, slice, 0u, h.ants.offset, true},
+      Stream{fd, buffer + 3u * slice, slice, 0u, h.colonies.offset, true},
+      Stream{fd, buffer + 4u * slice, slice, 0u, h.foods.offset, true},
+      Stream{fd, buffer + 5u * slice, slice, 0u, h.pheromons.offset, true}
+    };
+
+    // The elements reference their brain and path by index
+    // in the respective arrays.
+    std::uint64_t indices[5] = {0u, 0u, 0u, 0u, 0u};
+    std::uint64_t pathStart = 0u;
+
+    for (unsigned id = 0u ; id < elements.size() ; ++id) {
+      const Element& e = *elements[id];
+
+      ElementRecord r;
+      if (!describe(e, e.elapsedSinceLast(), r)) {
+        return false;
+      }
+
+      Payload p;
+      r.brain = describe(e.brain(), p);
+      if (r.brain != Brain::None) {
+        r.brainIndex = indices[static_cast<unsigned>(r.brain)]++;
+        put(brainsStreams[static_cast<unsigned>(r.brain)], &p, payloadSize(r.brain));
+      }
+
+      const Path& path = e.path();
+      r.pathStart = pathStart;
+      r.pathSize = path.size();
+      pathStart += r.pathSize;
+
+      for (unsigned pt = 0u ; pt < path.size() ; ++pt) {
+        PointRecord pr{path[pt].x(), path[pt].y()};
+        put(pointsStream, &pr, sizeof(PointRecord));
+      }
+
+      put(elementsStream, &r, sizeof(ElementRecord));
+    }
+
+    Stream header{fd, reinterpret_cast<char*>(&h), sizeof(Header), sizeof(Header), 0u, true};
+    flush(header);
+    flush(elementsStream);
+    flush(pointsStream);
+
+    bool ok = header.ok && elementsStream.ok && pointsStream.ok;
+    for (unsigned id = 1u ; id < 5u ; ++id) {
+      flush(brainsStreams[id]);
+      ok = ok && brainsStreams[id].ok;
+    }
+
+    // The file always extends up to the end of the last array
+    // even if it is empty.
+    return ok && ::ftruncate(fd, offset) == 0;
+  }
+
+  bool
+  encode(const Element& e,
+         const Duration& elapsed,
+         std::vector<char>& out)
+  {
+    ElementRecord r;
+    if (!describe(e, elapsed, r)) {
+      return false;
+    }
+
+    Payload p;
+    r.brain = describe(e.brain(), p);
+    r.pathSize = e.path().size();
+
+    unsigned size = payloadSize(r.brain);
+    unsigned offset = out.size();
+    out.resize(offset + sizeof(ElementRecord) + size + r.pathSize * sizeof(PointRecord));
+
+    char* dst = out.data() + offset;
+    std::memcpy(dst, &r, sizeof(ElementRecord));
+    std::memcpy(dst + sizeof(ElementRecord), &p, size);
+
+    PointRecord* points = reinterpret_cast<PointRecord*>(dst + sizeof(ElementRecord) + size);
+    for (unsigned id = 0u ; id < r.pathSize ; ++id) {
+      points[id] = PointRecord{e.path()[id].x(), e.path()[id].y()};
+    }
+
+    return true;
+  }
+
+  ElementShPtr
+  decode(const char* data, unsigned& size) {
+    ElementRecord r;
+    std::memcpy(&r, data, sizeof(ElementRecord));
+
+    unsigned payload = payloadSize(r.brain);
+    const char* brain = data + sizeof(ElementRecord);
+
+    // The points are copied as the buffer might not be
+    // aligned.
+    std::vector<PointRecord> points(r.pathSize);
+    std::memcpy(points.data(), brain + payload, r.pathSize * sizeof(PointRecord));
+
+    size = sizeof(ElementRecord) + payload + r.pathSize * sizeof(PointRecord);
+
+    return elementOf(r, brainOf(r.brain, brain), points.data());
+  }
+
+  const char*
+  Snapshot::at(std::uint64_t offset) const noexcept {
+    return reinterpret_cast<const char*>(m_data) + offset;
+  }
+
+  const void*
+  Snapshot::header() const {
+    if (m_data == nullptr) {
+      error(
+        "Failed to access snapshot \"" + m_file + "\"",
+        "Snapshot is not loaded"
+      );
+    }
+
+    return m_data;
+  }
+
+  void
+  Snapshot::unmap() noexcept {
+    if (m_data != nullptr) {
+      ::munmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0u;
+  }
+
+}
@@ -0,0 +1,205 @@
+#ifndef    SNAPSHOT_HH
+# define   SNAPSHOT_HH
+
+# include <string>
+# include <cstdint>
+# include <core_utils/CoreObject.hh>
+# include "Element.hh"
+# include "Time.hh"
+
+namespace cellify {
+
+  /// @brief - The version of the snapshot format: it should
+  /// be incremented whenever the layout of the file changes.
+  constexpr std::uint32_t SNAPSHOT_VERSION = 1u;
+
+  /// @brief - Convenience structure regrouping the global
+  /// properties of a world saved in a snapshot.
+  struct SnapshotDesc {
+    // The moment of the simulation at which the snapshot
+    // was taken.
+    TimeStamp moment;
+
+    // The seed of the random number generator to use when
+    // resuming the simulation from the snapshot.
+    int seed;
+  };
+
+  /// @brief - A versioned binary snapshot of a world. The file
+  /// is made of a header followed by plain arrays of fixed size
+  /// records (elements, path points and one array per kind of
+  /// brain). Loading a snapshot maps the file in memory and
+  /// builds the elements directly from the records: the arrays
+  /// are never parsed nor copied beforehand.
+  class Snapshot: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a snapshot attached to the input file.
+       *          Nothing is read nor written until `load` or
+       *          `save` is called.
+       * @param file - the path to the snapshot.
+       */
+      Snapshot(const std::string& file);
+
+      /**
+       * @brief - Release the memory mapped file.
+       */
+      ~Snapshot();
+
+      /**
+       * @brief - Deleted copy constructor: the object owns the
+       *          mapping of the file.
+       */
+      Snapshot(const Snapshot&) = delete;
+
+      /**
+       * @brief - Deleted assignment operator.
+       */
+      Snapshot&
+      operator=(const Snapshot&) = delete;
+
+      /**
+       * @brief - Map the snapshot file in memory. An error is
+       *          raised in case the file can't be opened or is
+       *          not a valid snapshot.
+       */
+      void
+      load();
+
+      /**
+       * @brief - Save the input elements and properties to the
+       *          snapshot file. The elements should not be moving
+       *          (i.e. the world should be paused) so that their
+       *          motion can be restored exactly.
+       * @param desc - the global properties of the world.
+       * @param elements - the elements to save.
+       */
+      void
+      save(const SnapshotDesc& desc,
+           const Elements& elements);
+
+      /**
+       * @brief - Returns the global properties of the world. The
+       *          snapshot should be loaded.
+       * @return - the description of the snapshot.
+       */
+      SnapshotDesc
+      desc() const;
+
+      /**
+       * @brief - Returns the number of elements in the snapshot.
+       *          The snapshot should be loaded.
+       * @return - the number of elements.
+       */
+      unsigned
+      size() const;
+
+      /**
+       * @brief - Build the elements stored in the snapshot. This
+       *          is done in a single pass over the records. Each
+       *          element receives a new identifier. The snapshot
+       *          should be loaded.
+       * @return - the elements of the snapshot.
+       */
+      Elements
+      elements() const;
+
+    private:
+
+      /**
+       * @brief - Returns a pointer to the input offset in the
+       *          mapped file.
+       * @param offset - the offset in bytes.
+       * @return - a pointer to the data at this offset.
+       */
+      const char*
+      at(std::uint64_t offset) const noexcept;
+
+      /**
+       * @brief - Returns the header of the mapped file or raise
+       *          an error if the snapshot is not loaded.
+       * @return - the header of the snapshot.
+       */
+      const void*
+      header() const;
+
+      /**
+       * @brief - Release the mapping of the file if any.
+       */
+      void
+      unmap() noexcept;
+
+    private:
+
+      /**
+       * @brief - The path to the snapshot file.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The memory mapping of the file.
+       */
+      void* m_data;
+
+      /**
+       * @brief - The size of the file in bytes.
+       */
+      std::uint64_t m_size;
+  };
+
+  /**
+   * @brief - Write a snapshot of the input elements to the file
+   *          descriptor. The records are staged in the provided
+   *          buffer and written with raw system calls: nothing is
+   *          allocated nor logged, so that it is safe to call in
+   *          a process forked from a multi-threaded one.
+   * @param fd - the file descriptor to write to.
+   * @param desc - the global properties of the world.
+   * @param elements - the elements to save, which should not be
+   *                   moving.
+   * @param buffer - the buffer staging the records.
+   * @param capacity - the size of the buffer in bytes.
+   * @return - `false` if an element can't be described or if the
+   *           file could not be written.
+   */
+  bool
+  writeSnapshot(int fd,
+                const SnapshotDesc& desc,
+                const Elements& elements,
+                char* buffer,
+                unsigned capacity) noexcept;
+
+  /**
+   * @brief - Append a compact binary representation of the
+   *          element to the buffer. It uses the same records
+   *          as the snapshot files but keeps the state of the
+   *          brain and the path next to the element, so that
+   *          a single element can be decoded on its own.
+   * @param e - the element to encode.
+   * @param elapsed - the time elapsed since the last move of
+   *                  the element.
+   * @param out - the buffer to append the element to.
+   * @return - `false` if the element can't be encoded because
+   *           its specific data is too large.
+   */
+  bool
+  encode(const Element& e,
+         const Duration& elapsed,
+         std::vector<char>& out);
+
+  /**
+   * @brief - Create an element from its binary representation
+   *          as produced by `encode`. The element is paused and
+   *          receives a new identifier.
+   * @param data - the binary representation of the element.
+   * @param size - output value holding the number of bytes
+   *               read.
+   * @return - the decoded element.
+   */
+  ElementShPtr
+  decode(const char* data, unsigned& size);
+
+}
+
+#endif    /* SNAPSHOT_HH */
@@ -0,0 +1,200 @@
+
+# include "TickProfiler.hh"
+# include <algorithm>
+# include <sstream>
+# include <iomanip>
+
+namespace {
+
+  /// @brief - The profiler active on the current thread.
+  thread_local cellify::TickProfiler* g_active = nullptr;
+
+}
+
+namespace cellify {
+
+  const char*
+  phaseName(const Phase& p) noexcept {
+    switch (p) {
+      case Phase::Tick:
+        return "tick";
+      case Phase::Step:
+        return "step";
+      case Phase::Spawn:
+        return "spawn";
+      case Phase::Influence:
+        return "influence";
+      case Phase::Update:
+        return "update";
+      case Phase::Checkpoint:
+        return "checkpoint";
+      case Phase::History:
+        return "history";
+      case Phase::Export:
+        return "export";
+      default:
+        return "unknown";
+    }
+  }
+
+  std::string
+  phaseToString(const Phase& p) noexcept {
+    return phaseName(p);
+  }
+
+  std::string
+  counterToString(const Counter& c) noexcept {
+    switch (c) {
+      case Counter::ElementsStepped:
+        return "elements";
+      case Counter::Spawns:
+        return "spawns";
+      case Counter::Influences:
+        return "influences";
+      case Counter::AStarCalls:
+        return "a* calls";
+      case Counter::NodesExpanded:
+        return "a* nodes";
+      default:
+        return "unknown";
+    }
+  }
+
+  std::string
+  percentilesToString(const Percentiles& p, int precision) noexcept {
+    std::stringstream out;
+    out << std::fixed << std::setprecision(precision);
+
+    out << "p50: " << p.p50
+        << ", p90: " << p.p90
+        << ", p99: " << p.p99
+        << ", max: " << p.max;
+
+    return out.str();
+  }
+
+  TickProfiler::TickProfiler(unsigned window):
+    utils::CoreObject("profiler"),
+
+    m_window(std::max(window, 1u)),
+    m_ticks(0u),
+
+    m_phases(),
+    m_counters(),
+
+    m_phaseSamples(),
+    m_counterSamples(),
+
+    m_sorted()
+  {
+    setService("cellify");
+
+    m_phases.fill(0.0f);
+    m_counters.fill(0u);
+
+    for (unsigned id = 0u ; id < PHASES_COUNT ; ++id) {
+      m_phaseSamples[id].resize(m_window, 0.0f);
+    }
+    for (unsigned id = 0u ; id < COUNTERS_COUNT ; ++id) {
+      m_counterSamples[id].resize(m_window, 0.0f);
+    }
+
+    m_sorted.reserve(m_window);
+  }
+
+  TickProfiler*
+  TickProfiler::active() noexcept {
+    return g_active;
+  }
+
+  unsigned
+  TickProfiler::ticks() const noexcept {
+    return m_ticks;
+  }
+
+  void
+  TickProfiler::beginTick() noexcept {
+    m_phases.fill(0.0f);
+    m_counters.fill(0u);
+
+    g_active = this;
+  }
+
+  void
+  TickProfiler::endTick() noexcept {
+    // Register the values of this tick in the rolling
+    // window, overriding the oldest ones.
+    unsigned slot = m_ticks % m_window;
+
+    for (unsigned id = 0u ; id < PHASES_COUNT ; ++id) {
+      m_phaseSamples[id][slot] = m_phases[id];
+    }
+    for (unsigned id = 0u ; id < COUNTERS_COUNT ; ++id) {
+      m_counterSamples[id][slot] = m_counters[id];
+    }
+
+    ++m_ticks;
+
+    if (g_active == this) {
+      g_active = nullptr;
+    }
+  }
+
+  float
+  TickProfiler::last(const Phase& phase) const noexcept {
+    if (m_ticks == 0u) {
+      return 0.0f;
+    }
+
+    unsigned slot = (m_ticks - 1u) % m_window;
+    return m_phaseSamples[static_cast<unsigned>(phase)][slot];
+  }
+
+  unsigned
+  TickProfiler::last(const Counter& counter) const noexcept {
+    if (m_ticks == 0u) {
+      return 0u;
+    }
+
+    unsigned slot = (m_ticks - 1u) % m_window;
+    return static_cast<unsigned>(m_counterSamples[static_cast<unsigned>(counter)][slot]);
+  }
+
+  Percentiles
+  TickProfiler::percentiles(const Phase& phase) const noexcept {
+    return compute(m_phaseSamples[static_cast<unsigned>(phase)]);
+  }
+
+  Percentiles
+  TickProfiler::percentiles(const Counter& counter) const noexcept {
+    return compute(m_counterSamples[static_cast<unsigned>(counter)]);
+  }
+
+  Percentiles
+  TickProfiler::compute(const Samples& samples) const noexcept {
+    Percentiles out{0.0f, 0.0f, 0.0f, 0.0f};
+
+    // Only consider the part of the window which was
+    // already filled.
+    unsigned count = std::min(m_ticks, m_window);
+    if (count == 0u) {
+      return out;
+    }
+
+    m_sorted.assign(samples.begin(), samples.begin() + count);
+    std::sort(m_sorted.begin(), m_sorted.end());
+
+    auto at = [this, count](float perc) {
+      unsigned id = static_cast<unsigned>(perc * (count - 1u));
+      return m_sorted[id];
+    };
+
+    out.p50 = at(0.5f);
+    out.p90 = at(0.9f);
+    out.p99 = at(0.99f);
+    out.max = m_sorted.back();
+
+    return out;
+  }
+
+}
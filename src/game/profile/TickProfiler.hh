@@ -0,0 +1,294 @@
+#ifndef    TICK_PROFILER_HH
+# define   TICK_PROFILER_HH
+
+# include <array>
+# include <vector>
+# include <string>
+# include <chrono>
+# include <core_utils/CoreObject.hh>
+# include "Tracer.hh"
+
+namespace cellify {
+
+  /// @brief - The phases of a tick of the world that are
+  /// measured by the profiler.
+  enum class Phase {
+    Tick,
+    Step,
+    Spawn,
+    Influence,
+    Update,
+    Checkpoint,
+    History,
+    Export,
+    Count
+  };
+
+  /// @brief - The counters tracked by the profiler for each
+  /// tick of the world.
+  enum class Counter {
+    ElementsStepped,
+    Spawns,
+    Influences,
+    AStarCalls,
+    NodesExpanded,
+    Count
+  };
+
+  /**
+   * @brief - Returns the static name of a phase, suitable for
+   *          the trace events.
+   * @param p - the phase.
+   * @return - the name of the phase.
+   */
+  const char*
+  phaseName(const Phase& p) noexcept;
+
+  /**
+   * @brief - Convert a phase to a human readable string.
+   * @param p - the phase to convert.
+   * @return - the string representing the phase.
+   */
+  std::string
+  phaseToString(const Phase& p) noexcept;
+
+  /**
+   * @brief - Convert a counter to a human readable string.
+   * @param c - the counter to convert.
+   * @return - the string representing the counter.
+   */
+  std::string
+  counterToString(const Counter& c) noexcept;
+
+  /// @brief - Rolling statistics computed over the window of
+  /// ticks kept by the profiler.
+  struct Percentiles {
+    float p50;
+    float p90;
+    float p99;
+    float max;
+  };
+
+  /**
+   * @brief - Convert the percentiles to a human readable string.
+   * @param p - the percentiles to convert.
+   * @param precision - the number of decimals to display.
+   * @return - the string representing the percentiles.
+   */
+  std::string
+  percentilesToString(const Percentiles& p, int precision = 2) noexcept;
+
+  class TickProfiler: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new profiler keeping the measures of
+       *          the last ticks.
+       * @param window - the number of ticks to keep in memory
+       *                 to compute the statistics.
+       */
+      TickProfiler(unsigned window = 256u);
+
+      /**
+       * @brief - Returns the profiler currently active on the
+       *          calling thread. This allows code which has no
+       *          access to the world (such as the A*) to report
+       *          its counters.
+       * @return - the active profiler or `null` if none is set.
+       */
+      static TickProfiler*
+      active() noexcept;
+
+      /**
+       * @brief - Returns the number of ticks measured so far.
+       * @return - the number of ticks measured.
+       */
+      unsigned
+      ticks() const noexcept;
+
+      /**
+       * @brief - Starts the measure of a new tick: all phases
+       *          and counters are reset and this profiler is
+       *          made active on the calling thread.
+       */
+      void
+      beginTick() noexcept;
+
+      /**
+       * @brief - Ends the measure of the current tick and adds
+       *          it to the rolling window.
+       */
+      void
+      endTick() noexcept;
+
+      /**
+       * @brief - Register the duration of a phase for the tick.
+       * @param phase - the phase to update.
+       * @param ms - the duration of the phase in milliseconds.
+       */
+      void
+      record(const Phase& phase, float ms) noexcept;
+
+      /**
+       * @brief - Increment the counter for the current tick.
+       * @param counter - the counter to increment.
+       * @param amount - the amount to add to the counter.
+       */
+      void
+      count(const Counter& counter, unsigned amount = 1u) noexcept;
+
+      /**
+       * @brief - Returns the duration of the phase for the last
+       *          completed tick.
+       * @param phase - the phase to query.
+       * @return - the duration in milliseconds.
+       */
+      float
+      last(const Phase& phase) const noexcept;
+
+      /**
+       * @brief - Returns the value of the counter for the last
+       *          completed tick.
+       * @param counter - the counter to query.
+       * @return - the value of the counter.
+       */
+      unsigned
+      last(const Counter& counter) const noexcept;
+
+      /**
+       * @brief - Compute the percentiles of the duration of the
+       *          input phase over the window of ticks.
+       * @param phase - the phase to query.
+       * @return - the percentiles in milliseconds.
+       */
+      Percentiles
+      percentiles(const Phase& phase) const noexcept;
+
+      /**
+       * @brief - Compute the percentiles of the input counter
+       *          over the window of ticks.
+       * @param counter - the counter to query.
+       * @return - the percentiles of the counter.
+       */
+      Percentiles
+      percentiles(const Counter& counter) const noexcept;
+
+    private:
+
+      /// @brief - The number of phases measured.
+      static constexpr unsigned PHASES_COUNT = static_cast<unsigned>(Phase::Count);
+
+      /// @brief - The number of counters tracked.
+      static constexpr unsigned COUNTERS_COUNT = static_cast<unsigned>(Counter::Count);
+
+      /// @brief - The samples of a single metric over the
+      /// window of ticks.
+      using Samples = std::vector<float>;
+
+      /**
+       * @brief - Compute the percentiles for the input samples.
+       * @param samples - the samples to analyze.
+       * @return - the computed percentiles.
+       */
+      Percentiles
+      compute(const Samples& samples) const noexcept;
+
+    private:
+
+      /**
+       * @brief - The size of the window of ticks kept.
+       */
+      unsigned m_window;
+
+      /**
+       * @brief - The number of ticks completed so far.
+       */
+      unsigned m_ticks;
+
+      /**
+       * @brief - The phases for the tick being measured.
+       */
+      std::array<float, PHASES_COUNT> m_phases;
+
+      /**
+       * @brief - The counters for the tick being measured.
+       */
+      std::array<unsigned, COUNTERS_COUNT> m_counters;
+
+      /**
+       * @brief - The samples for each phase over the window.
+       */
+      std::array<Samples, PHASES_COUNT> m_phaseSamples;
+
+      /**
+       * @brief - The samples for each counter over the window.
+       */
+      std::array<Samples, COUNTERS_COUNT> m_counterSamples;
+
+      /**
+       * @brief - A scratch buffer used to sort the samples when
+       *          computing percentiles. Avoids reallocating it
+       *          for each query.
+       */
+      mutable Samples m_sorted;
+  };
+
+  /// @brief - Measures the time spent in a scope and reports it
+  /// as the duration of a phase to the profiler. The phase is
+  /// also emitted as a trace event when tracing is active.
+  class ScopedPhase {
+    public:
+
+      /**
+       * @brief - Starts measuring the input phase.
+       * @param profiler - the profiler to report to.
+       * @param phase - the phase to measure.
+       */
+      ScopedPhase(TickProfiler& profiler, const Phase& phase) noexcept;
+
+      /**
+       * @brief - Stops the measure and report it.
+       */
+      ~ScopedPhase();
+
+    private:
+
+      /// @brief - Convenience define for the clock used to
+      /// measure the phases.
+      using Clock = std::chrono::steady_clock;
+
+      /**
+       * @brief - The profiler to which the duration is reported.
+       */
+      TickProfiler& m_profiler;
+
+      /**
+       * @brief - The phase being measured.
+       */
+      Phase m_phase;
+
+      /**
+       * @brief - The moment at which the measure started.
+       */
+      Clock::time_point m_start;
+
+      /**
+       * @brief - The trace event covering the phase.
+       */
+      pge::trace::Scope m_trace;
+  };
+
+  /**
+   * @brief - Increment the counter of the profiler active on
+   *          the calling thread, if any.
+   * @param counter - the counter to increment.
+   * @param amount - the amount to add to the counter.
+   */
+  void
+  profileCount(const Counter& counter, unsigned amount = 1u) noexcept;
+
+}
+
+# include "TickProfiler.hxx"
+
+#endif    /* TICK_PROFILER_HH */
@@ -0,0 +1,46 @@
+#ifndef    TICK_PROFILER_HXX
+# define   TICK_PROFILER_HXX
+
+# include "TickProfiler.hh"
+
+namespace cellify {
+
+  inline
+  void
+  TickProfiler::record(const Phase& phase, float ms) noexcept {
+    m_phases[static_cast<unsigned>(phase)] += ms;
+  }
+
+  inline
+  void
+  TickProfiler::count(const Counter& counter, unsigned amount) noexcept {
+    m_counters[static_cast<unsigned>(counter)] += amount;
+  }
+
+  inline
+  ScopedPhase::ScopedPhase(TickProfiler& profiler, const Phase& phase) noexcept:
+    m_profiler(profiler),
+    m_phase(phase),
+    m_start(Clock::now()),
+
+    m_trace(phaseName(phase), "world")
+  {}
+
+  inline
+  ScopedPhase::~ScopedPhase() {
+    std::chrono::duration<float, std::milli> d = Clock::now() - m_start;
+    m_profiler.record(m_phase, d.count());
+  }
+
+  inline
+  void
+  profileCount(const Counter& counter, unsigned amount) noexcept {
+    TickProfiler* p = TickProfiler::active();
+    if (p != nullptr) {
+      p->count(counter, amount);
+    }
+  }
+
+}
+
+#endif    /* TICK_PROFILER_HXX */
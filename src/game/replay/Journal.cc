@@ -0,0 +1,151 @@
+
+# include "Journal.hh"
+# include <sstream>
+# include <iomanip>
+# include <cstdlib>
+
+/// @brief - The first word of a journal file.
+# define JOURNAL_MAGIC "cellify-journal"
+
+/// @brief - The suffix of the snapshot attached to a journal.
+# define JOURNAL_SNAPSHOT_SUFFIX ".snap"
+
+namespace cellify {
+
+  Journal::Journal(const std::string& file):
+    utils::CoreObject("journal"),
+
+    m_file(file),
+    m_out()
+  {
+    setService("replay");
+  }
+
+  std::string
+  Journal::snapshot() const noexcept {
+    return m_file + JOURNAL_SNAPSHOT_SUFFIX;
+  }
+
+  void
+  Journal::open() {
+    m_out.open(m_file, std::ios::trunc);
+    if (!m_out.good()) {
+      error(
+        "Failed to open journal \"" + m_file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    m_out << JOURNAL_MAGIC << " " << JOURNAL_VERSION << "\n";
+  }
+
+  void
+  Journal::step(unsigned tick, float tDelta, std::uint64_t hash) noexcept {
+    // Durations are written in hexadecimal so that they
+    // are restored exactly.
+    m_out << tick << " step " << std::hexfloat << tDelta << std::defaultfloat
+          << " " << std::hex << hash << std::dec << "\n";
+  }
+
+  void
+  Journal::spawn(unsigned tick, const utils::Point2i& p, const Tile& tile) noexcept {
+    m_out << tick << " spawn " << static_cast<int>(tile) << " " << p.x() << " " << p.y() << "\n";
+  }
+
+  void
+  Journal::pause(unsigned tick) noexcept {
+    m_out << tick << " pause\n";
+  }
+
+  void
+  Journal::resume(unsigned tick) noexcept {
+    m_out << tick << " resume\n";
+  }
+
+  void
+  Journal::reseed(unsigned tick) noexcept {
+    m_out << tick << " reseed\n";
+  }
+
+  std::vector<Entry>
+  Journal::read() const {
+    std::ifstream in(m_file);
+    if (!in.good()) {
+      error(
+        "Failed to read journal \"" + m_file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    std::string magic;
+    unsigned version = 0u;
+    in >> magic >> version;
+
+    std::string line;
+    std::getline(in, line);
+
+    if (magic != JOURNAL_MAGIC || version != JOURNAL_VERSION) {
+      error(
+        "Failed to read journal \"" + m_file + "\"",
+        "Invalid header \"" + magic + " " + std::to_string(version) + "\""
+      );
+    }
+
+    std::vector<Entry> out;
+    unsigned number = 1u;
+
+    while (std::getline(in, line)) {
+      ++number;
+      if (line.empty()) {
+        continue;
+      }
+
+      std::istringstream ls(line);
+      Entry e{0u, Input::Step, 0.0f, 0u, Tile::Obstacle, utils::Point2i()};
+      std::string kind;
+
+      ls >> e.tick >> kind;
+
+      bool valid = !ls.fail();
+      if (valid && kind == "step") {
+        std::string tDelta;
+        ls >> tDelta >> std::hex >> e.hash;
+
+        e.input = Input::Step;
+        e.tDelta = std::strtof(tDelta.c_str(), nullptr);
+      }
+      else if (valid && kind == "spawn") {
+        int tile = 0;
+        ls >> tile >> e.pos.x() >> e.pos.y();
+
+        e.input = Input::Spawn;
+        e.tile = static_cast<Tile>(tile);
+        valid = (tile >= 0 && tile <= static_cast<int>(Tile::Obstacle));
+      }
+      else if (valid && kind == "pause") {
+        e.input = Input::Pause;
+      }
+      else if (valid && kind == "resume") {
+        e.input = Input::Resume;
+      }
+      else if (valid && kind == "reseed") {
+        e.input = Input::Reseed;
+      }
+      else {
+        valid = false;
+      }
+
+      if (!valid || ls.fail()) {
+        error(
+          "Failed to read journal \"" + m_file + "\"",
+          "Invalid input at line " + std::to_string(number) + ": \"" + line + "\""
+        );
+      }
+
+      out.push_back(e);
+    }
+
+    return out;
+  }
+
+}
@@ -0,0 +1,147 @@
+#ifndef    JOURNAL_HH
+# define   JOURNAL_HH
+
+# include <string>
+# include <vector>
+# include <memory>
+# include <cstdint>
+# include <fstream>
+# include <core_utils/CoreObject.hh>
+# include <maths_utils/Point2.hh>
+# include "Tiles.hh"
+
+namespace cellify {
+
+  /// @brief - The version of the journal format: it should
+  /// be incremented whenever the syntax of the file changes.
+  constexpr unsigned JOURNAL_VERSION = 1u;
+
+  /// @brief - The inputs of a world recorded in a journal.
+  enum class Input {
+    Step,
+    Spawn,
+    Pause,
+    Resume,
+    Reseed
+  };
+
+  /// @brief - An input recorded in a journal.
+  struct Entry {
+    // The number of ticks simulated by the world since
+    // the recording started when the input was received.
+    unsigned tick;
+
+    // The kind of input.
+    Input input;
+
+    // The duration of the step in seconds, for steps.
+    float tDelta;
+
+    // The hash of the world after the step, for steps.
+    std::uint64_t hash;
+
+    // The tile spawned, for spawns.
+    Tile tile;
+
+    // The position of the tile spawned, for spawns.
+    utils::Point2i pos;
+  };
+
+  /// @brief - A journal of the inputs received by a world. It
+  /// is stored as a text file with one input per line, keyed by
+  /// the tick at which it was received. The state of the world
+  /// when the recording started is saved in a snapshot next to
+  /// the journal so that a session can be replayed exactly.
+  class Journal: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a journal attached to the input file.
+       *          Nothing is read nor written until `open` or
+       *          `read` is called.
+       * @param file - the path to the journal.
+       */
+      Journal(const std::string& file);
+
+      /**
+       * @brief - Returns the path to the snapshot holding the
+       *          state of the world when the recording started.
+       * @return - the path to the snapshot.
+       */
+      std::string
+      snapshot() const noexcept;
+
+      /**
+       * @brief - Open the journal for writing, erasing any prior
+       *          content. An error is raised if the file can't
+       *          be opened. Inputs recorded before the journal
+       *          is opened are ignored.
+       */
+      void
+      open();
+
+      /**
+       * @brief - Record a step of the world.
+       * @param tick - the tick before the step.
+       * @param tDelta - the duration of the step in seconds.
+       * @param hash - the hash of the world after the step.
+       */
+      void
+      step(unsigned tick, float tDelta, std::uint64_t hash) noexcept;
+
+      /**
+       * @brief - Record the spawn of a tile.
+       * @param tick - the tick at which the tile was spawned.
+       * @param p - the position of the tile.
+       * @param tile - the tile spawned.
+       */
+      void
+      spawn(unsigned tick, const utils::Point2i& p, const Tile& tile) noexcept;
+
+      /**
+       * @brief - Record a pause of the world.
+       * @param tick - the tick at which the world was paused.
+       */
+      void
+      pause(unsigned tick) noexcept;
+
+      /**
+       * @brief - Record the world resuming its activity.
+       * @param tick - the tick at which the world resumed.
+       */
+      void
+      resume(unsigned tick) noexcept;
+
+      /**
+       * @brief - Record a reseed of the random number generator
+       *          of the world.
+       * @param tick - the tick at which the world was reseeded.
+       */
+      void
+      reseed(unsigned tick) noexcept;
+
+      /**
+       * @brief - Read all the inputs of the journal. An error is
+       *          raised if the file is not a valid journal.
+       * @return - the inputs in the order they were received.
+       */
+      std::vector<Entry>
+      read() const;
+
+    private:
+
+      /**
+       * @brief - The path to the journal.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The stream to write inputs to.
+       */
+      std::ofstream m_out;
+  };
+
+  using JournalShPtr = std::shared_ptr<Journal>;
+}
+
+#endif    /* JOURNAL_HH */
@@ -0,0 +1,269 @@
+
+# include "Scenario.hh"
+# include <algorithm>
+# include "Colony.hh"
+# include "Food.hh"
+# include "Ant.hh"
+# include "Pheromon.hh"
+
+/// @brief - The maximum fraction of the area that can be
+/// covered by walls: walls never touch each other so it
+/// is not possible to go much higher.
+# define MAZE_MAX_DENSITY 0.3f
+
+/// @brief - The range of lengths of a single wall.
+# define WALL_MIN_LENGTH 2
+# define WALL_MAX_LENGTH 8
+
+/// @brief - The number of attempts made to place a wall for
+/// each cell to cover before giving up.
+# define WALL_ATTEMPTS 20
+
+/// @brief - The number of attempts to pick a free cell.
+# define PICK_ATTEMPTS 100
+
+/// @brief - The radius around colonies kept free of walls.
+# define COLONY_CLEARANCE 2
+
+/// @brief - The radius around colonies in which ants are
+/// spawned.
+# define ANT_SPAWN_RADIUS 3
+
+/// @brief - The range of amounts of the generated pheromons.
+# define PHEROMON_MIN_AMOUNT 1.0f
+# define PHEROMON_MAX_AMOUNT 5.0f
+
+namespace cellify {
+
+  ScenarioDesc
+  newScenarioDesc(int seed,
+                  int half) noexcept
+  {
+    return ScenarioDesc{
+      seed,   // seed
+      half,   // half
+
+      1u,     // colonies
+
+      0.05f,  // obstacles
+
+      0u,     // ants
+      0u      // pheromons
+    };
+  }
+
+  Scenario::Scenario(const ScenarioDesc& desc,
+                     const SimulationParams& params):
+    utils::CoreObject("scenario"),
+
+    m_desc(desc),
+    m_params(params)
+  {
+    setService("cellify");
+
+    if (m_desc.half <= 0) {
+      error(
+        "Failed to create scenario",
+        "Invalid area with half size " + std::to_string(m_desc.half)
+      );
+    }
+  }
+
+  const ScenarioDesc&
+  Scenario::desc() const noexcept {
+    return m_desc;
+  }
+
+  Elements
+  Scenario::generate() const {
+    utils::RNG rng(m_desc.seed);
+
+    int side = 2 * m_desc.half + 1;
+    Cells cells(side * side, Cell::Free);
+
+    Elements out;
+    std::vector<utils::Point2i> colonies;
+
+    // Colonies first as they need space around them.
+    for (unsigned id = 0u ; id < m_desc.colonies ; ++id) {
+      utils::Point2i p;
+      if (!pick(rng, cells, p)) {
+        warn("Only generated " + std::to_string(id) + " colony(ies) out of " + std::to_string(m_desc.colonies));
+        break;
+      }
+
+      reserve(cells, p, COLONY_CLEARANCE);
+      cells[index(p.x(), p.y())] = Cell::Occupied;
+      colonies.push_back(p);
+
+      out.push_back(newElement(p, std::make_shared<Colony>(utils::Uuid::create())));
+    }
+
+    for (unsigned id = 0u ; id < m_params.foodDepositsCount ; ++id) {
+      utils::Point2i p;
+      if (!pick(rng, cells, p)) {
+        warn("Only generated " + std::to_string(id) + " deposit(s) out of " + std::to_string(m_params.foodDepositsCount));
+        break;
+      }
+
+      reserve(cells, p, 1);
+      cells[index(p.x(), p.y())] = Cell::Occupied;
+
+      out.push_back(newElement(p, std::make_shared<Food>(m_params.foodStock)));
+    }
+
+    generateMaze(rng, cells, out);
+
+    // Ants are spawned around the colonies: they can share
+    // a cell but not with a solid element.
+    unsigned ants = 0u;
+    for (unsigned id = 0u ; id < m_desc.ants && !colonies.empty() ; ++id) {
+      const utils::Point2i& c = colonies[id % colonies.size()];
+
+      for (unsigned attempt = 0u ; attempt < PICK_ATTEMPTS ; ++attempt) {
+        int x = rng.rndInt(c.x() - ANT_SPAWN_RADIUS, c.x() + ANT_SPAWN_RADIUS);
+        int y = rng.rndInt(c.y() - ANT_SPAWN_RADIUS, c.y() + ANT_SPAWN_RADIUS);
+
+        int i = index(x, y);
+        if (i >= 0 && cells[i] != Cell::Occupied) {
+          out.push_back(newElement(utils::Point2i(x, y), std::make_shared<Ant>(utils::Uuid::create())));
+          ++ants;
+          break;
+        }
+      }
+    }
+
+    unsigned pheromons = 0u;
+    for (unsigned id = 0u ; id < m_desc.pheromons ; ++id) {
+      int x = rng.rndInt(-m_desc.half, m_desc.half);
+      int y = rng.rndInt(-m_desc.half, m_desc.half);
+
+      if (cells[index(x, y)] == Cell::Occupied) {
+        continue;
+      }
+
+      Scent s = (rng.rndInt(0, 1) == 0 ? Scent::Home : Scent::Food);
+      float amount = rng.rndFloat(PHEROMON_MIN_AMOUNT, PHEROMON_MAX_AMOUNT);
+
+      out.push_back(newElement(
+        utils::Point2i(x, y),
+        std::make_shared<Pheromon>(s, zero(), amount, m_params.pheromonEvaporationRate)
+      ));
+      ++pheromons;
+    }
+
+    info(
+      "Generated scenario with seed " + std::to_string(m_desc.seed) + ": " +
+      std::to_string(colonies.size()) + " colony(ies), " +
+      std::to_string(ants) + " ant(s), " +
+      std::to_string(pheromons) + " pheromon(s), " +
+      std::to_string(out.size()) + " element(s) in total"
+    );
+
+    return out;
+  }
+
+  int
+  Scenario::index(int x, int y) const noexcept {
+    if (x < -m_desc.half || x > m_desc.half || y < -m_desc.half || y > m_desc.half) {
+      return -1;
+    }
+
+    return (y + m_desc.half) * (2 * m_desc.half + 1) + x + m_desc.half;
+  }
+
+  bool
+  Scenario::pick(utils::RNG& rng, const Cells& cells, utils::Point2i& p) const noexcept {
+    for (unsigned attempt = 0u ; attempt < PICK_ATTEMPTS ; ++attempt) {
+      int x = rng.rndInt(-m_desc.half, m_desc.half);
+      int y = rng.rndInt(-m_desc.half, m_desc.half);
+
+      if (cells[index(x, y)] == Cell::Free) {
+        p = utils::Point2i(x, y);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void
+  Scenario::reserve(Cells& cells, const utils::Point2i& p, int radius) const noexcept {
+    for (int y = p.y() - radius ; y <= p.y() + radius ; ++y) {
+      for (int x = p.x() - radius ; x <= p.x() + radius ; ++x) {
+        int i = index(x, y);
+        if (i >= 0 && cells[i] == Cell::Free) {
+          cells[i] = Cell::Reserved;
+        }
+      }
+    }
+  }
+
+  void
+  Scenario::generateMaze(utils::RNG& rng, Cells& cells, Elements& out) const {
+    float density = std::clamp(m_desc.obstacles, 0.0f, MAZE_MAX_DENSITY);
+    unsigned target = static_cast<unsigned>(density * cells.size());
+
+    // A wall can only be placed on free cells and can't be
+    // adjacent to any solid element (including other walls):
+    // this guarantees that walls never enclose an area.
+    auto fits = [this, &cells](int x, int y) {
+      int i = index(x, y);
+      if (i < 0 || cells[i] != Cell::Free) {
+        return false;
+      }
+
+      for (int dy = -1 ; dy <= 1 ; ++dy) {
+        for (int dx = -1 ; dx <= 1 ; ++dx) {
+          int n = index(x + dx, y + dy);
+          if (n >= 0 && cells[n] == Cell::Occupied) {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    };
+
+    unsigned placed = 0u;
+    unsigned attempts = WALL_ATTEMPTS * target;
+
+    while (placed < target && attempts > 0u) {
+      --attempts;
+
+      int length = rng.rndInt(WALL_MIN_LENGTH, WALL_MAX_LENGTH);
+      bool horizontal = (rng.rndInt(0, 1) == 0);
+
+      int x = rng.rndInt(-m_desc.half, m_desc.half);
+      int y = rng.rndInt(-m_desc.half, m_desc.half);
+
+      int dx = (horizontal ? 1 : 0);
+      int dy = (horizontal ? 0 : 1);
+
+      bool valid = true;
+      for (int l = 0 ; l < length && valid ; ++l) {
+        valid = fits(x + l * dx, y + l * dy);
+      }
+
+      if (!valid) {
+        continue;
+      }
+
+      for (int l = 0 ; l < length ; ++l) {
+        utils::Point2i p(x + l * dx, y + l * dy);
+
+        cells[index(p.x(), p.y())] = Cell::Occupied;
+        out.push_back(std::make_shared<Element>(Tile::Obstacle, p));
+        ++placed;
+      }
+    }
+
+    if (placed < target) {
+      warn(
+        "Only generated " + std::to_string(placed) + " wall cell(s) out of " +
+        std::to_string(target) + " requested"
+      );
+    }
+  }
+
+}
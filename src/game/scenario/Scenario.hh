@@ -0,0 +1,151 @@
+#ifndef    SCENARIO_HH
+# define   SCENARIO_HH
+
+# include <vector>
+# include <core_utils/CoreObject.hh>
+# include <core_utils/RNG.hh>
+# include <maths_utils/Point2.hh>
+# include "Element.hh"
+# include "SimulationParams.hh"
+
+namespace cellify {
+
+  /// @brief - Convenience structure describing the content of
+  /// a generated world. All elements are placed in a square
+  /// area centered on the origin.
+  struct ScenarioDesc {
+    // The seed of the random number generator used both to
+    // generate the scenario and to simulate the world.
+    int seed;
+
+    // The half size of the area in which elements are placed.
+    int half;
+
+    // The number of colonies.
+    unsigned colonies;
+
+    // The fraction of the cells of the area covered by the
+    // walls of the maze, in the range `[0; 1]`.
+    float obstacles;
+
+    // The number of ants spawned around the colonies.
+    unsigned ants;
+
+    // The number of pheromons spread over the area.
+    unsigned pheromons;
+  };
+
+  /**
+   * @brief - Creates a default scenario with a single colony
+   *          and a handful of food deposits.
+   * @param seed - the seed of the scenario.
+   * @param half - the half size of the area.
+   * @return - the description of the scenario.
+   */
+  ScenarioDesc
+  newScenarioDesc(int seed = 0,
+                  int half = 20) noexcept;
+
+  class Scenario: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Creates a new scenario from its description.
+       *          The number of food deposits, their stock and
+       *          the evaporation rate of the pheromons are taken
+       *          from the parameters of the simulation.
+       * @param desc - the description of the scenario.
+       * @param params - the parameters of the simulation.
+       */
+      Scenario(const ScenarioDesc& desc,
+               const SimulationParams& params);
+
+      /**
+       * @brief - Returns the description of the scenario.
+       * @return - the description of the scenario.
+       */
+      const ScenarioDesc&
+      desc() const noexcept;
+
+      /**
+       * @brief - Generate the elements of the scenario. The
+       *          generation only depends on the description and
+       *          the parameters so that two calls produce identical worlds.
+       *          The walls of the maze are straight segments
+       *          never touching each other: no area of the world
+       *          is ever enclosed so that any location can be
+       *          reached by the ants.
+       * @return - the generated elements.
+       */
+      Elements
+      generate() const;
+
+    private:
+
+      /// @brief - The content of a cell during the generation.
+      enum class Cell {
+        Free,
+        Reserved,
+        Occupied
+      };
+
+      /// @brief - Convenience define to represent the cells of
+      /// the area.
+      using Cells = std::vector<Cell>;
+
+      /**
+       * @brief - Returns the index of the input coordinates in
+       *          the list of cells, or a negative value in case
+       *          the coordinates are outside of the area.
+       * @param x - the abscissa of the cell.
+       * @param y - the ordinate of the cell.
+       * @return - the index of the cell.
+       */
+      int
+      index(int x, int y) const noexcept;
+
+      /**
+       * @brief - Pick a random free cell in the area.
+       * @param rng - the random number generator.
+       * @param cells - the cells of the area.
+       * @param p - output argument receiving the position.
+       * @return - `false` if no free cell could be found.
+       */
+      bool
+      pick(utils::RNG& rng, const Cells& cells, utils::Point2i& p) const noexcept;
+
+      /**
+       * @brief - Reserve the cells around the input position so
+       *          that no wall is generated there.
+       * @param cells - the cells of the area.
+       * @param p - the center of the reserved area.
+       * @param radius - the radius of the reserved area.
+       */
+      void
+      reserve(Cells& cells, const utils::Point2i& p, int radius) const noexcept;
+
+      /**
+       * @brief - Generate the walls of the maze.
+       * @param rng - the random number generator.
+       * @param cells - the cells of the area.
+       * @param out - the list to which walls are added.
+       */
+      void
+      generateMaze(utils::RNG& rng, Cells& cells, Elements& out) const;
+
+    private:
+
+      /**
+       * @brief - The description of the scenario.
+       */
+      ScenarioDesc m_desc;
+
+      /**
+       * @brief - The parameters of the simulation.
+       */
+      SimulationParams m_params;
+  };
+
+}
+
+#endif    /* SCENARIO_HH */
@@ -0,0 +1,98 @@
+#ifndef    TRIPLE_BUFFER_HH
+# define   TRIPLE_BUFFER_HH
+
+# include <array>
+# include <atomic>
+
+namespace cellify {
+
+  /// @brief - Allows a single writer thread to publish values to
+  /// a single reader thread without any lock. Three slots are
+  /// used: the writer fills the back slot, the reader uses the
+  /// front slot and the middle one holds the latest published
+  /// value. Publishing and acquiring exchange slots with the
+  /// middle one: neither thread ever waits for the other and
+  /// the reader always gets the most recent complete value.
+  template <typename T>
+  class TripleBuffer {
+    public:
+
+      /**
+       * @brief - Creates a new buffer with default constructed
+       *          values.
+       */
+      TripleBuffer();
+
+      /**
+       * @brief - Returns the slot in which the writer should
+       *          prepare the next value. Only the writer thread
+       *          should call this method.
+       * @return - the slot of the writer.
+       */
+      T&
+      back() noexcept;
+
+      /**
+       * @brief - Publish the value of the back slot so that the
+       *          reader can acquire it. The writer then receives
+       *          a new slot which holds an older value. Only the
+       *          writer thread should call this method.
+       */
+      void
+      publish() noexcept;
+
+      /**
+       * @brief - Make the latest published value available in the
+       *          front slot, if a new one was published since the
+       *          last call. Only the reader thread should call this
+       *          method.
+       * @return - `true` if a new value was acquired.
+       */
+      bool
+      acquire() noexcept;
+
+      /**
+       * @brief - Returns the value acquired by the reader. It is
+       *          not modified until the next call to `acquire`.
+       *          Only the reader thread should call this method.
+       * @return - the slot of the reader.
+       */
+      const T&
+      front() const noexcept;
+
+    private:
+
+      /// @brief - Set on the index of the middle slot when it
+      /// holds a value which was not yet acquired.
+      static constexpr unsigned FRESH = 4u;
+
+      /// @brief - Extracts the index of a slot.
+      static constexpr unsigned INDEX_MASK = 3u;
+
+      /**
+       * @brief - The storage for the values.
+       */
+      std::array<T, 3u> m_slots;
+
+      /**
+       * @brief - The index of the middle slot, along with whether
+       *          it holds a fresh value.
+       */
+      std::atomic<unsigned> m_middle;
+
+      /**
+       * @brief - The index of the slot of the writer.
+       */
+      unsigned m_back;
+
+      /**
+       * @brief - The index of the slot of the reader.
+       */
+      unsigned m_front;
+  };
+
+}
+
+# include "TripleBuffer.hxx"
+
+#endif    /* TRIPLE_BUFFER_HH */
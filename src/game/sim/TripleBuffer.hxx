@@ -0,0 +1,56 @@
+#ifndef    TRIPLE_BUFFER_HXX
+# define   TRIPLE_BUFFER_HXX
+
+# include "TripleBuffer.hh"
+
+namespace cellify {
+
+  template <typename T>
+  inline
+  TripleBuffer<T>::TripleBuffer():
+    m_slots(),
+    m_middle(1u),
+
+    m_back(0u),
+    m_front(2u)
+  {}
+
+  template <typename T>
+  inline
+  T&
+  TripleBuffer<T>::back() noexcept {
+    return m_slots[m_back];
+  }
+
+  template <typename T>
+  inline
+  void
+  TripleBuffer<T>::publish() noexcept {
+    unsigned prev = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+    m_back = prev & INDEX_MASK;
+  }
+
+  template <typename T>
+  inline
+  bool
+  TripleBuffer<T>::acquire() noexcept {
+    if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0u) {
+      return false;
+    }
+
+    unsigned prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = prev & INDEX_MASK;
+
+    return true;
+  }
+
+  template <typename T>
+  inline
+  const T&
+  TripleBuffer<T>::front() const noexcept {
+    return m_slots[m_front];
+  }
+
+}
+
+#endif    /* TRIPLE_BUFFER_HXX */
@@ -0,0 +1,361 @@
+
+# include "Trajectory.hh"
+# include <chrono>
+# include <cstring>
+# include "Ant.hh"
+
+/// @brief - The first bytes of a trajectory file.
+# define TRAJECTORY_MAGIC "CTRJ"
+
+/// @brief - The time the writer thread sleeps when there is
+/// no frame to write, in milliseconds.
+# define TRAJECTORY_POLL_INTERVAL 1
+
+namespace {
+
+  /**
+   * @brief - Append the raw bytes of a value to the buffer.
+   * @param out - the buffer.
+   * @param value - the value to append.
+   */
+  template <typename T>
+  void
+  putRaw(std::vector<char>& out, const T& value) noexcept {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+  }
+
+  /**
+   * @brief - Append an unsigned value to the buffer using as
+   *          few bytes as possible: 7 bits per byte, with the
+   *          high bit set when more bytes follow.
+   * @param out - the buffer.
+   * @param value - the value to append.
+   */
+  void
+  putVarint(std::vector<char>& out, std::uint64_t value) noexcept {
+    while (value >= 0x80u) {
+      out.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+      value >>= 7u;
+    }
+
+    out.push_back(static_cast<char>(value));
+  }
+
+  /**
+   * @brief - Append a signed value to the buffer as a varint:
+   *          the value is zigzag encoded first so that small
+   *          negative values also use few bytes.
+   * @param out - the buffer.
+   * @param value - the value to append.
+   */
+  void
+  putSigned(std::vector<char>& out, std::int64_t value) noexcept {
+    std::uint64_t zz = (static_cast<std::uint64_t>(value) << 1u) ^ static_cast<std::uint64_t>(value >> 63);
+    putVarint(out, zz);
+  }
+
+}
+
+namespace cellify {
+
+  Trajectory::Trajectory(const std::string& file):
+    utils::CoreObject("trajectory"),
+
+    m_file(file),
+    m_out(),
+
+    m_pool(),
+    m_free(),
+    m_pending(),
+
+    m_running(false),
+    m_writer(),
+
+    m_frames(0u),
+    m_stalls(0u),
+    m_bytes(0u),
+    m_written(0u),
+    m_failed(0u),
+
+    m_last(),
+    m_next(),
+    m_block(),
+    m_ys(),
+    m_header()
+  {
+    setService("trajectory");
+
+    m_free.head.store(0u);
+    m_free.tail.store(0u);
+    m_pending.head.store(0u);
+    m_pending.tail.store(0u);
+  }
+
+  Trajectory::~Trajectory() {
+    close();
+  }
+
+  void
+  Trajectory::open() {
+    if (m_running.load(std::memory_order_acquire)) {
+      warn("Trajectory is already exported to \"" + m_file + "\"");
+      return;
+    }
+
+    m_out.open(m_file, std::ios::binary | std::ios::trunc);
+    if (!m_out.good()) {
+      error(
+        "Failed to export trajectory to \"" + m_file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    m_out.write(TRAJECTORY_MAGIC, std::strlen(TRAJECTORY_MAGIC));
+    m_out.write(reinterpret_cast<const char*>(&TRAJECTORY_VERSION), sizeof(TRAJECTORY_VERSION));
+    if (!m_out.good()) {
+      m_out.close();
+      error(
+        "Failed to export trajectory to \"" + m_file + "\"",
+        "Failed to write header"
+      );
+    }
+
+    m_frames = 0u;
+    m_stalls = 0u;
+    m_bytes.store(std::strlen(TRAJECTORY_MAGIC) + sizeof(TRAJECTORY_VERSION));
+    m_written.store(0u);
+    m_failed.store(0u);
+    m_last.clear();
+
+    // All the frames are available to the simulation.
+    if (m_pool.empty()) {
+      for (unsigned id = 0u ; id < TRAJECTORY_QUEUE_CAPACITY ; ++id) {
+        m_pool.push_back(std::make_unique<Frame>());
+      }
+    }
+
+    m_pending.tail.store(m_pending.head.load());
+    m_free.tail.store(m_free.head.load());
+    for (unsigned id = 0u ; id < m_pool.size() ; ++id) {
+      enqueue(m_free, m_pool[id].get());
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_writer = std::thread(&Trajectory::writeLoop, this);
+
+    notice("Started exporting trajectory to \"" + m_file + "\"");
+  }
+
+  void
+  Trajectory::close() {
+    if (!m_running.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    m_running.store(false, std::memory_order_release);
+    m_writer.join();
+
+    // The last frames may only fail when flushed.
+    bool flushed = m_out.good();
+    m_out.close();
+
+    std::string summary =
+      "Exported " + std::to_string(m_written.load()) + " frame(s) (" + std::to_string(bytes()) +
+      " byte(s)) to \"" + m_file + "\", waited " + std::to_string(m_stalls) + " time(s) for the writer"
+    ;
+
+    unsigned failed = m_failed.load();
+    if (failed > 0u || !flushed) {
+      warn(summary + ", failed to write " + std::to_string(failed) + "/" + std::to_string(m_frames) + " frame(s)");
+      return;
+    }
+
+    notice(summary);
+  }
+
+  void
+  Trajectory::push(unsigned tick,
+                   const TimeStamp& moment,
+                   const Elements& elements) noexcept
+  {
+    if (!m_running.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    Frame* f = dequeue(m_free);
+    if (f == nullptr) {
+      ++m_stalls;
+
+      while ((f = dequeue(m_free)) == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+
+    // The buffers of the frame keep their capacity from a
+    // tick to the next so that no memory is allocated once
+    // the population is stable.
+    f->tick = tick;
+    f->moment = moment;
+    f->ids.clear();
+    f->xs.clear();
+    f->ys.clear();
+    f->behaviors.clear();
+    f->food.clear();
+
+    for (unsigned id = 0u ; id < elements.size() ; ++id) {
+      const Element& e = *elements[id];
+      if (e.type() != Tile::Ant) {
+        continue;
+      }
+
+      AntShPtr a = std::dynamic_pointer_cast<Ant>(e.brain());
+      if (a == nullptr) {
+        continue;
+      }
+
+      AntState as = a->state();
+
+      f->ids.push_back(e.serial());
+      f->xs.push_back(e.pos().x());
+      f->ys.push_back(e.pos().y());
+      f->behaviors.push_back(static_cast<std::uint8_t>(as.behavior));
+      f->food.push_back(as.food);
+    }
+
+    enqueue(m_pending, f);
+    ++m_frames;
+  }
+
+  unsigned
+  Trajectory::frames() const noexcept {
+    return m_frames;
+  }
+
+  unsigned
+  Trajectory::stalls() const noexcept {
+    return m_stalls;
+  }
+
+  std::uint64_t
+  Trajectory::bytes() const noexcept {
+    return m_bytes.load(std::memory_order_relaxed);
+  }
+
+  void
+  Trajectory::enqueue(Queue& q, Frame* f) noexcept {
+    std::uint64_t h = q.head.load(std::memory_order_relaxed);
+
+    q.frames[h & (TRAJECTORY_QUEUE_CAPACITY - 1u)] = f;
+    q.head.store(h + 1u, std::memory_order_release);
+  }
+
+  Trajectory::Frame*
+  Trajectory::dequeue(Queue& q) noexcept {
+    std::uint64_t t = q.tail.load(std::memory_order_relaxed);
+    std::uint64_t h = q.head.load(std::memory_order_acquire);
+
+    if (t == h) {
+      return nullptr;
+    }
+
+    Frame* f = q.frames[t & (TRAJECTORY_QUEUE_CAPACITY - 1u)];
+    q.tail.store(t + 1u, std::memory_order_release);
+
+    return f;
+  }
+
+  void
+  Trajectory::writeLoop() {
+    while (true) {
+      // The status is fetched before looking for frames: once
+      // the export is stopped no frame is queued anymore, so
+      // an empty queue means that everything was written.
+      bool running = m_running.load(std::memory_order_acquire);
+
+      Frame* f = dequeue(m_pending);
+      if (f == nullptr) {
+        if (!running) {
+          break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(TRAJECTORY_POLL_INTERVAL));
+        continue;
+      }
+
+      bool written = write(*f);
+      (written ? m_written : m_failed).fetch_add(1u, std::memory_order_relaxed);
+
+      enqueue(m_free, f);
+    }
+
+    m_out.flush();
+  }
+
+  bool
+  Trajectory::write(const Frame& f) {
+    // Once a write failed the blocks which follow can't be
+    // decoded anymore: they are not written.
+    if (!m_out.good()) {
+      return false;
+    }
+
+    unsigned count = f.ids.size();
+
+    m_block.clear();
+
+    std::uint64_t prev = 0u;
+    for (unsigned id = 0u ; id < count ; ++id) {
+      putSigned(m_block, static_cast<std::int64_t>(f.ids[id] - prev));
+      prev = f.ids[id];
+    }
+
+    // Positions are encoded against the previous block: the
+    // map is rebuilt so that dead ants are forgotten.
+    m_next.clear();
+    m_next.reserve(count);
+
+    m_ys.clear();
+
+    for (unsigned id = 0u ; id < count ; ++id) {
+      std::pair<int, int> last(0, 0);
+
+      std::unordered_map<std::uint64_t, std::pair<int, int>>::const_iterator it = m_last.find(f.ids[id]);
+      if (it != m_last.cend()) {
+        last = it->second;
+      }
+
+      putSigned(m_block, static_cast<std::int64_t>(f.xs[id]) - last.first);
+      putSigned(m_ys, static_cast<std::int64_t>(f.ys[id]) - last.second);
+
+      m_next.emplace(f.ids[id], std::make_pair(f.xs[id], f.ys[id]));
+    }
+
+    m_block.insert(m_block.end(), m_ys.cbegin(), m_ys.cend());
+    m_block.insert(m_block.end(), f.behaviors.cbegin(), f.behaviors.cend());
+    for (unsigned id = 0u ; id < count ; ++id) {
+      putRaw(m_block, f.food[id]);
+    }
+
+    m_last.swap(m_next);
+
+    m_header.clear();
+    putVarint(m_header, f.tick);
+    putRaw(m_header, f.moment);
+    putVarint(m_header, count);
+    putVarint(m_header, m_block.size());
+
+    m_out.write(m_header.data(), m_header.size());
+    m_out.write(m_block.data(), m_block.size());
+
+    if (!m_out.good()) {
+      warn("Failed to write frame for tick " + std::to_string(f.tick) + " to \"" + m_file + "\"");
+      return false;
+    }
+
+    m_bytes.fetch_add(m_header.size() + m_block.size(), std::memory_order_relaxed);
+
+    return true;
+  }
+
+}
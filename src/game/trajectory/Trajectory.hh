@@ -0,0 +1,300 @@
+#ifndef    TRAJECTORY_HH
+# define   TRAJECTORY_HH
+
+# include <array>
+# include <atomic>
+# include <string>
+# include <vector>
+# include <memory>
+# include <thread>
+# include <cstdint>
+# include <fstream>
+# include <unordered_map>
+# include <core_utils/CoreObject.hh>
+# include "Element.hh"
+# include "Time.hh"
+
+namespace cellify {
+
+  /// @brief - The version of the trajectory format: it should
+  /// be incremented whenever the layout of the file changes.
+  constexpr std::uint32_t TRAJECTORY_VERSION = 1u;
+
+  /// @brief - The number of frames which can be queued for the
+  /// writer thread. Must be a power of two.
+  constexpr unsigned TRAJECTORY_QUEUE_CAPACITY = 8u;
+
+  /// @brief - A streaming export of the state of the ants at
+  /// each tick of the world. The simulation thread only copies
+  /// the raw state of the ants into a frame taken from a pool,
+  /// and hands it to a writer thread through a lock-free queue.
+  /// The writer encodes the frames and appends them to a binary
+  /// file made of a header followed by one block per tick:
+  ///   - the tick, the moment of the simulation and the number
+  ///     of ants, followed by the size of the columns in bytes.
+  ///   - the identifiers of the ants, as the difference with the
+  ///     previous identifier of the block.
+  ///   - the abscissa then the ordinate of the ants, as the
+  ///     difference with the position of the same ant in the
+  ///     previous block (or with the origin for new ants).
+  ///   - the behavior of the ants, one byte each.
+  ///   - the food carried by the ants, as raw floats.
+  /// Differences are zigzag encoded and stored as varints: an
+  /// ant moving by one cell costs a single byte per axis.
+  class Trajectory: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create an export attached to the input file.
+       *          Nothing is written until `open` is called.
+       * @param file - the path to the output file.
+       */
+      Trajectory(const std::string& file);
+
+      /**
+       * @brief - Write the pending frames and close the file.
+       */
+      ~Trajectory();
+
+      /**
+       * @brief - Deleted copy constructor: the object owns the
+       *          writer thread.
+       */
+      Trajectory(const Trajectory&) = delete;
+
+      /**
+       * @brief - Deleted assignment operator.
+       */
+      Trajectory&
+      operator=(const Trajectory&) = delete;
+
+      /**
+       * @brief - Open the output file, erasing any prior content,
+       *          and start the writer thread. An error is raised
+       *          if the file can't be opened.
+       */
+      void
+      open();
+
+      /**
+       * @brief - Write the pending frames, stop the writer thread
+       *          and close the file. A warning is issued if some
+       *          frames could not be written. Does nothing in case
+       *          the export is not active.
+       */
+      void
+      close();
+
+      /**
+       * @brief - Queue the state of the ants for the input tick.
+       *          In case the writer is late and all the frames are
+       *          in use, the caller waits for one to be released
+       *          so that no tick is lost. Does nothing in case the
+       *          export is not active.
+       * @param tick - the index of the tick.
+       * @param moment - the moment of the simulation.
+       * @param elements - the elements of the world.
+       */
+      void
+      push(unsigned tick,
+           const TimeStamp& moment,
+           const Elements& elements) noexcept;
+
+      /**
+       * @brief - The number of frames queued so far.
+       * @return - the number of frames.
+       */
+      unsigned
+      frames() const noexcept;
+
+      /**
+       * @brief - The number of times the simulation had to wait
+       *          for the writer thread.
+       * @return - the number of stalls.
+       */
+      unsigned
+      stalls() const noexcept;
+
+      /**
+       * @brief - The number of bytes written so far. This value
+       *          is updated by the writer thread.
+       * @return - the number of bytes written.
+       */
+      std::uint64_t
+      bytes() const noexcept;
+
+    private:
+
+      /// @brief - The raw state of the ants at a given tick.
+      struct Frame {
+        // The index of the tick.
+        unsigned tick;
+
+        // The moment of the simulation.
+        TimeStamp moment;
+
+        // The identifiers of the ants.
+        std::vector<std::uint64_t> ids;
+
+        // The abscissa of the ants.
+        std::vector<int> xs;
+
+        // The ordinate of the ants.
+        std::vector<int> ys;
+
+        // The behavior of the ants.
+        std::vector<std::uint8_t> behaviors;
+
+        // The food carried by the ants.
+        std::vector<float> food;
+      };
+
+      /// @brief - A single producer single consumer ring buffer
+      /// of frames. No lock is involved.
+      struct Queue {
+        // The index of the next frame to write, only modified by
+        // the producer.
+        std::atomic<std::uint64_t> head;
+
+        // The index of the next frame to read, only modified by
+        // the consumer.
+        std::atomic<std::uint64_t> tail;
+
+        // The storage for the frames.
+        std::array<Frame*, TRAJECTORY_QUEUE_CAPACITY> frames;
+      };
+
+      /**
+       * @brief - Append a frame to a queue. The queue can't be
+       *          full as it can hold all the frames of the pool.
+       * @param q - the queue.
+       * @param f - the frame to append.
+       */
+      static void
+      enqueue(Queue& q, Frame* f) noexcept;
+
+      /**
+       * @brief - Take the oldest frame of a queue.
+       * @param q - the queue.
+       * @return - the frame or null if the queue is empty.
+       */
+      static Frame*
+      dequeue(Queue& q) noexcept;
+
+      /**
+       * @brief - The loop of the writer thread: encode and write
+       *          the queued frames until the export is closed.
+       */
+      void
+      writeLoop();
+
+      /**
+       * @brief - Encode a frame and append it to the file.
+       * @param f - the frame to write.
+       * @return - `true` if the frame was written.
+       */
+      bool
+      write(const Frame& f);
+
+    private:
+
+      /**
+       * @brief - The path to the output file.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The output stream, only used by the writer
+       *          thread once the export is started.
+       */
+      std::ofstream m_out;
+
+      /**
+       * @brief - The storage for the frames.
+       */
+      std::vector<std::unique_ptr<Frame>> m_pool;
+
+      /**
+       * @brief - The frames available to the simulation.
+       */
+      Queue m_free;
+
+      /**
+       * @brief - The frames waiting to be written.
+       */
+      Queue m_pending;
+
+      /**
+       * @brief - Whether the writer thread should keep running.
+       */
+      std::atomic<bool> m_running;
+
+      /**
+       * @brief - The thread encoding and writing the frames.
+       */
+      std::thread m_writer;
+
+      /**
+       * @brief - The number of frames queued so far.
+       */
+      unsigned m_frames;
+
+      /**
+       * @brief - The number of times the simulation waited for
+       *          a frame to be available.
+       */
+      unsigned m_stalls;
+
+      /**
+       * @brief - The number of bytes written so far.
+       */
+      std::atomic<std::uint64_t> m_bytes;
+
+      /**
+       * @brief - The number of frames written so far. It is
+       *          updated by the writer thread.
+       */
+      std::atomic<unsigned> m_written;
+
+      /**
+       * @brief - The number of frames which could not be
+       *          written. It is updated by the writer thread.
+       */
+      std::atomic<unsigned> m_failed;
+
+      /**
+       * @brief - The position of each ant in the last block that
+       *          was written, used by the writer thread to encode
+       *          the motion of the ants.
+       */
+      std::unordered_map<std::uint64_t, std::pair<int, int>> m_last;
+
+      /**
+       * @brief - The position of each ant in the block being
+       *          written. It is swapped with `m_last` once the
+       *          block is encoded.
+       */
+      std::unordered_map<std::uint64_t, std::pair<int, int>> m_next;
+
+      /**
+       * @brief - The buffer holding the encoded block, reused
+       *          from a frame to the next.
+       */
+      std::vector<char> m_block;
+
+      /**
+       * @brief - The buffer holding the ordinates of the block
+       *          while the abscissa are encoded.
+       */
+      std::vector<char> m_ys;
+
+      /**
+       * @brief - The buffer holding the header of the block.
+       */
+      std::vector<char> m_header;
+  };
+
+  using TrajectoryShPtr = std::shared_ptr<Trajectory>;
+}
+
+#endif    /* TRAJECTORY_HH */
@@ -0,0 +1,373 @@
+
+# include "Tracer.hh"
+# include <array>
+# include <atomic>
+# include <chrono>
+# include <fstream>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+# include <condition_variable>
+# include <core_utils/CoreObject.hh>
+
+/// @brief - The number of events that can be buffered for a
+/// single thread. Must be a power of two.
+# define TRACE_BUFFER_CAPACITY 16384u
+
+/// @brief - The interval in milliseconds between two flushes
+/// of the buffers to the output file.
+# define TRACE_FLUSH_INTERVAL 50
+
+namespace {
+
+  /// @brief - A complete event as recorded by a thread.
+  struct Event {
+    const char* name;
+    const char* category;
+    std::uint64_t start;
+    std::uint64_t end;
+  };
+
+  /// @brief - A single producer single consumer ring buffer of
+  /// events: the traced thread pushes events to it while the
+  /// flushing thread drains it. No lock is involved.
+  struct Buffer {
+    // The identifier of the thread owning the buffer.
+    unsigned tid;
+
+    // The index of the next event to write, only modified by
+    // the producer thread.
+    std::atomic<std::uint64_t> head;
+
+    // The index of the next event to read, only modified by
+    // the flushing thread.
+    std::atomic<std::uint64_t> tail;
+
+    // The number of events dropped because the buffer was full.
+    std::atomic<std::uint64_t> dropped;
+
+    // The storage for the events.
+    std::array<Event, TRACE_BUFFER_CAPACITY> events;
+  };
+
+  using BufferShPtr = std::shared_ptr<Buffer>;
+
+  class Tracer: public utils::CoreObject {
+    public:
+
+      Tracer():
+        utils::CoreObject("tracer"),
+
+        m_enabled(false),
+        m_origin(std::chrono::steady_clock::now()),
+
+        m_registry(),
+        m_buffers(),
+        m_nextTid(1u),
+        m_lost(0u),
+
+        m_locker(),
+        m_draining(),
+
+        m_out(),
+        m_first(true),
+
+        m_running(false),
+        m_wakeup(),
+        m_flusher()
+      {
+        setService("trace");
+      }
+
+      bool
+      enabled() const noexcept {
+        return m_enabled.load(std::memory_order_relaxed);
+      }
+
+      std::uint64_t
+      now() const noexcept {
+        std::chrono::nanoseconds d = std::chrono::steady_clock::now() - m_origin;
+        return static_cast<std::uint64_t>(d.count());
+      }
+
+      bool
+      start(const std::string& file) {
+        std::lock_guard<std::mutex> guard(m_locker);
+
+        if (m_running) {
+          warn("Tracing is already active, ignoring request to trace to \"" + file + "\"");
+          return false;
+        }
+
+        m_out.open(file, std::ios::out | std::ios::trunc);
+        if (!m_out.good()) {
+          warn("Failed to open trace file \"" + file + "\"");
+          return false;
+        }
+
+        m_out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        m_first = true;
+
+        // Discard any event recorded by a previous session.
+        {
+          std::lock_guard<std::mutex> registry(m_registry);
+
+          for (unsigned id = 0u ; id < m_buffers.size() ; ++id) {
+            m_buffers[id]->tail.store(m_buffers[id]->head.load(std::memory_order_acquire), std::memory_order_release);
+            m_buffers[id]->dropped.store(0u, std::memory_order_relaxed);
+          }
+        }
+        m_lost.store(0u, std::memory_order_relaxed);
+
+        m_running = true;
+        m_flusher = std::thread(&Tracer::flushLoop, this);
+        m_enabled.store(true, std::memory_order_release);
+
+        notice("Started tracing to \"" + file + "\"");
+
+        return true;
+      }
+
+      void
+      stop() {
+        {
+          std::lock_guard<std::mutex> guard(m_locker);
+          if (!m_running) {
+            return;
+          }
+
+          m_enabled.store(false, std::memory_order_release);
+          m_running = false;
+        }
+
+        m_wakeup.notify_all();
+        m_flusher.join();
+
+        // Write the remaining events and close the file.
+        std::lock_guard<std::mutex> guard(m_locker);
+
+        std::uint64_t dropped = drain();
+
+        m_out << "]}" << std::endl;
+        m_out.close();
+
+        notice("Stopped tracing");
+        if (dropped > 0u) {
+          warn("Dropped " + std::to_string(dropped) + " trace event(s) as buffers were full or could not be registered");
+        }
+      }
+
+      void
+      record(const Event& e) noexcept {
+        Buffer* buffer = local();
+        if (buffer == nullptr) {
+          m_lost.fetch_add(1u, std::memory_order_relaxed);
+          return;
+        }
+
+        Buffer& b = *buffer;
+
+        std::uint64_t h = b.head.load(std::memory_order_relaxed);
+        std::uint64_t t = b.tail.load(std::memory_order_acquire);
+
+        if (h - t >= TRACE_BUFFER_CAPACITY) {
+          b.dropped.fetch_add(1u, std::memory_order_relaxed);
+          return;
+        }
+
+        b.events[h & (TRACE_BUFFER_CAPACITY - 1u)] = e;
+        b.head.store(h + 1u, std::memory_order_release);
+      }
+
+    private:
+
+      /**
+       * @brief - Returns the buffer of the calling thread. Each
+       *          thread registers its buffer upon recording its
+       *          first event: this is the only time a lock is
+       *          taken, and it is never held during any I/O.
+       * @return - the buffer of the thread or `null` in case it
+       *           could not be registered.
+       */
+      Buffer*
+      local() noexcept {
+        thread_local BufferShPtr buffer = nullptr;
+
+        if (buffer != nullptr) {
+          return buffer.get();
+        }
+
+        try {
+          BufferShPtr b = std::make_shared<Buffer>();
+          b->head.store(0u);
+          b->tail.store(0u);
+          b->dropped.store(0u);
+
+          std::lock_guard<std::mutex> guard(m_registry);
+          b->tid = m_nextTid;
+          m_buffers.push_back(b);
+          ++m_nextTid;
+
+          buffer = b;
+        }
+        catch (...) {
+          // The event is lost: the registration is attempted
+          // again upon the next one.
+          return nullptr;
+        }
+
+        return buffer.get();
+      }
+
+      void
+      flushLoop() {
+        std::unique_lock<std::mutex> guard(m_locker);
+
+        while (m_running) {
+          m_wakeup.wait_for(guard, std::chrono::milliseconds(TRACE_FLUSH_INTERVAL));
+          drain();
+        }
+      }
+
+      /**
+       * @brief - Write all the events pending in the buffers of
+       *          the threads to the output file. Assumes that the
+       *          lock on the file is held. The list of buffers is
+       *          copied first so that threads can register while
+       *          the events are written.
+       * @return - the total number of events dropped so far.
+       */
+      std::uint64_t
+      drain() {
+        {
+          std::lock_guard<std::mutex> registry(m_registry);
+          m_draining.assign(m_buffers.cbegin(), m_buffers.cend());
+        }
+
+        std::uint64_t dropped = m_lost.load(std::memory_order_relaxed);
+
+        for (unsigned id = 0u ; id < m_draining.size() ; ++id) {
+          Buffer& b = *m_draining[id];
+
+          std::uint64_t t = b.tail.load(std::memory_order_relaxed);
+          std::uint64_t h = b.head.load(std::memory_order_acquire);
+
+          for (std::uint64_t cur = t ; cur < h ; ++cur) {
+            write(b.tid, b.events[cur & (TRACE_BUFFER_CAPACITY - 1u)]);
+          }
+
+          b.tail.store(h, std::memory_order_release);
+          dropped += b.dropped.load(std::memory_order_relaxed);
+        }
+
+        m_out.flush();
+
+        return dropped;
+      }
+
+      void
+      write(unsigned tid, const Event& e) {
+        if (!m_first) {
+          m_out << ",";
+        }
+        m_first = false;
+
+        // Chrome expects timestamps in microseconds.
+        m_out << "\n{\"name\":\"" << e.name << "\""
+              << ",\"cat\":\"" << e.category << "\""
+              << ",\"ph\":\"X\""
+              << ",\"ts\":" << e.start / 1000u << "." << (e.start % 1000u) / 100u
+              << ",\"dur\":" << (e.end - e.start) / 1000u << "." << ((e.end - e.start) % 1000u) / 100u
+              << ",\"pid\":1"
+              << ",\"tid\":" << tid
+              << "}";
+      }
+
+    private:
+
+      // Whether events should be recorded: checked by each
+      // traced scope so it is kept outside of the lock.
+      std::atomic<bool> m_enabled;
+
+      // The origin of the timestamps.
+      std::chrono::steady_clock::time_point m_origin;
+
+      // Protects the list of buffers registered by the threads.
+      std::mutex m_registry;
+
+      // The buffers registered by the threads so far.
+      std::vector<BufferShPtr> m_buffers;
+
+      // The identifier to assign to the next registered thread.
+      unsigned m_nextTid;
+
+      // The number of events lost because the buffer of their
+      // thread could not be registered.
+      std::atomic<std::uint64_t> m_lost;
+
+      // Protects the output file and the state of the flushing
+      // thread.
+      std::mutex m_locker;
+
+      // The buffers being drained by the flushing thread.
+      std::vector<BufferShPtr> m_draining;
+
+      // The output file.
+      std::ofstream m_out;
+
+      // Whether no event was written yet to the output file.
+      bool m_first;
+
+      // Whether the flushing thread should keep running.
+      bool m_running;
+
+      // Used to wake up the flushing thread when stopping.
+      std::condition_variable m_wakeup;
+
+      // The thread writing the events to the output file.
+      std::thread m_flusher;
+  };
+
+  Tracer&
+  tracer() {
+    static Tracer t;
+    return t;
+  }
+
+}
+
+namespace pge {
+  namespace trace {
+
+    bool
+    start(const std::string& file) {
+      return tracer().start(file);
+    }
+
+    void
+    stop() {
+      tracer().stop();
+    }
+
+    bool
+    enabled() noexcept {
+      return tracer().enabled();
+    }
+
+    std::uint64_t
+    now() noexcept {
+      return tracer().now();
+    }
+
+    void
+    record(const char* name,
+           const char* category,
+           std::uint64_t start,
+           std::uint64_t end) noexcept
+    {
+      tracer().record(Event{name, category, start, end});
+    }
+
+  }
+}
@@ -0,0 +1,115 @@
+#ifndef    TRACER_HH
+# define   TRACER_HH
+
+# include <string>
+# include <cstdint>
+
+namespace pge {
+  namespace trace {
+
+    /**
+     * @brief - Start recording trace events and write them in
+     *          the Chrome Trace Event format to the input file.
+     *          The file can be opened in `chrome://tracing` or
+     *          in Perfetto. Events are written by a background
+     *          thread so that the traced code is not slowed by
+     *          any I/O.
+     * @param file - the path to the output file.
+     * @return - `true` if the tracing could be started.
+     */
+    bool
+    start(const std::string& file);
+
+    /**
+     * @brief - Stop recording trace events, flush the pending
+     *          ones and close the output file. Does nothing in
+     *          case the tracing is not active.
+     */
+    void
+    stop();
+
+    /**
+     * @brief - Whether trace events are being recorded.
+     * @return - `true` if the tracing is active.
+     */
+    bool
+    enabled() noexcept;
+
+    /**
+     * @brief - Returns the current time in nanoseconds since an
+     *          arbitrary but fixed origin.
+     * @return - the current time in nanoseconds.
+     */
+    std::uint64_t
+    now() noexcept;
+
+    /**
+     * @brief - Record a complete event in the buffer of the
+     *          calling thread. The event is dropped in case
+     *          the buffer is full. The name and category must
+     *          outlive the tracing session (typically they are
+     *          string literals).
+     * @param name - the name of the event.
+     * @param category - the category of the event.
+     * @param start - the start of the event in nanoseconds.
+     * @param end - the end of the event in nanoseconds.
+     */
+    void
+    record(const char* name,
+           const char* category,
+           std::uint64_t start,
+           std::uint64_t end) noexcept;
+
+    /// @brief - Records an event spanning the lifetime of the
+    /// object. Costs a single atomic load when the tracing is
+    /// not active.
+    class Scope {
+      public:
+
+        /**
+         * @brief - Starts a new traced scope.
+         * @param name - the name of the event.
+         * @param category - the category of the event.
+         */
+        Scope(const char* name, const char* category) noexcept;
+
+        /**
+         * @brief - Ends the scope and record the event.
+         */
+        ~Scope();
+
+      private:
+
+        /**
+         * @brief - The name of the event.
+         */
+        const char* m_name;
+
+        /**
+         * @brief - The category of the event.
+         */
+        const char* m_category;
+
+        /**
+         * @brief - Whether the tracing was active when the scope
+         *          started.
+         */
+        bool m_active;
+
+        /**
+         * @brief - The start of the scope in nanoseconds.
+         */
+        std::uint64_t m_start;
+    };
+
+  }
+}
+
+/// @brief - Convenience macros to trace the enclosing scope.
+# define TRACE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+# define TRACE_CONCAT(lhs, rhs) TRACE_CONCAT_IMPL(lhs, rhs)
+# define TRACE_SCOPE(name, category) ::pge::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+
+# include "Tracer.hxx"
+
+#endif    /* TRACER_HH */
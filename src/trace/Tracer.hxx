@@ -0,0 +1,32 @@
+#ifndef    TRACER_HXX
+# define   TRACER_HXX
+
+# include "Tracer.hh"
+
+namespace pge {
+  namespace trace {
+
+    inline
+    Scope::Scope(const char* name, const char* category) noexcept:
+      m_name(name),
+      m_category(category),
+
+      m_active(enabled()),
+      m_start(0u)
+    {
+      if (m_active) {
+        m_start = now();
+      }
+    }
+
+    inline
+    Scope::~Scope() {
+      if (m_active) {
+        record(m_name, m_category, m_start, now());
+      }
+    }
+
+  }
+}
+
+#endif    /* TRACER_HXX */
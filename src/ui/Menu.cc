@@ -1,6 +1,67 @@
 
 # include "Menu.hh"
 
+namespace {
+
+  /**
+   * @brief - Blend a pixel over another one, keeping the opacity
+   *          of the result: used to paint the menus in a sprite
+   *          with transparent areas which is then drawn as a
+   *          decal over the rest of the app.
+   * @param src - the pixel drawn.
+   * @param dst - the pixel already in the sprite.
+   * @return - the blended pixel.
+   */
+  olc::Pixel
+  over(const int /*x*/, const int /*y*/, const olc::Pixel& src, const olc::Pixel& dst) {
+    if (src.a == 255 || dst.a == 0) {
+      return src;
+    }
+    if (src.a == 0) {
+      return dst;
+    }
+
+    float sa = src.a / 255.0f;
+    float da = dst.a / 255.0f * (1.0f - sa);
+    float a = sa + da;
+
+    return olc::Pixel(
+      static_cast<uint8_t>((src.r * sa + dst.r * da) / a),
+      static_cast<uint8_t>((src.g * sa + dst.g * da) / a),
+      static_cast<uint8_t>((src.b * sa + dst.b * da) / a),
+      static_cast<uint8_t>(a * 255.0f)
+    );
+  }
+
+  /**
+   * @brief - Draw a sprite scaled to the input dimensions with
+   *          the current pixel mode. Menus are only repainted
+   *          when they change so a nearest neighbour sampling
+   *          is enough.
+   * @param pge - the engine to draw with.
+   * @param pos - the position of the top left corner of the
+   *              sprite in the draw target.
+   * @param spr - the sprite to draw.
+   * @param size - the dimensions of the sprite once drawn.
+   */
+  void
+  drawScaled(olc::PixelGameEngine* pge,
+             const olc::vi2d& pos,
+             const olc::Sprite* spr,
+             const olc::vi2d& size)
+  {
+    for (int y = 0 ; y < size.y ; ++y) {
+      int sy = y * spr->height / size.y;
+
+      for (int x = 0 ; x < size.x ; ++x) {
+        int sx = x * spr->width / size.x;
+        pge->Draw(pos.x + x, pos.y + y, spr->GetPixel(sx, sy));
+      }
+    }
+  }
+
+}
+
 namespace pge {
 
   Menu::Menu(const olc::vi2d& pos,
@@ -34,7 +95,11 @@ namespace pge {
     m_parent(parent),
     m_children(),
 
-    m_callback()
+    m_callback(),
+
+    m_dirty(true),
+    m_cacheSprite(nullptr),
+    m_cacheDecal(nullptr)
   {
     setService("menu");
 
@@ -48,23 +113,13 @@ namespace pge {
       return;
     }
 
-    // Render the uniform background for this menu.
-    olc::vi2d pos = absolutePosition();
-    olc::Pixel c = m_bg.color;
-    if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
-      c = m_bg.hColor;
+    // Only repaint the menu when its appearance changed:
+    // most frames only draw the cached sprite.
+    if (m_dirty || m_cacheDecal == nullptr) {
+      repaint(pge);
     }
-    pge->FillRectDecal(pos, m_size, c);
 
-    // Render this menu.
-    renderSelf(pge);
-
-    // And then draw children in the order there were
-    // added: it means that the last added menu will
-    // be repainted on top of the others.
-    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
-      m_children[id]->render(pge);
-    }
+    pge->DrawDecal(absolutePosition(), m_cacheDecal);
   }
 
   menu::InputHandle
@@ -78,6 +133,10 @@ namespace pge {
       return res;
     }
 
+    // Moving the mouse over the menu only requires to
+    // repaint it when the colors change.
+    bool wasActive = active();
+
     // Make sure that the children get their chance
     // to process the event.
     for (unsigned id = 0u ; id < m_children.size() ; ++id) {
@@ -108,6 +167,10 @@ namespace pge {
         m_state.selected = false;
       }
 
+      if (active() != wasActive) {
+        invalidate();
+      }
+
       return res;
     }
 
@@ -133,6 +196,10 @@ namespace pge {
       res.selected = true;
     }
 
+    if (active() != wasActive) {
+      invalidate();
+    }
+
     return res;
   }
 
@@ -176,7 +243,7 @@ namespace pge {
   }
 
   void
-  Menu::renderSelf(olc::PixelGameEngine* pge) const {
+  Menu::renderSelf(olc::PixelGameEngine* pge, const olc::vi2d& pos) const {
     // We need to display both the text and the icon
     // if needed. We assume the content will always
     // be centered along the perpendicular axis for
@@ -190,8 +257,6 @@ namespace pge {
       return;
     }
 
-    olc::vi2d ap = absolutePosition();
-
     if (m_fg.text != "" && m_fgSprite == nullptr) {
       olc::vi2d ts = pge->GetTextSize(m_fg.text);
 
@@ -200,31 +265,27 @@ namespace pge {
       switch (m_fg.align) {
         case menu::Alignment::Center:
           p = olc::vi2d(
-            static_cast<int>(ap.x + (m_size.x - ts.x) / 2.0f),
-            static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+            static_cast<int>(pos.x + (m_size.x - ts.x) / 2.0f),
+            static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
           );
           break;
         case menu::Alignment::Right:
           p = olc::vi2d(
-            ap.x + m_size.x - ts.x,
-            static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+            pos.x + m_size.x - ts.x,
+            static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
           );
           break;
         case menu::Alignment::Left:
         default:
           p = olc::vi2d(
-            ap.x,
-            static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+            pos.x,
+            static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
           );
           break;
       }
 
-      olc::Pixel c = m_fg.color;
-      if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
-        c = m_fg.hColor;
-      }
-
-      pge->DrawStringDecal(p, m_fg.text, c);
+      olc::Pixel c = (active() ? m_fg.hColor : m_fg.color);
+      pge->DrawString(p, m_fg.text, c);
 
       return;
     }
@@ -233,14 +294,11 @@ namespace pge {
       // Center the image if it is the only element
       // to display.
       olc::vi2d p(
-        static_cast<int>(ap.x + m_size.x / 2.0f - m_fg.size.x / 2.0f),
-        static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+        static_cast<int>(pos.x + m_size.x / 2.0f - m_fg.size.x / 2.0f),
+        static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
       );
 
-      olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
-      olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
-
-      pge->DrawPartialDecal(p, m_fgSprite, olc::vi2d(), ss, s);
+      drawScaled(pge, p, m_fgSprite->sprite, m_fg.size);
 
       return;
     }
@@ -253,44 +311,41 @@ namespace pge {
     olc::vi2d tp;
     olc::vi2d sp;
 
-    olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
-    olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
-
     switch (m_fg.order) {
       case menu::Ordering::TextFirst:
         switch (m_fg.align) {
           case menu::Alignment::Center:
             tp = olc::vi2d(
-              static_cast<int>(ap.x + (m_size.x - cs.x) / 2.0f),
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              static_cast<int>(pos.x + (m_size.x - cs.x) / 2.0f),
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              static_cast<int>(ap.x + (m_size.x - cs.x) / 2.0f + ts.x),
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              static_cast<int>(pos.x + (m_size.x - cs.x) / 2.0f + ts.x),
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
           case menu::Alignment::Right:
             tp = olc::vi2d(
-              ap.x + m_size.x - cs.x,
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              pos.x + m_size.x - cs.x,
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              ap.x + m_size.x - m_fg.size.x,
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              pos.x + m_size.x - m_fg.size.x,
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
           case menu::Alignment::Left:
           default:
             tp = olc::vi2d(
-              ap.x,
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              pos.x,
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              ap.x + ts.x,
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              pos.x + ts.x,
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
         }
@@ -300,36 +355,36 @@ namespace pge {
         switch (m_fg.align) {
           case menu::Alignment::Center:
             tp = olc::vi2d(
-              static_cast<int>(ap.x + (m_size.x - cs.x) / 2.0f + m_fg.size.x),
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              static_cast<int>(pos.x + (m_size.x - cs.x) / 2.0f + m_fg.size.x),
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              static_cast<int>(ap.x + (m_size.x - cs.x) / 2.0f),
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              static_cast<int>(pos.x + (m_size.x - cs.x) / 2.0f),
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
           case menu::Alignment::Right:
             tp = olc::vi2d(
-              ap.x + m_size.x - ts.x,
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              pos.x + m_size.x - ts.x,
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              ap.x + m_size.x - cs.x,
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              pos.x + m_size.x - cs.x,
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
           case menu::Alignment::Left:
           default:
             tp = olc::vi2d(
-              ap.x + m_fg.size.x,
-              static_cast<int>(ap.y + (m_size.y - ts.y) / 2.0f)
+              pos.x + m_fg.size.x,
+              static_cast<int>(pos.y + (m_size.y - ts.y) / 2.0f)
             );
 
             sp = olc::vi2d(
-              ap.x,
-              static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
+              pos.x,
+              static_cast<int>(pos.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
             );
             break;
         }
@@ -337,14 +392,10 @@ namespace pge {
     }
 
     // Draw both the text and the image.
-    olc::Pixel c = m_fg.color;
-    if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
-      c = m_fg.hColor;
-    }
-
-    pge->DrawStringDecal(tp, m_fg.text, c);
+    olc::Pixel c = (active() ? m_fg.hColor : m_fg.color);
+    pge->DrawString(tp, m_fg.text, c);
 
-    pge->DrawPartialDecal(sp, m_fgSprite, olc::vi2d(), ss, s);
+    drawScaled(pge, sp, m_fgSprite->sprite, m_fg.size);
   }
 
   void
@@ -488,6 +539,67 @@ namespace pge {
           // the icon here.
           break;
       }
+
+      m_children[id]->m_dirty = true;
+    }
+
+    invalidate();
+  }
+
+  void
+  Menu::repaint(olc::PixelGameEngine* pge) const {
+    // Create the cached sprite or resize it if the
+    // menu has been laid out again.
+    if (m_cacheSprite == nullptr || m_cacheSprite->width != m_size.x || m_cacheSprite->height != m_size.y) {
+      if (m_cacheDecal != nullptr) {
+        delete m_cacheDecal;
+      }
+      if (m_cacheSprite != nullptr) {
+        delete m_cacheSprite;
+      }
+
+      m_cacheSprite = new olc::Sprite(std::max(m_size.x, 1), std::max(m_size.y, 1));
+      m_cacheDecal = new olc::Decal(m_cacheSprite);
+    }
+
+    olc::Sprite* target = pge->GetDrawTarget();
+    olc::Pixel::Mode mode = pge->GetPixelMode();
+
+    pge->SetDrawTarget(m_cacheSprite);
+    pge->Clear(olc::BLANK);
+    pge->SetPixelMode(over);
+
+    paint(pge, olc::vi2d(0, 0));
+
+    pge->SetPixelMode(mode);
+    pge->SetDrawTarget(target);
+
+    m_cacheDecal->Update();
+  }
+
+  void
+  Menu::paint(olc::PixelGameEngine* pge, const olc::vi2d& pos) const {
+    // Render the uniform background for this menu.
+    olc::Pixel c = (active() ? m_bg.hColor : m_bg.color);
+    pge->FillRect(pos, m_size, c);
+
+    // Render this menu.
+    renderSelf(pge, pos);
+
+    m_dirty = false;
+
+    // And then draw children in the order there were
+    // added: it means that the last added menu will
+    // be repainted on top of the others.
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      if (!m_children[id]->m_state.visible) {
+        continue;
+      }
+
+      olc::vi2d cp = pos;
+      cp += m_children[id]->m_pos;
+
+      m_children[id]->paint(pge, cp);
     }
   }
 
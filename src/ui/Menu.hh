@@ -123,6 +123,9 @@ namespace pge {
        *         a parent application. This is used to offload
        *         some of the rendering code from the main app
        *         and hide the internal complexity of the menu.
+       *         The menu and its children are painted into a
+       *         cached sprite which is only repainted when the
+       *         menu changes, and then drawn as a single decal.
        *         Note: we draw on the active layer so it has
        *         to be configured before calling this method.
        * @param pge - the rendering engine to display the menu.
@@ -185,7 +188,8 @@ namespace pge {
       /**
        * @brief - Replace the existing text with the new one. It
        *          will keep every other foreground properties in
-       *          a similar state.
+       *          a similar state. Nothing is repainted if the
+       *          text does not change.
        */
       void
       setText(const std::string& text);
@@ -213,13 +217,19 @@ namespace pge {
       /**
        * @brief - Interface method allowing inheriting classes
        *          to perform their own drawing routines on top
-       *          of the base representation of the menu.
-       *          This default implementation does nothing.
+       *          of the base representation of the menu. The
+       *          draw target is the cached sprite of the menu
+       *          being repainted so only sprite based drawing
+       *          routines should be used.
+       *          This default implementation draws the text
+       *          and the icon of the menu.
        * @param pge - the rendering engine to display the menu.
+       * @param pos - the position of the top left corner of the
+       *              menu in the draw target.
        */
       virtual
       void
-      renderSelf(olc::PixelGameEngine* pge) const;
+      renderSelf(olc::PixelGameEngine* pge, const olc::vi2d& pos) const;
 
       /**
        * @brief - Interface method allowing inheriting classes
@@ -302,6 +312,40 @@ namespace pge {
       void
       updateChildren();
 
+      /**
+       * @brief - Whether the menu is displayed with its highlight
+       *          colors.
+       * @return - `true` if the highlight colors are used.
+       */
+      bool
+      active() const noexcept;
+
+      /**
+       * @brief - Mark the cached sprite of this menu and of all
+       *          its parents as outdated, so that they are
+       *          repainted the next time they are rendered.
+       */
+      void
+      invalidate() noexcept;
+
+      /**
+       * @brief - Paint this menu and its children in the cached
+       *          sprite, creating it if needed.
+       * @param pge - the rendering engine to display the menu.
+       */
+      void
+      repaint(olc::PixelGameEngine* pge) const;
+
+      /**
+       * @brief - Paint this menu and its visible children in the
+       *          current draw target.
+       * @param pge - the rendering engine to display the menu.
+       * @param pos - the position of the top left corner of the
+       *              menu in the draw target.
+       */
+      void
+      paint(olc::PixelGameEngine* pge, const olc::vi2d& pos) const;
+
     private:
 
       /**
@@ -389,6 +433,23 @@ namespace pge {
        *          clicked upon.
        */
       menu::RegisterAction m_callback;
+
+      /**
+       * @brief - Whether the cached sprite of this menu needs to
+       *          be repainted.
+       */
+      mutable bool m_dirty;
+
+      /**
+       * @brief - The sprite in which the menu and its children
+       *          are painted, or `null` if it was never rendered.
+       */
+      mutable olc::Sprite* m_cacheSprite;
+
+      /**
+       * @brief - The decal used to draw the cached sprite.
+       */
+      mutable olc::Decal* m_cacheDecal;
   };
 
 }
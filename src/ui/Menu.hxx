@@ -14,19 +14,24 @@ namespace pge {
   inline
   void
   Menu::setVisible(bool visible) noexcept {
-    m_state.visible = visible;
+    if (m_state.visible != visible) {
+      m_state.visible = visible;
+      invalidate();
+    }
   }
 
   inline
   void
   Menu::setClickable(bool click) noexcept {
     m_state.clickable = click;
+    invalidate();
   }
 
   inline
   void
   Menu::setSelectable(bool select) noexcept {
     m_state.selectable = select;
+    invalidate();
   }
 
   inline
@@ -45,6 +50,7 @@ namespace pge {
   void
   Menu::setBackground(const menu::BackgroundDesc& bg) {
     m_bg = bg;
+    invalidate();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -58,6 +64,7 @@ namespace pge {
     clearContent();
     m_fg = mcd;
     loadFGTile();
+    invalidate();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -68,12 +75,14 @@ namespace pge {
   inline
   void
   Menu::setText(const std::string& text) {
-    m_fg.text = text;
-
-    // Update the parent's display if possible.
-    if (m_parent != nullptr) {
-      m_parent->updateChildren();
+    // The layout does not depend on the text so only the
+    // menu itself needs to be repainted.
+    if (m_fg.text == text) {
+      return;
     }
+
+    m_fg.text = text;
+    invalidate();
   }
 
   inline
@@ -117,9 +126,36 @@ namespace pge {
     return m_fg;
   }
 
+  inline
+  bool
+  Menu::active() const noexcept {
+    return (m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected);
+  }
+
   inline
   void
-  Menu::clear() {}
+  Menu::invalidate() noexcept {
+    Menu* m = this;
+
+    while (m != nullptr) {
+      m->m_dirty = true;
+      m = m->m_parent;
+    }
+  }
+
+  inline
+  void
+  Menu::clear() {
+    if (m_cacheDecal != nullptr) {
+      delete m_cacheDecal;
+    }
+    if (m_cacheSprite != nullptr) {
+      delete m_cacheSprite;
+    }
+
+    m_cacheDecal = nullptr;
+    m_cacheSprite = nullptr;
+  }
 
   inline
   void